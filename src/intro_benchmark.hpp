@@ -0,0 +1,758 @@
+#ifndef INTRO_BENCHMARK_HPP
+#define INTRO_BENCHMARK_HPP
+
+/// \file Developer micro-benchmarks, run instead of the intro with --benchmark.
+///
+/// Benchmarks run in a worker thread so they may wait on fences. Results are printed to standard output.
+
+#include "csg_arc.hpp"
+#include "csg_bridge.hpp"
+#include "csg_fence.hpp"
+#include "csg_john_kerava_center.hpp"
+#include "csg_kerava_state_building.hpp"
+#include "csg_kerava_station.hpp"
+#include "csg_keravanas_towers.hpp"
+#include "csg_pylon.hpp"
+#include "csg_pylon_base.hpp"
+#include "csg_ramp.hpp"
+#include "csg_sign0.hpp"
+#include "csg_sign1.hpp"
+#include "csg_sign2.hpp"
+#include "csg_sign3.hpp"
+#include "csg_sm5_chair.hpp"
+#include "csg_sm5_chair_l.hpp"
+#include "csg_sm5_chair_r.hpp"
+#include "csg_sm5_interior.hpp"
+#include "csg_station_building.hpp"
+#include "csg_tendon.hpp"
+#include "csg_train0.hpp"
+#include "csg_train1.hpp"
+
+/// Number of fence round-trips measured by each waiting task.
+constexpr unsigned BENCHMARK_FENCE_ROUND_TRIPS = 20000;
+
+/// Number of threads contending for the mutex.
+constexpr unsigned BENCHMARK_MUTEX_THREADS = 4;
+
+/// Number of lock/unlock pairs per contending thread.
+constexpr unsigned BENCHMARK_MUTEX_LOCKS = 500000;
+
+/// Counter protected by the benchmark mutex.
+static unsigned g_benchmark_mutex_counter = 0;
+
+/// Number of compilations of each mesh, best time is reported.
+constexpr unsigned BENCHMARK_MESH_REPEATS = 15;
+
+/// CSG command arrays of intro meshes.
+static const int16_t* const g_benchmark_csg_data[] =
+{
+    g_csg_arc_hpp,
+    g_csg_bridge_hpp,
+    g_csg_fence_hpp,
+    g_csg_john_kerava_center_hpp,
+    g_csg_kerava_state_building_hpp,
+    g_csg_kerava_station_hpp,
+    g_csg_keravanas_towers_hpp,
+    g_csg_pylon_hpp,
+    g_csg_pylon_base_hpp,
+    g_csg_ramp_hpp,
+    g_csg_sign0_hpp,
+    g_csg_sign1_hpp,
+    g_csg_sign2_hpp,
+    g_csg_sign3_hpp,
+    g_csg_sm5_chair_hpp,
+    g_csg_sm5_chair_l_hpp,
+    g_csg_sm5_chair_r_hpp,
+    g_csg_sm5_interior_hpp,
+    g_csg_station_building_hpp,
+    g_csg_tendon_hpp,
+    g_csg_train0_hpp,
+    g_csg_train1_hpp,
+};
+
+/// Sizes of CSG command arrays of intro meshes.
+static const unsigned g_benchmark_csg_sizes[] =
+{
+    g_csg_arc_hpp_size,
+    g_csg_bridge_hpp_size,
+    g_csg_fence_hpp_size,
+    g_csg_john_kerava_center_hpp_size,
+    g_csg_kerava_state_building_hpp_size,
+    g_csg_kerava_station_hpp_size,
+    g_csg_keravanas_towers_hpp_size,
+    g_csg_pylon_hpp_size,
+    g_csg_pylon_base_hpp_size,
+    g_csg_ramp_hpp_size,
+    g_csg_sign0_hpp_size,
+    g_csg_sign1_hpp_size,
+    g_csg_sign2_hpp_size,
+    g_csg_sign3_hpp_size,
+    g_csg_sm5_chair_hpp_size,
+    g_csg_sm5_chair_l_hpp_size,
+    g_csg_sm5_chair_r_hpp_size,
+    g_csg_sm5_interior_hpp_size,
+    g_csg_station_building_hpp_size,
+    g_csg_tendon_hpp_size,
+    g_csg_train0_hpp_size,
+    g_csg_train1_hpp_size,
+};
+
+/// Number of meshes pushed per frame in the render queue payload benchmark.
+constexpr unsigned BENCHMARK_PACKED_DATA_MESHES = 500;
+
+/// Number of frames in the render queue payload benchmark.
+constexpr unsigned BENCHMARK_PACKED_DATA_FRAMES = 2000;
+
+/// Number of frames in the render selection benchmark.
+constexpr unsigned BENCHMARK_SELECTION_FRAMES = 400;
+
+/// Length of the street along negative Z in the render selection benchmark.
+constexpr float BENCHMARK_SELECTION_LENGTH = 4000.0f;
+
+/// View distance in the render selection benchmark.
+constexpr float BENCHMARK_SELECTION_VIEW = 256.0f;
+
+/// Search tolerance of the z-scan in the render selection benchmark.
+constexpr float BENCHMARK_SELECTION_TOLERANCE = 48.0f;
+
+/// Number of candidate buildings tried in order in the placement benchmark.
+constexpr unsigned BENCHMARK_PLACEMENT_CANDIDATES = 4000;
+
+/// Return value of the fence round-trip leaf task.
+///
+/// \param op Value to return.
+/// \return Given value.
+static void* benchmark_fence_leaf(void* op)
+{
+    return op;
+}
+
+/// Wait on leaf tasks one after another.
+///
+/// \param op Number of round-trips as pointer.
+/// \return Sum of leaf return values as pointer.
+static void* benchmark_fence_waiter(void* op)
+{
+    uintptr_t count = reinterpret_cast<uintptr_t>(op);
+    uintptr_t ret = 0;
+    for(uintptr_t ii = 0; (ii < count); ++ii)
+    {
+        vgl::Fence fence = vgl::TaskDispatcher::wait(benchmark_fence_leaf, reinterpret_cast<void*>(ii));
+        ret += reinterpret_cast<uintptr_t>(fence.getReturnValue());
+    }
+    return reinterpret_cast<void*>(ret);
+}
+
+/// Benchmark fence round-trips.
+///
+/// Two tasks wait on leaf tasks concurrently, so fences are acquired and released from multiple threads.
+static void benchmark_fences()
+{
+    void* count = reinterpret_cast<void*>(static_cast<uintptr_t>(BENCHMARK_FENCE_ROUND_TRIPS));
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    {
+        vgl::Fence fence1 = vgl::TaskDispatcher::wait(benchmark_fence_waiter, count);
+        vgl::Fence fence2 = vgl::TaskDispatcher::wait(benchmark_fence_waiter, count);
+        uintptr_t sum = reinterpret_cast<uintptr_t>(fence1.getReturnValue()) +
+            reinterpret_cast<uintptr_t>(fence2.getReturnValue());
+        uintptr_t expected = static_cast<uintptr_t>(BENCHMARK_FENCE_ROUND_TRIPS) * (BENCHMARK_FENCE_ROUND_TRIPS - 1);
+        if(sum != expected)
+        {
+            VGL_THROW_RUNTIME_ERROR("fence round-trip returned " + vgl::to_string(static_cast<unsigned>(sum)));
+        }
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Benchmark: fence round-trip: " << (elapsed.count() / (BENCHMARK_FENCE_ROUND_TRIPS * 2.0)) <<
+        " us" << std::endl;
+}
+
+/// SDL mutex with the interface of a futex mutex.
+///
+/// Benchmarks the SDL backend regardless of which backend vgl::Mutex uses.
+class BenchmarkSdlMutex
+{
+private:
+    /// SDL mutex.
+    SDL_mutex* m_mutex;
+
+public:
+    /// Constructor.
+    explicit BenchmarkSdlMutex() :
+        m_mutex(dnload_SDL_CreateMutex())
+    {
+        if(!m_mutex)
+        {
+            VGL_THROW_RUNTIME_ERROR(vgl::string("SDL_CreateMutex(): ") + SDL_GetError());
+        }
+    }
+
+    /// Destructor.
+    ~BenchmarkSdlMutex()
+    {
+        dnload_SDL_DestroyMutex(m_mutex);
+    }
+
+    /// Deleted copy constructor.
+    BenchmarkSdlMutex(const BenchmarkSdlMutex&) = delete;
+    /// Deleted assignment.
+    BenchmarkSdlMutex& operator=(const BenchmarkSdlMutex&) = delete;
+
+public:
+    /// Lock the mutex.
+    void acquire()
+    {
+        dnload_SDL_LockMutex(m_mutex);
+    }
+
+    /// Unlock the mutex.
+    void release()
+    {
+        dnload_SDL_UnlockMutex(m_mutex);
+    }
+};
+
+/// Lock the benchmark mutex repeatedly and increment the counter.
+///
+/// \param op Mutex to contend for.
+/// \return Thread return value.
+template<typename T> static vgl::Thread::return_type benchmark_mutex_thread(void* op)
+{
+    T* mutex = static_cast<T*>(op);
+    for(unsigned ii = 0; (ii < BENCHMARK_MUTEX_LOCKS); ++ii)
+    {
+        mutex->acquire();
+        ++g_benchmark_mutex_counter;
+        mutex->release();
+    }
+    return 0;
+}
+
+/// Run contended mutex lock/unlock pairs on one mutex type.
+///
+/// Uses raw threads instead of tasks so the task dispatcher does not take part in the contention.
+///
+/// \return Nanoseconds per lock.
+template<typename T> static double benchmark_mutex_run()
+{
+    T mutex;
+    g_benchmark_mutex_counter = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    {
+        vgl::vector<vgl::Thread*> threads;
+        for(unsigned ii = 0; (ii < BENCHMARK_MUTEX_THREADS); ++ii)
+        {
+            threads.push_back(new vgl::Thread(benchmark_mutex_thread<T>, &mutex));
+        }
+        for(vgl::Thread* vv : threads)
+        {
+            delete vv;
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    if(g_benchmark_mutex_counter != BENCHMARK_MUTEX_THREADS * BENCHMARK_MUTEX_LOCKS)
+    {
+        VGL_THROW_RUNTIME_ERROR("mutex counter " + vgl::to_string(g_benchmark_mutex_counter));
+    }
+    return elapsed.count() / (BENCHMARK_MUTEX_THREADS * BENCHMARK_MUTEX_LOCKS);
+}
+
+/// Benchmark contended mutex lock/unlock pairs on the SDL and futex backends.
+static void benchmark_mutex()
+{
+    std::cout << "Benchmark: contended mutex: SDL " << benchmark_mutex_run<BenchmarkSdlMutex>() << " ns/lock";
+#if defined(VGL_HAS_FUTEX)
+    std::cout << ", futex " << benchmark_mutex_run<vgl::detail::FutexMutex>() << " ns/lock";
+#endif
+    std::cout << std::endl;
+}
+
+/// Create a heightfield block of unshared quads with one unreferenced vertex per quad.
+///
+/// \param size Block width and depth in quads.
+/// \return Logical mesh.
+static vgl::LogicalMesh benchmark_create_orphan_terrain(unsigned size)
+{
+    const float QUAD_SIZE = 0.1f;
+    auto height = [](unsigned px, unsigned pz)
+    {
+        return static_cast<float>(((px * 7) + (pz * 13)) % 5) * 0.3f;
+    };
+
+    vgl::LogicalMesh ret;
+    for(unsigned ii = 0; (ii < size); ++ii)
+    {
+        for(unsigned jj = 0; (jj < size); ++jj)
+        {
+            float fx = static_cast<float>(jj) * QUAD_SIZE;
+            float fz = static_cast<float>(ii) * QUAD_SIZE;
+            unsigned c1 = ret.addVertex(fx, height(jj, ii), fz);
+            unsigned c2 = ret.addVertex(fx + QUAD_SIZE, height(jj + 1, ii), fz);
+            unsigned c3 = ret.addVertex(fx + QUAD_SIZE, height(jj + 1, ii + 1), fz + QUAD_SIZE);
+            unsigned c4 = ret.addVertex(fx, height(jj, ii + 1), fz + QUAD_SIZE);
+            ret.addFace(c1, c4, c3, c2);
+            ret.addVertex(fx + (QUAD_SIZE * 0.5f), height(jj, ii) + 1.0f, fz + (QUAD_SIZE * 0.5f));
+        }
+    }
+    return ret;
+}
+
+/// Compare vertex data of two vertices.
+///
+/// \param lhs Left-hand-side vertex data.
+/// \param rhs Right-hand-side vertex data.
+/// \param stride Vertex size in bytes.
+/// \return True if left-hand-side operand is lexicographically smaller.
+static bool benchmark_vertex_less(const uint8_t* lhs, const uint8_t* rhs, unsigned stride)
+{
+    for(unsigned ii = 0; (ii < stride); ++ii)
+    {
+        if(lhs[ii] != rhs[ii])
+        {
+            return lhs[ii] < rhs[ii];
+        }
+    }
+    return false;
+}
+
+/// Calculate a hash of the triangles of a mesh.
+///
+/// The hash does not depend on the order of vertices or triangles, or on which corner a triangle starts from.
+///
+/// \param op Mesh.
+/// \return Hash value.
+static uint64_t benchmark_hash_triangles(const vgl::Mesh& op)
+{
+    const vgl::MeshData& data = op.getData();
+    if(!data.getVertexCount())
+    {
+        return 0;
+    }
+    const uint8_t* vertices = static_cast<const uint8_t*>(data.getData());
+    unsigned stride = data.getDataSize() / data.getVertexCount();
+    const auto& indices = data.getIndexData();
+    uint64_t ret = 0;
+    for(unsigned ii = 0; ((ii + 2) < indices.size()); ii += 3)
+    {
+        unsigned first = 0;
+        for(unsigned jj = 1; (jj < 3); ++jj)
+        {
+            if(benchmark_vertex_less(vertices + (indices[ii + jj] * stride), vertices + (indices[ii + first] * stride),
+                        stride))
+            {
+                first = jj;
+            }
+        }
+
+        // FNV-1a over the corners, summed so triangle order does not matter.
+        uint64_t hash = 14695981039346656037ull;
+        for(unsigned jj = 0; (jj < 3); ++jj)
+        {
+            const uint8_t* vertex = vertices + (indices[ii + ((first + jj) % 3)] * stride);
+            for(unsigned kk = 0; (kk < stride); ++kk)
+            {
+                hash = (hash ^ vertex[kk]) * 1099511628211ull;
+            }
+        }
+        ret += hash;
+    }
+    return ret;
+}
+
+/// Compile a mesh with both orphaned vertex removal implementations.
+///
+/// Both must produce the same triangles.
+///
+/// \param create Function creating the logical mesh.
+/// \param best_reference Output best compile time erasing orphans one at a time in milliseconds.
+/// \param best_compaction Output best compile time erasing orphans in one compaction pass in milliseconds.
+template<typename F> static void benchmark_compile_orphans(F create, double& best_reference, double& best_compaction)
+{
+    best_reference = std::numeric_limits<double>::max();
+    best_compaction = std::numeric_limits<double>::max();
+    uint64_t hash_reference = 0;
+    uint64_t hash_compaction = 0;
+    for(unsigned ii = 0; (ii < BENCHMARK_MESH_REPEATS); ++ii)
+    {
+        for(unsigned jj = 0; (jj < 2); ++jj)
+        {
+            bool reference = (jj == 0);
+            vgl::LogicalMesh::set_orphan_removal_reference(reference);
+            vgl::LogicalMesh lmesh = create();
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            vgl::MeshUptr mesh(lmesh.compileMesh());
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            double& best = reference ? best_reference : best_compaction;
+            best = vgl::min(best, elapsed.count());
+            (reference ? hash_reference : hash_compaction) = benchmark_hash_triangles(*mesh);
+        }
+    }
+    vgl::LogicalMesh::set_orphan_removal_reference(false);
+    if(hash_reference != hash_compaction)
+    {
+        VGL_THROW_RUNTIME_ERROR("orphaned vertex removal implementations produced different triangles");
+    }
+}
+
+/// Benchmark orphaned vertex removal when compiling meshes.
+///
+/// Compares erasing orphans one at a time against the compaction pass, over the CSG meshes of the intro and over
+/// synthetic meshes that need both vertex welding and orphan removal.
+static void benchmark_orphan_removal()
+{
+    double total_reference = 0.0;
+    double total_compaction = 0.0;
+    for(unsigned ii = 0; (ii < (sizeof(g_benchmark_csg_sizes) / sizeof(g_benchmark_csg_sizes[0]))); ++ii)
+    {
+        vgl::vector<int16_t> data;
+        for(unsigned jj = 0; (jj < g_benchmark_csg_sizes[ii]); ++jj)
+        {
+            data.push_back(g_benchmark_csg_data[ii][jj]);
+        }
+        data.push_back(to_int16(vgl::CsgCommand::NONE));
+
+        double best_reference;
+        double best_compaction;
+        benchmark_compile_orphans([&data]()
+                {
+                    return vgl::LogicalMesh(data.data());
+                }, best_reference, best_compaction);
+        total_reference += best_reference;
+        total_compaction += best_compaction;
+    }
+    std::cout << "Benchmark: intro CSG meshes compile: reference " << total_reference << " ms, compaction " <<
+        total_compaction << " ms" << std::endl;
+
+    for(unsigned size = 32; (size <= 96); size += 32)
+    {
+        double best_reference;
+        double best_compaction;
+        benchmark_compile_orphans([size]()
+                {
+                    return benchmark_create_orphan_terrain(size);
+                }, best_reference, best_compaction);
+        std::cout << "Benchmark: orphan terrain " << size << "x" << size << " compile: reference " << best_reference <<
+            " ms, compaction " << best_compaction << " ms" << std::endl;
+    }
+}
+
+/// Benchmark building render queue payloads.
+///
+/// Pushes the same data per mesh as RenderQueue::push() into a packed data buffer that is reused across frames.
+static void benchmark_packed_data()
+{
+    vgl::PackedData data;
+    vgl::mat4 transform = vgl::mat4::identity();
+    vgl::mat3 normal_transform = vgl::mat3::identity();
+    unsigned check = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(unsigned ii = 0; (ii < BENCHMARK_PACKED_DATA_FRAMES); ++ii)
+    {
+        data.clear();
+        for(unsigned jj = 0; (jj < BENCHMARK_PACKED_DATA_MESHES); ++jj)
+        {
+            data.push(static_cast<const void*>(&data));
+            data.push(static_cast<const void*>(&transform));
+            data.push(transform);
+            data.push(normal_transform);
+            data.push(transform);
+            data.push(transform);
+        }
+        check += data.size();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    if(!check)
+    {
+        VGL_THROW_RUNTIME_ERROR("no render queue payload was written");
+    }
+    std::cout << "Benchmark: render queue payload: " <<
+        (elapsed.count() / (BENCHMARK_PACKED_DATA_FRAMES * BENCHMARK_PACKED_DATA_MESHES)) << " ns/mesh" << std::endl;
+}
+
+/// Compare bounding boxes by center Z coordinate.
+///
+/// \param lhs Left-hand-side operand.
+/// \param rhs Right-hand-side operand.
+/// \return Negative, zero or positive like qsort() expects.
+static int benchmark_compare_box_z(const void* lhs, const void* rhs)
+{
+    float za = static_cast<const vgl::BoundingBox*>(lhs)->getCenter().z();
+    float zb = static_cast<const vgl::BoundingBox*>(rhs)->getCenter().z();
+    return (za < zb) ? -1 : ((za > zb) ? 1 : 0);
+}
+
+/// Select visible boxes with the z-sorted scan IntroWorld uses for rendering.
+///
+/// \param boxes Bounding boxes sorted by center Z coordinate.
+/// \param frustum View frustum.
+/// \param zmax Maximum Z coordinate.
+/// \param zmin Minimum Z coordinate.
+/// \param ret Output indices of visible boxes.
+static void benchmark_selection_scan(const vgl::vector<vgl::BoundingBox>& boxes, const vgl::Frustum& frustum,
+        float zmax, float zmin, vgl::vector<unsigned>& ret)
+{
+    unsigned lo = 0;
+    unsigned hi = boxes.size() - 1;
+    while((hi - lo) > 1)
+    {
+        unsigned mid = (lo + hi) / 2;
+        if(boxes[mid].getCenter().z() > zmax)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid;
+        }
+    }
+
+    for(int ii = static_cast<int>(lo); (ii >= 0); --ii)
+    {
+        const vgl::BoundingBox& box = boxes[ii];
+        if(box.collidesZ(zmin, zmax))
+        {
+            if(frustum.isVisible(box))
+            {
+                ret.push_back(static_cast<unsigned>(ii));
+            }
+            continue;
+        }
+        if(box.getCenter().z() < (zmin - BENCHMARK_SELECTION_TOLERANCE))
+        {
+            break;
+        }
+    }
+    for(unsigned ii = lo + 1; (ii < boxes.size()); ++ii)
+    {
+        const vgl::BoundingBox& box = boxes[ii];
+        if(box.collidesZ(zmin, zmax))
+        {
+            if(frustum.isVisible(box))
+            {
+                ret.push_back(ii);
+            }
+            continue;
+        }
+        if(box.getCenter().z() > (zmax + BENCHMARK_SELECTION_TOLERANCE))
+        {
+            break;
+        }
+    }
+}
+
+/// Benchmark selecting entities to render along a street with the z-sorted scan and by testing every box.
+///
+/// Both must select the same boxes every frame.
+///
+/// \param count Number of boxes.
+static void benchmark_selection(unsigned count)
+{
+    vgl::vector<vgl::BoundingBox> boxes;
+    for(unsigned ii = 0; (ii < count); ++ii)
+    {
+        vgl::vec3 center(vgl::frand(-150.0f, 150.0f), vgl::frand(0.0f, 20.0f),
+                vgl::frand(-BENCHMARK_SELECTION_LENGTH, 0.0f));
+        vgl::vec3 extent(vgl::frand(0.5f, 10.0f), vgl::frand(0.5f, 10.0f), vgl::frand(0.5f, 10.0f));
+        boxes.emplace_back(center - extent, center + extent);
+    }
+    dnload_qsort(boxes.data(), boxes.size(), sizeof(vgl::BoundingBox), benchmark_compare_box_z);
+
+    vgl::mat4 projection = vgl::mat4::projection(1.2f, 1280, 720, 0.2f, BENCHMARK_SELECTION_VIEW);
+    vgl::vector<unsigned> selected_scan;
+    vgl::vector<unsigned> selected_linear;
+    vgl::vector<unsigned> marks(count);
+    for(auto& vv : marks)
+    {
+        vv = 0;
+    }
+    std::chrono::duration<double, std::micro> elapsed_scan(0.0);
+    std::chrono::duration<double, std::micro> elapsed_linear(0.0);
+    for(unsigned ii = 0; (ii < BENCHMARK_SELECTION_FRAMES); ++ii)
+    {
+        float fi = static_cast<float>(ii);
+        float yaw = vgl::sin(fi * 0.05f) * 0.7f;
+        vgl::vec3 pos(0.0f, 2.0f, fi * -9.0f);
+        vgl::mat4 camera = vgl::mat4::lookat(pos, pos + vgl::vec3(vgl::sin(yaw), 0.0f, -vgl::cos(yaw)));
+        vgl::Frustum frustum(projection * viewify(camera));
+        float zmax = pos.z() + 1.0f;
+        float zmin = pos.z() - BENCHMARK_SELECTION_VIEW;
+
+        selected_scan.clear();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        benchmark_selection_scan(boxes, frustum, zmax, zmin, selected_scan);
+        std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+        selected_linear.clear();
+        for(unsigned jj = 0; (jj < count); ++jj)
+        {
+            if(boxes[jj].collidesZ(zmin, zmax) && frustum.isVisible(boxes[jj]))
+            {
+                selected_linear.push_back(jj);
+            }
+        }
+        elapsed_linear += std::chrono::steady_clock::now() - middle;
+        elapsed_scan += middle - start;
+
+        for(const auto& vv : selected_scan)
+        {
+            marks[vv] = ii + 1;
+        }
+        bool same = (selected_scan.size() == selected_linear.size());
+        for(const auto& vv : selected_linear)
+        {
+            same = same && (marks[vv] == ii + 1);
+        }
+        if(!same)
+        {
+            VGL_THROW_RUNTIME_ERROR("z-scan and linear search selected different entities on frame " +
+                    vgl::to_string(ii));
+        }
+    }
+    std::cout << "Benchmark: render selection " << count << " entities: z-scan " <<
+        (elapsed_scan.count() / BENCHMARK_SELECTION_FRAMES) << " us, linear " <<
+        (elapsed_linear.count() / BENCHMARK_SELECTION_FRAMES) << " us" << std::endl;
+}
+
+/// Place buildings next to track furniture like the city placement retry loop.
+///
+/// \param candidates Candidate building bounding boxes, tried in order.
+/// \param buildings Number of buildings to place.
+/// \param use_grid True to check collisions with vgl::UniformGrid, false to test every placed box.
+/// \param attempts Output number of candidates tried.
+/// \return Time spent placing buildings in microseconds.
+static double benchmark_placement_run(const vgl::vector<vgl::BoundingBox>& candidates, unsigned buildings,
+        bool use_grid, unsigned& attempts)
+{
+    vgl::vector<vgl::BoundingBox> boxes;
+    vgl::UniformGrid grid(WORLD_PLACEMENT_CELL_SIZE);
+    auto insert = [&boxes, &grid, use_grid](const vgl::BoundingBox& op)
+    {
+        if(use_grid)
+        {
+            grid.insert(op);
+        }
+        else
+        {
+            boxes.push_back(op);
+        }
+    };
+
+    // Fences and rails along the track.
+    for(unsigned ii = 0; (ii < 300); ++ii)
+    {
+        float fz = static_cast<float>(ii) * -5.0f;
+        insert(vgl::BoundingBox(vgl::vec3(20.0f, 0.0f, fz - 2.5f), vgl::vec3(21.0f, 2.0f, fz + 2.5f)));
+        insert(vgl::BoundingBox(vgl::vec3(-21.0f, 0.0f, fz - 2.5f), vgl::vec3(-20.0f, 2.0f, fz + 2.5f)));
+    }
+    for(unsigned ii = 0; (ii < 150); ++ii)
+    {
+        float fz = static_cast<float>(ii) * -10.0f;
+        insert(vgl::BoundingBox(vgl::vec3(2.0f, 0.0f, fz - 5.0f), vgl::vec3(4.0f, 1.0f, fz + 5.0f)));
+        insert(vgl::BoundingBox(vgl::vec3(-4.0f, 0.0f, fz - 5.0f), vgl::vec3(-2.0f, 1.0f, fz + 5.0f)));
+    }
+
+    unsigned placed = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(attempts = 0; (placed < buildings) && (attempts < candidates.size()); ++attempts)
+    {
+        const vgl::BoundingBox& box = candidates[attempts];
+        bool collides = false;
+        if(use_grid)
+        {
+            collides = grid.collides(box);
+        }
+        else
+        {
+            for(const auto& vv : boxes)
+            {
+                if(vv.collides(box))
+                {
+                    collides = true;
+                    break;
+                }
+            }
+        }
+        if(!collides)
+        {
+            insert(box);
+            ++placed;
+        }
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    if(placed < buildings)
+    {
+        VGL_THROW_RUNTIME_ERROR("only " + vgl::to_string(placed) + " buildings could be placed");
+    }
+    return elapsed.count();
+}
+
+/// Benchmark entity placement checks with a linear search and with vgl::UniformGrid.
+///
+/// \param buildings Number of buildings to place.
+static void benchmark_placement(unsigned buildings)
+{
+    vgl::vector<vgl::BoundingBox> candidates;
+    for(unsigned ii = 0; (ii < BENCHMARK_PLACEMENT_CANDIDATES); ++ii)
+    {
+        float px = vgl::frand(-94.0f, 94.0f);
+        float pz = vgl::frand(-1140.0f, -780.0f);
+        float width = vgl::frand(4.0f, 12.0f);
+        float depth = vgl::frand(4.0f, 12.0f);
+        candidates.emplace_back(vgl::vec3(px - width, -2.0f, pz - depth), vgl::vec3(px + width, 40.0f, pz + depth));
+    }
+
+    unsigned attempts_linear;
+    unsigned attempts_grid;
+    double elapsed_linear = benchmark_placement_run(candidates, buildings, false, attempts_linear);
+    double elapsed_grid = benchmark_placement_run(candidates, buildings, true, attempts_grid);
+    if(attempts_linear != attempts_grid)
+    {
+        VGL_THROW_RUNTIME_ERROR("linear search and grid placed different buildings");
+    }
+    std::cout << "Benchmark: placement " << buildings << " buildings, " << attempts_grid << " attempts: linear " <<
+        elapsed_linear << " us, grid " << elapsed_grid << " us" << std::endl;
+}
+
+/// Marks the end of benchmarks in the main thread.
+///
+/// \return nullptr
+static void* benchmark_done(void*)
+{
+    return nullptr;
+}
+
+/// Run all benchmarks.
+///
+/// \return nullptr
+static void* benchmark_run(void*)
+{
+    benchmark_fences();
+    benchmark_mutex();
+    benchmark_orphan_removal();
+    benchmark_packed_data();
+    benchmark_selection(500);
+    benchmark_selection(10000);
+    benchmark_placement(78);
+    benchmark_placement(120);
+    vgl::TaskDispatcher::dispatch_main(benchmark_done, nullptr);
+    return nullptr;
+}
+
+/// Run benchmarks instead of the intro.
+///
+/// Only initializes the task dispatcher, no window or GL context is created.
+///
+/// \param threads Worker thread count.
+static void intro_benchmark(unsigned threads)
+{
+    vgl::TaskDispatcher::initialize(threads);
+    vgl::TaskDispatcher::dispatch(benchmark_run, nullptr);
+    for(;;)
+    {
+        vgl::Task task = vgl::TaskDispatcher::acquire_main();
+        if(task() == benchmark_done)
+        {
+            break;
+        }
+    }
+}
+
+#endif
@@ -254,6 +254,10 @@ private:
     vgl::GlslProgram m_program_font_overlay;
     /// Program.
     vgl::GlslProgram m_program_offscreen;
+#if defined(VGL_ENABLE_INSTANCING)
+    /// Program.
+    vgl::GlslProgram m_program_offscreen_instanced;
+#endif
     /// Program.
     vgl::GlslProgram m_program_skeleton;
     /// Program.
@@ -372,8 +376,10 @@ private:
     vgl::array<IntroWorld, 5> m_world;
 
 #if defined(DNLOAD_USE_LD)
-    /// Meshes for preview.
-    vgl::vector<vgl::Mesh*> m_preview_meshes;
+    /// Meshes for preview, with names.
+    ///
+    /// Meshes are compiled asynchronously, so names are applied after all meshes are finished.
+    vgl::vector<std::pair<vgl::string, vgl::MeshUptr*>> m_preview_meshes;
 #endif
 
 public:
@@ -638,6 +644,28 @@ private:
             m_program_offscreen.addUniform("debug_mode");
 #endif
 
+#if defined(VGL_ENABLE_INSTANCING)
+            m_program_offscreen_instanced = vgl::GlslProgram(
+                    vgl::GlslShader(GL_VERTEX_SHADER, g_shader_header, g_shader_vertex_offscreen_instanced),
+                    vgl::GlslShader(GL_FRAGMENT_SHADER, g_shader_header, g_shader_fragment_offscreen));
+            m_program_offscreen_instanced.addAttribute(vgl::GeometryChannel::POSITION,
+                    g_shader_vertex_offscreen_instanced_attribute_position);
+            m_program_offscreen_instanced.addAttribute(vgl::GeometryChannel::NORMAL,
+                    g_shader_vertex_offscreen_instanced_attribute_normal);
+            m_program_offscreen_instanced.setInstanceTransform(
+                    g_shader_vertex_offscreen_instanced_attribute_instance_transform);
+            m_program_offscreen_instanced.addUniform(vgl::UniformSemantic::CAMERA_POSITION,
+                    g_shader_vertex_offscreen_instanced_uniform_camera_position);
+            m_program_offscreen_instanced.addUniform(vgl::UniformSemantic::PROJECTION_CAMERA_MATRIX,
+                    g_shader_vertex_offscreen_instanced_uniform_projection_camera_transform);
+            m_program_offscreen_instanced.addUniform(vgl::UniformSemantic::PROJECTION_RANGE,
+                    g_shader_fragment_offscreen_uniform_projection_range);
+#if defined(DNLOAD_USE_LD)
+            m_program_offscreen_instanced.addUniform("debug_mode");
+#endif
+            m_program_offscreen.setInstanced(m_program_offscreen_instanced);
+#endif
+
             m_program_skeleton = vgl::GlslProgram(
                     vgl::GlslShader(GL_VERTEX_SHADER, g_shader_header, g_shader_vertex_skeleton),
                     vgl::GlslShader(GL_FRAGMENT_SHADER, g_shader_header, g_shader_fragment_skeleton));
@@ -692,6 +720,9 @@ private:
     /// Initialize the GPU-related data.
     void initializeGraphics()
     {
+        // Meshes are compiled in parallel and must be finished before use.
+        vgl::MeshCompiler mesh_compiler;
+
         // Create the stipple texture.
         {
             vgl::Image2DGray stipple(STIPPLE_SIZE, STIPPLE_SIZE);
@@ -762,16 +793,15 @@ private:
                 3, 0, 100,
                 to_int16(vgl::CsgCommand::NONE), 0
             };
-            vgl::LogicalMesh lmesh(data);
-            m_mesh_quad = lmesh.compile();
+            mesh_compiler.add(m_mesh_quad, vgl::LogicalMesh(data));
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("quad", *m_mesh_quad);
+            addPreviewMesh("quad", m_mesh_quad);
 #endif
         }
 
         // Font quad.
         {
-            auto generate_glyph_mesh = [](int16_t y1, int16_t y2, int16_t s1, int16_t s2)
+            auto generate_glyph_data = [](int16_t y1, int16_t y2, int16_t s1, int16_t s2)
             {
                 vgl::vector<int16_t> data;
 
@@ -805,33 +835,26 @@ private:
                 data.push_back(0);
                 data.push_back(s2);
                 data.push_back(to_int16(vgl::CsgCommand::NONE));
-
-                vgl::LogicalMesh lmesh(data.data());
-                return lmesh.compile();
+                return data;
             };
-            m_mesh_glyph[0] = generate_glyph_mesh(0, 10, 0, 10);
-            m_mesh_glyph[1] = generate_glyph_mesh(10, 20, 10, 20);
-            m_mesh_glyph[2] = generate_glyph_mesh(20, 30, 20, 30);
-            m_mesh_glyph[3] = generate_glyph_mesh(30, 50, 30, 50);
-            m_mesh_glyph[4] = generate_glyph_mesh(50, 70, 50, 70);
-            m_mesh_glyph[5] = generate_glyph_mesh(70, 80, 70, 80);
-            m_mesh_glyph[6] = generate_glyph_mesh(80, 90, 80, 90);
-            m_mesh_glyph[7] = generate_glyph_mesh(90, 100, 90, 100);
+            mesh_compiler.add(m_mesh_glyph[0], generate_glyph_data(0, 10, 0, 10));
+            mesh_compiler.add(m_mesh_glyph[1], generate_glyph_data(10, 20, 10, 20));
+            mesh_compiler.add(m_mesh_glyph[2], generate_glyph_data(20, 30, 20, 30));
+            mesh_compiler.add(m_mesh_glyph[3], generate_glyph_data(30, 50, 30, 50));
+            mesh_compiler.add(m_mesh_glyph[4], generate_glyph_data(50, 70, 50, 70));
+            mesh_compiler.add(m_mesh_glyph[5], generate_glyph_data(70, 80, 70, 80));
+            mesh_compiler.add(m_mesh_glyph[6], generate_glyph_data(80, 90, 80, 90));
+            mesh_compiler.add(m_mesh_glyph[7], generate_glyph_data(90, 100, 90, 100));
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("glyph0", *m_mesh_glyph[0]);
-            addPreviewMesh("glyph1", *m_mesh_glyph[1]);
-            addPreviewMesh("glyph2", *m_mesh_glyph[2]);
-            addPreviewMesh("glyph3", *m_mesh_glyph[3]);
-            addPreviewMesh("glyph4", *m_mesh_glyph[4]);
-            addPreviewMesh("glyph5", *m_mesh_glyph[5]);
-            addPreviewMesh("glyph6", *m_mesh_glyph[6]);
-            addPreviewMesh("glyph7", *m_mesh_glyph[7]);
+            addPreviewMesh("glyph0", m_mesh_glyph[0]);
+            addPreviewMesh("glyph1", m_mesh_glyph[1]);
+            addPreviewMesh("glyph2", m_mesh_glyph[2]);
+            addPreviewMesh("glyph3", m_mesh_glyph[3]);
+            addPreviewMesh("glyph4", m_mesh_glyph[4]);
+            addPreviewMesh("glyph5", m_mesh_glyph[5]);
+            addPreviewMesh("glyph6", m_mesh_glyph[6]);
+            addPreviewMesh("glyph7", m_mesh_glyph[7]);
 #endif
-            // Copy mesh pointers for easy access.
-            for(unsigned ii = 0; (ii < WORLD_GLYPH_SLICE_COUNT); ++ii)
-            {
-                m_glyph[ii] = m_mesh_glyph[ii].get();
-            }
         }
 
         // Audio visualization stripe.
@@ -877,12 +900,11 @@ private:
             }
 
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            vgl::LogicalMesh lmesh(data.data());
-            m_mesh_visualization[0] = lmesh.compile(false);
-            m_mesh_visualization[1] = lmesh.compile(false);
+            mesh_compiler.add(m_mesh_visualization[0], vgl::LogicalMesh(data.data()), false);
+            mesh_compiler.add(m_mesh_visualization[1], vgl::move(data), false);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("visualization0", *m_mesh_visualization[0]);
-            addPreviewMesh("visualization1", *m_mesh_visualization[1]);
+            addPreviewMesh("visualization0", m_mesh_visualization[0]);
+            addPreviewMesh("visualization1", m_mesh_visualization[1]);
 #endif
         }
 
@@ -899,7 +921,7 @@ private:
             const int CHART_STATION_INCREMENT = 1;
 
             // Generator function for the 2D rail chart with station sphere.
-            auto generate_chart = [](const int16_t* input_data, unsigned input_count) -> vgl::MeshUptr
+            auto generate_chart_data = [](const int16_t* input_data, unsigned input_count) -> vgl::vector<int16_t>
             {
                 // Generate spline first.
                 // Spline points are in XY plane only.
@@ -975,8 +997,7 @@ private:
                 }
 
                 data.push_back(to_int16(vgl::CsgCommand::NONE));
-                vgl::LogicalMesh lmesh(data.data());
-                return lmesh.compile(false);
+                return data;
             };
 
             // Malmi.
@@ -988,9 +1009,10 @@ private:
                     630, 550,
                     970, 1000,
                 };
-                m_mesh_chart[0] = generate_chart(CHART_DATA, static_cast<unsigned>(sizeof(CHART_DATA) / sizeof(int16_t)));
+                mesh_compiler.add(m_mesh_chart[0], generate_chart_data(CHART_DATA,
+                            static_cast<unsigned>(sizeof(CHART_DATA) / sizeof(int16_t))), false);
 #if defined(DNLOAD_USE_LD)
-                addPreviewMesh("chart0", *m_mesh_chart[0]);
+                addPreviewMesh("chart0", m_mesh_chart[0]);
 #endif
             }
 
@@ -1006,9 +1028,10 @@ private:
                     660, 710,
                     720, 1000,
                 };
-                m_mesh_chart[1] = generate_chart(CHART_DATA, static_cast<unsigned>(sizeof(CHART_DATA) / sizeof(int16_t)));
+                mesh_compiler.add(m_mesh_chart[1], generate_chart_data(CHART_DATA,
+                            static_cast<unsigned>(sizeof(CHART_DATA) / sizeof(int16_t))), false);
 #if defined(DNLOAD_USE_LD)
-                addPreviewMesh("chart1", *m_mesh_chart[1]);
+                addPreviewMesh("chart1", m_mesh_chart[1]);
 #endif
             }
 
@@ -1021,9 +1044,10 @@ private:
                     570, 550,
                     670, 1000,
                 };
-                m_mesh_chart[2] = generate_chart(CHART_DATA, static_cast<unsigned>(sizeof(CHART_DATA) / sizeof(int16_t)));
+                mesh_compiler.add(m_mesh_chart[2], generate_chart_data(CHART_DATA,
+                            static_cast<unsigned>(sizeof(CHART_DATA) / sizeof(int16_t))), false);
 #if defined(DNLOAD_USE_LD)
-                addPreviewMesh("chart2", *m_mesh_chart[2]);
+                addPreviewMesh("chart2", m_mesh_chart[2]);
 #endif
             }
 
@@ -1036,9 +1060,10 @@ private:
                     570, 550,
                     680, 1000,
                 };
-                m_mesh_chart[3] = generate_chart(CHART_DATA, static_cast<unsigned>(sizeof(CHART_DATA) / sizeof(int16_t)));
+                mesh_compiler.add(m_mesh_chart[3], generate_chart_data(CHART_DATA,
+                            static_cast<unsigned>(sizeof(CHART_DATA) / sizeof(int16_t))), false);
 #if defined(DNLOAD_USE_LD)
-                addPreviewMesh("chart3", *m_mesh_chart[3]);
+                addPreviewMesh("chart3", m_mesh_chart[3]);
 #endif
             }
 
@@ -1052,9 +1077,10 @@ private:
                     615, 670,
                     695, 1000,
                 };
-                m_mesh_chart[4] = generate_chart(CHART_DATA, static_cast<unsigned>(sizeof(CHART_DATA) / sizeof(int16_t)));
+                mesh_compiler.add(m_mesh_chart[4], generate_chart_data(CHART_DATA,
+                            static_cast<unsigned>(sizeof(CHART_DATA) / sizeof(int16_t))), false);
 #if defined(DNLOAD_USE_LD)
-                addPreviewMesh("chart4", *m_mesh_chart[4]);
+                addPreviewMesh("chart4", m_mesh_chart[4]);
 #endif
             }
 
@@ -1068,9 +1094,10 @@ private:
                     660, 880,
                     700, 1000,
                 };
-                m_mesh_chart[5] = generate_chart(CHART_DATA, static_cast<unsigned>(sizeof(CHART_DATA) / sizeof(int16_t)));
+                mesh_compiler.add(m_mesh_chart[5], generate_chart_data(CHART_DATA,
+                            static_cast<unsigned>(sizeof(CHART_DATA) / sizeof(int16_t))), false);
 #if defined(DNLOAD_USE_LD)
-                addPreviewMesh("chart5", *m_mesh_chart[5]);
+                addPreviewMesh("chart5", m_mesh_chart[5]);
 #endif
             }
         }
@@ -1143,12 +1170,9 @@ private:
 
             // End.
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_fence = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_fence, vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("fence", *m_mesh_fence);
+            addPreviewMesh("fence", m_mesh_fence);
 #endif
         }
 
@@ -1255,12 +1279,9 @@ private:
 #include "csg_pylon_base.hpp"
             auto data = CSG_READ_HPP(g_csg_pylon_base_hpp);
 #endif
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_pylon_extra_base = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_pylon_extra_base, vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("pylon_extra_base", *m_mesh_pylon_extra_base);
+            addPreviewMesh("pylon_extra_base", m_mesh_pylon_extra_base);
 #endif
 
 #if defined(DNLOAD_USE_LD)
@@ -1395,12 +1416,9 @@ private:
 
             // End.
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_pylon = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_pylon, vgl::move(data), true, true, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("pylon", *m_mesh_pylon);
+            addPreviewMesh("pylon", m_mesh_pylon);
 #endif
 
             const int16_t ARC_PILLAR_OFFSET = static_cast<int16_t>(PYLON_X * 100.0f);
@@ -1883,12 +1901,9 @@ private:
 
             // End.
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_arc = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_arc, vgl::move(data), true, true, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("arc", *m_mesh_arc);
+            addPreviewMesh("arc", m_mesh_arc);
 #endif
 
             // Tendons.
@@ -1973,12 +1988,9 @@ private:
 
             // End.
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_tendons = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_tendons, vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("tendons", *m_mesh_tendons);
+            addPreviewMesh("tendons", m_mesh_tendons);
 #endif
         }
 
@@ -2055,12 +2067,9 @@ private:
 
             // End.
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_lamppost = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_lamppost, vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("lamppost", *m_mesh_lamppost);
+            addPreviewMesh("lamppost", m_mesh_lamppost);
 #endif
         }
 
@@ -2212,12 +2221,9 @@ private:
 
             // End.
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_bridge = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_bridge, vgl::move(data), true, true, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("bridge", *m_mesh_bridge);
+            addPreviewMesh("bridge", m_mesh_bridge);
 #endif
         }
 
@@ -2301,12 +2307,9 @@ private:
 
             // End.
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_rails = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_rails, vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("rails", *m_mesh_rails);
+            addPreviewMesh("rails", m_mesh_rails);
 #endif
         }
 
@@ -2367,12 +2370,9 @@ private:
 #include "csg_sign0.hpp"
             auto data = CSG_READ_HPP(g_csg_sign0_hpp);
 #endif
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_sign[0] = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_sign[0], vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("sign0", *m_mesh_sign[0]);
+            addPreviewMesh("sign0", m_mesh_sign[0]);
 #endif
 
 #if defined(DNLOAD_USE_LD)
@@ -2410,12 +2410,9 @@ private:
 #include "csg_sign1.hpp"
             data = CSG_READ_HPP(g_csg_sign1_hpp);
 #endif
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_sign[1] = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_sign[1], vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("sign1", *m_mesh_sign[1]);
+            addPreviewMesh("sign1", m_mesh_sign[1]);
 #endif
         }
 
@@ -2476,12 +2473,9 @@ private:
 #include "csg_sign2.hpp"
             auto data = CSG_READ_HPP(g_csg_sign2_hpp);
 #endif
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_sign[2] = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_sign[2], vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("sign2", *m_mesh_sign[2]);
+            addPreviewMesh("sign2", m_mesh_sign[2]);
 #endif
         }
 
@@ -2626,12 +2620,9 @@ private:
 #include "csg_sign3.hpp"
             auto data = CSG_READ_HPP(g_csg_sign3_hpp);
 #endif
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_sign[3] = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_sign[3], vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("sign3", *m_mesh_sign[3]);
+            addPreviewMesh("sign3", m_mesh_sign[3]);
 #endif
         }
 
@@ -2811,12 +2802,9 @@ private:
 
                 // End for particular building.
                 data.push_back(to_int16(vgl::CsgCommand::NONE));
-                {
-                    vgl::LogicalMesh lmesh(data.data());
-                    m_mesh_building[ii] = lmesh.compile();
-                }
+                mesh_compiler.add(m_mesh_building[ii], vgl::move(data), true, true, true);
 #if defined(DNLOAD_USE_LD)
-                addPreviewMesh(("building" + vgl::to_string(ii)).c_str(), *m_mesh_building[ii]);
+                addPreviewMesh(("building" + vgl::to_string(ii)).c_str(), m_mesh_building[ii]);
 #endif
             }
         }
@@ -2956,12 +2944,9 @@ private:
 
             // End for particular building.
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_kerava_state_building = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_kerava_state_building, vgl::move(data), true, true, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("kerava_state_building", *m_mesh_kerava_state_building);
+            addPreviewMesh("kerava_state_building", m_mesh_kerava_state_building);
 #endif
         }
 
@@ -3221,12 +3206,9 @@ private:
 
             // End.
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_burj_kerava = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_burj_kerava, vgl::move(data), true, true, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("burj_kerava", *m_mesh_burj_kerava);
+            addPreviewMesh("burj_kerava", m_mesh_burj_kerava);
 #endif
         }
 
@@ -3415,12 +3397,9 @@ private:
 
             // End.
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_john_kerava_center = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_john_kerava_center, vgl::move(data), true, true, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("john_kerava_center", *m_mesh_john_kerava_center);
+            addPreviewMesh("john_kerava_center", m_mesh_john_kerava_center);
 #endif
         }
 
@@ -3651,12 +3630,9 @@ private:
 
             // End for particular building.
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_keravanas_towers = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_keravanas_towers, vgl::move(data), true, true, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("keravanas_towers", *m_mesh_keravanas_towers);
+            addPreviewMesh("keravanas_towers", m_mesh_keravanas_towers);
 #endif
         }
 
@@ -3689,10 +3665,9 @@ private:
 #define g_animation_ukko_2_throw_size g_animation_Cube_002_Ukko_002_Throw_SingleUser_size
             const float FIGURE_SCALE = 0.0005f;
 
-            vgl::LogicalMesh lmesh(g_vertices_ukko, g_weights_ukko, g_indices_ukko,
-                    g_vertices_ukko_size, g_indices_ukko_size,
-                    FIGURE_SCALE);
-            m_mesh_ukko = lmesh.compile();
+            mesh_compiler.add(m_mesh_ukko, vgl::LogicalMesh(g_vertices_ukko, g_weights_ukko, g_indices_ukko,
+                        g_vertices_ukko_size, g_indices_ukko_size,
+                        FIGURE_SCALE));
             m_animation_ukko[0] = vgl::Animation::create(g_animation_ukko_0_swing,
                     g_bones_ukko_size, g_animation_ukko_0_swing_size,
                     FIGURE_SCALE);
@@ -3715,7 +3690,7 @@ private:
                     g_bones_ukko_size, g_animation_ukko_0_trash_size,
                     FIGURE_SCALE);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("ukko", *m_mesh_ukko);
+            addPreviewMesh("ukko", m_mesh_ukko);
 #endif
         }
 
@@ -4453,12 +4428,9 @@ private:
 
             // End.
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_sm5_interior = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_sm5_interior, vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("sm5_interior", *m_mesh_sm5_interior);
+            addPreviewMesh("sm5_interior", m_mesh_sm5_interior);
 #endif
         }
 
@@ -4538,12 +4510,9 @@ private:
 #include "csg_sm5_chair.hpp"
             auto data = CSG_READ_HPP(g_csg_sm5_chair_hpp);
 #endif
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_sm5_chair[1] = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_sm5_chair[1], vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("sm5_chair", *m_mesh_sm5_chair[1]);
+            addPreviewMesh("sm5_chair", m_mesh_sm5_chair[1]);
 #endif
 
 #if defined(DNLOAD_USE_LD)
@@ -4570,12 +4539,9 @@ private:
 #include "csg_sm5_chair_l.hpp"
             data = CSG_READ_HPP(g_csg_sm5_chair_l_hpp);
 #endif
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_sm5_chair[0] = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_sm5_chair[0], vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("sm5_chair_l", *m_mesh_sm5_chair[0]);
+            addPreviewMesh("sm5_chair_l", m_mesh_sm5_chair[0]);
 #endif
 
 #if defined(DNLOAD_USE_LD)
@@ -4588,12 +4554,9 @@ private:
 #include "csg_sm5_chair_r.hpp"
             data = CSG_READ_HPP(g_csg_sm5_chair_r_hpp);
 #endif
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_sm5_chair[2] = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_sm5_chair[2], vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("sm5_chair_r", *m_mesh_sm5_chair[2]);
+            addPreviewMesh("sm5_chair_r", m_mesh_sm5_chair[2]);
 #endif
         }
 
@@ -5410,12 +5373,9 @@ private:
 
                 // Veturi end.
                 data.push_back(to_int16(vgl::CsgCommand::NONE));
-                {
-                    vgl::LogicalMesh lmesh(data.data());
-                    m_mesh_train[0] = lmesh.compile();
-                }
+                mesh_compiler.add(m_mesh_train[0], vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-                addPreviewMesh("train0", *m_mesh_train[0]);
+                addPreviewMesh("train0", m_mesh_train[0]);
 #endif
             }
 
@@ -5822,12 +5782,9 @@ private:
 
                 // Vaunu end.
                 data.push_back(to_int16(vgl::CsgCommand::NONE));
-                {
-                    vgl::LogicalMesh lmesh(data.data());
-                    m_mesh_train[1] = lmesh.compile();
-                }
+                mesh_compiler.add(m_mesh_train[1], vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-                addPreviewMesh("train1", *m_mesh_train[1]);
+                addPreviewMesh("train1", m_mesh_train[1]);
 #endif
             }
         }
@@ -5952,12 +5909,9 @@ private:
             }
 
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_katos = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_katos, vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("katos", *m_mesh_katos);
+            addPreviewMesh("katos", m_mesh_katos);
 #endif
         }
 
@@ -6069,12 +6023,9 @@ private:
                     TOWER_FRAME_INSET);
 
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_tower = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_tower, vgl::move(data), true, true, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("tower", *m_mesh_tower);
+            addPreviewMesh("tower", m_mesh_tower);
 #endif
         }
 
@@ -6303,12 +6254,9 @@ private:
             generate_kaide(RAMP_XR);
 
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_ramp = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_ramp, vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("ramp", *m_mesh_ramp);
+            addPreviewMesh("ramp", m_mesh_ramp);
 #endif
         }
 
@@ -6828,12 +6776,9 @@ private:
             generate_mid_shape(static_cast<int16_t>(-STATION_MID_OFFSET));
 
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_kerava_station = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_kerava_station, vgl::move(data), true, true, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("kerava_station", *m_mesh_kerava_station);
+            addPreviewMesh("kerava_station", m_mesh_kerava_station);
 #endif
         }
 
@@ -7166,12 +7111,9 @@ private:
                     vgl::vec3(1.0f, 0.0f, 0.0f), PIER_WIDTH, PIER_HEIGHT, PIER_EXTENT, 16);
 
             data.push_back(to_int16(vgl::CsgCommand::NONE));
-            {
-                vgl::LogicalMesh lmesh(data.data());
-                m_mesh_station_building = lmesh.compile();
-            }
+            mesh_compiler.add(m_mesh_station_building, vgl::move(data), true, true, true);
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("station_building", *m_mesh_station_building);
+            addPreviewMesh("station_building", m_mesh_station_building);
 #endif
         }
 
@@ -7180,15 +7122,23 @@ private:
 #include "mesh_sirkus_hevo_nen.hpp"
             const float SIRKUS_HEVO_NEN_SCALE = 0.0005f;
 
-            vgl::LogicalMesh lmesh(g_vertices_g_sirkus_hevo_nen, g_indices_g_sirkus_hevo_nen,
-                    g_vertices_g_sirkus_hevo_nen_size, g_indices_g_sirkus_hevo_nen_size,
-                    SIRKUS_HEVO_NEN_SCALE);
-            m_mesh_sirkus_hevo_nen = lmesh.compile();
+            mesh_compiler.add(m_mesh_sirkus_hevo_nen, vgl::LogicalMesh(g_vertices_g_sirkus_hevo_nen,
+                        g_indices_g_sirkus_hevo_nen, g_vertices_g_sirkus_hevo_nen_size,
+                        g_indices_g_sirkus_hevo_nen_size, SIRKUS_HEVO_NEN_SCALE));
 #if defined(DNLOAD_USE_LD)
-            addPreviewMesh("sirkus_hevo_nen", *m_mesh_sirkus_hevo_nen);
+            addPreviewMesh("sirkus_hevo_nen", m_mesh_sirkus_hevo_nen);
 #endif
         }
 
+        // Worlds and glyphs need finished meshes.
+        mesh_compiler.finish();
+
+        // Copy mesh pointers for easy access.
+        for(unsigned ii = 0; (ii < WORLD_GLYPH_SLICE_COUNT); ++ii)
+        {
+            m_glyph[ii] = m_mesh_glyph[ii].get();
+        }
+
         // Construct world 0 (first-person train carriage).
 #if defined(DNLOAD_USE_LD)
         if(g_preview_mesh.empty() || g_preview_mesh.starts_with("world"))
@@ -7403,12 +7353,14 @@ private:
                     }
                 }
 
-                m_mesh_terrain[kk] = lmesh.compile(false);
+                mesh_compiler.add(m_mesh_terrain[kk], vgl::move(lmesh), false, true, true);
 #if defined(DNLOAD_USE_LD)
-                addPreviewMesh(("terrain" + vgl::to_string(kk)).c_str(), *m_mesh_terrain[kk]);
+                addPreviewMesh(("terrain" + vgl::to_string(kk)).c_str(), m_mesh_terrain[kk]);
 #endif
             }
 
+            mesh_compiler.finish();
+
             // World layout.
             {
                 IntroWorld& world = m_world[1];
@@ -7592,6 +7544,14 @@ private:
                     }
                 }
 
+#if defined(VGL_ENABLE_OCCLUSION_CULLING)
+                // Towers are solid enough to hide the city behind them.
+                for(int ii = 0; (ii < BUILDING_COUNT); ++ii)
+                {
+                    world.addOccluder(getMeshBuilding(ii));
+                }
+#endif
+
                 world.sort();
             }
 
@@ -7794,13 +7754,15 @@ private:
                             }
                         }
                     }
-                    m_mesh_terrain_kerava = lmesh.compile();
+                    mesh_compiler.add(m_mesh_terrain_kerava, vgl::move(lmesh), true, true, true);
                 }
 #if defined(DNLOAD_USE_LD)
-                addPreviewMesh("terrain_kerava", *m_mesh_terrain_kerava);
+                addPreviewMesh("terrain_kerava", m_mesh_terrain_kerava);
 #endif
             }
 
+            mesh_compiler.finish();
+
             // Kerava station world.
             IntroWorld& world = m_world[3];
             vgl::GlslProgram& prog = getProgramOffscreen();
@@ -7940,15 +7902,14 @@ private:
                 generate_hevos_stand(-90, 0, SIRKUS_HEVO_SET_H3, true);
 
                 data.push_back(to_int16(vgl::CsgCommand::NONE));
-                {
-                    vgl::LogicalMesh lmesh(data.data());
-                    m_mesh_terrain_sirkus_hevo_set = lmesh.compile();
-                }
+                mesh_compiler.add(m_mesh_terrain_sirkus_hevo_set, vgl::move(data), true, false, true);
 #if defined(DNLOAD_USE_LD)
-                addPreviewMesh("terrain_sirkus_hevo_set", *m_mesh_terrain_sirkus_hevo_set);
+                addPreviewMesh("terrain_sirkus_hevo_set", m_mesh_terrain_sirkus_hevo_set);
 #endif
             }
 
+            mesh_compiler.finish();
+
             // Sirkus hevo set world.
             IntroWorld& world = m_world[4];
             vgl::GlslProgram& prog = getProgramOffscreen();
@@ -7963,6 +7924,19 @@ private:
 
             world.sort();
         }
+
+#if defined(VGL_ENABLE_STATIC_BATCHING)
+        // Merge static world geometry, merged meshes need to be uploaded in the main thread.
+        for(auto& vv : m_world)
+        {
+            vv.batch();
+        }
+        vgl::TaskDispatcher::wait_main(task_update_worlds, this);
+#endif
+
+#if defined(DNLOAD_USE_LD)
+        namePreviewMeshes();
+#endif
     }
 
 public:
@@ -8002,6 +7976,15 @@ public:
     {
         return m_program_offscreen;
     }
+#if defined(VGL_ENABLE_INSTANCING)
+    /// Accessor.
+    ///
+    /// \return Program.
+    vgl::GlslProgram& getProgramOffscreenInstanced()
+    {
+        return m_program_offscreen_instanced;
+    }
+#endif
     /// Accessor.
     ///
     /// \return Program.
@@ -8362,13 +8345,13 @@ public:
         // If developer mode is on, load audio instead of generating it.
         if (g_flag_developer)
         {
-            vgl::Fence audio_fence = vgl::TaskDispatcher::wait(task_audio_load, this);
+            vgl::Fence audio_fence = vgl::TaskDispatcher::wait(task_audio_load, this, vgl::TaskPriority::LOW);
             initializeGraphics();
         }
         else
 #endif
         {
-            vgl::Fence audio_fence = vgl::TaskDispatcher::wait(task_audio_generate, this);
+            vgl::Fence audio_fence = vgl::TaskDispatcher::wait(task_audio_generate, this, vgl::TaskPriority::LOW);
             initializeGraphics();
         }
 
@@ -8380,11 +8363,21 @@ public:
     /// Add a preview mesh.
     ///
     /// \param name Name of the mesh.
-    /// \param mesh Mesh.
-    void addPreviewMesh(vgl::string_view name, vgl::Mesh& mesh)
+    /// \param mesh Mesh, may not have finished compiling yet.
+    void addPreviewMesh(vgl::string_view name, vgl::MeshUptr& mesh)
     {
-        mesh.setName(name);
-        m_preview_meshes.push_back(&mesh);
+        m_preview_meshes.emplace_back(vgl::string(name), &mesh);
+    }
+
+    /// Apply names to preview meshes.
+    ///
+    /// Must be called after all preview meshes have finished compiling.
+    void namePreviewMeshes()
+    {
+        for(auto& vv : m_preview_meshes)
+        {
+            (*vv.second)->setName(vv.first);
+        }
     }
 
     /// Gets a mesh by name.
@@ -8394,9 +8387,9 @@ public:
     {
         for(const auto& ii : m_preview_meshes)
         {
-            if(ii->getName() == name)
+            if(ii.first == name)
             {
-                return ii;
+                return ii.second->get();
             }
         }
         return nullptr;
@@ -8410,6 +8403,12 @@ public:
         {
             VGL_THROW_RUNTIME_ERROR("program recreation failure");
         }
+#if defined(VGL_ENABLE_INSTANCING)
+        if(!m_program_offscreen_instanced.relink())
+        {
+            VGL_THROW_RUNTIME_ERROR("program recreation failure");
+        }
+#endif
     }
 #endif
 
@@ -8528,6 +8527,22 @@ private:
         data->initializeGraphicsImmediate();
         return nullptr;
     }
+
+#if defined(VGL_ENABLE_STATIC_BATCHING)
+    /// Function for updating static world batches to the GPU.
+    ///
+    /// \param op Intro data passed as pointer.
+    /// \return nullptr
+    static void* task_update_worlds(void* op)
+    {
+        IntroData* data = static_cast<IntroData*>(op);
+        for(auto& vv : data->m_world)
+        {
+            vv.update();
+        }
+        return nullptr;
+    }
+#endif
 };
 
 /// Intro data instance.
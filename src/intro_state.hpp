@@ -575,9 +575,21 @@ public:
     /// Must be executed on main thread.
     void draw() const
     {
+#if defined(DNLOAD_USE_LD)
+        unsigned draw_calls = vgl::get_draw_calls();
+        unsigned binds = vgl::get_vertex_array_object_binds();
+        unsigned switches = vgl::get_vertex_array_object_switches();
+        unsigned program_switches = vgl::get_program_switches();
+        unsigned uniforms = vgl::get_uniform_calls();
+        unsigned uniforms_skipped = vgl::get_uniform_calls_skipped();
+#endif
+
         m_queue.draw();
 
 #if defined(DNLOAD_USE_LD)
+        g_world_statistics.endDraw(vgl::get_draw_calls() - draw_calls, vgl::get_vertex_array_object_binds() - binds,
+                vgl::get_vertex_array_object_switches() - switches, vgl::get_program_switches() - program_switches,
+                vgl::get_uniform_calls() - uniforms, vgl::get_uniform_calls_skipped() - uniforms_skipped);
         vgl::error_check("draw()");
 #endif
     }
@@ -1113,6 +1125,9 @@ public:
         m_queue.pushDepth(GL_LESS, true);
         m_queue.pushClear(vgl::uvec4(255u, 255u, 255u, 0u), 1.0f);
 
+        // Pixels covered by an unit of length at unit distance, for world level of detail selection.
+        const float lod_scale = static_cast<float>(fbo.getWidth()) * 0.5f / dnload_tanf(fov * 0.5f);
+
 #if defined(DNLOAD_USE_LD)
         // Set debug mode on or off for all programs.
         if(g_visual_debug != g_last_visual_debug)
@@ -1121,6 +1136,10 @@ public:
             m_queue.push("debug_mode", g_visual_debug);
             m_queue.push(g_data.getProgramOffscreen());
             m_queue.push("debug_mode", g_visual_debug);
+#if defined(VGL_ENABLE_INSTANCING)
+            m_queue.push(g_data.getProgramOffscreenInstanced());
+            m_queue.push("debug_mode", g_visual_debug);
+#endif
             m_queue.push(g_data.getProgramPost());
             m_queue.push("debug_mode", g_visual_debug);
             m_queue.push(g_data.getProgramSkeleton());
@@ -1187,14 +1206,14 @@ public:
                 // Push text before the camera settings are changed for the world coordinates.
                 pushText(ticks);
 
-                g_data.getWorld(0).render(m_queue, pos, WORLD0_EXTENTS);
+                g_data.getWorld(0).render(m_queue, pos, WORLD0_EXTENTS, lod_scale);
                 // Outside.
                 {
                     vgl::vec3 cpos = vgl::vec3(IntroData::RAILS_X, 1.5f, -800.0f + static_cast<float>(scene_ticks) * 0.5f) + pos;
                     vgl::mat4 cam = vgl::mat4::lookat(cpos, cpos + fw, up);
                     m_queue.push(prj, rng, cam);
 
-                    g_data.getWorld(1).render(m_queue, cpos, WORLD12_EXTENTS);
+                    g_data.getWorld(1).render(m_queue, cpos, WORLD12_EXTENTS, lod_scale);
                 }
             }
             break;
@@ -1224,8 +1243,8 @@ public:
                 // Dynamic objects likely to be in front of the world.
                 pushTrains(ticks);
 
-                g_data.getWorld(1).render(m_queue, pos, WORLD12_EXTENTS);
-                g_data.getWorld(2).render(m_queue, pos, WORLD12_EXTENTS);
+                g_data.getWorld(1).render(m_queue, pos, WORLD12_EXTENTS, lod_scale);
+                g_data.getWorld(2).render(m_queue, pos, WORLD12_EXTENTS, lod_scale);
             }
             break;
 
@@ -1240,7 +1259,7 @@ public:
                 // Change landmark state before rendering world.
                 pushLandmark(ticks);
 
-                g_data.getWorld(1).render(m_queue, pos, WORLD12_EXTENTS);
+                g_data.getWorld(1).render(m_queue, pos, WORLD12_EXTENTS, lod_scale);
             }
             break;
 
@@ -1258,7 +1277,7 @@ public:
                 pushTrains(ticks);
                 pushUkko(ticks);
 
-                g_data.getWorld(3).render(m_queue, pos, WORLD3_EXTENTS);
+                g_data.getWorld(3).render(m_queue, pos, WORLD3_EXTENTS, lod_scale);
 
                 pushVisualizations(ticks);
             }
@@ -1275,7 +1294,7 @@ public:
                 vgl::mat4 cam = vgl::mat4::lookat(pos, pos + fw, up);
                 m_queue.push(prj, rng, cam);
 
-                g_data.getWorld(4).render(m_queue, pos, WORLD4_EXTENTS);
+                g_data.getWorld(4).render(m_queue, pos, WORLD4_EXTENTS, lod_scale);
             }
             break;
 
@@ -1284,6 +1303,9 @@ public:
             break;
 #endif
         }
+#if defined(DNLOAD_USE_LD)
+        g_world_statistics.endFrame();
+#endif
 
         // Post phase.
         m_queue.push(screen);
@@ -1367,6 +1389,18 @@ public:
                 std::string ftime = g_frame_counter.getFramerate();
                 draw_text(m_queue, vgl::vec3(-0.98f, 0.62f, 0.0f), vgl::mat4::identity(), font, glyph, fs, ftime.c_str());
             }
+            {
+                std::string triangles = g_world_statistics.getLastFrame();
+                draw_text(m_queue, vgl::vec3(-0.98f, 0.53f, 0.0f), vgl::mat4::identity(), font, glyph, fs, triangles.c_str());
+            }
+            {
+                std::string vao = g_world_statistics.getLastDraw();
+                draw_text(m_queue, vgl::vec3(-0.98f, 0.44f, 0.0f), vgl::mat4::identity(), font, glyph, fs, vao.c_str());
+            }
+            {
+                std::string uniforms = g_world_statistics.getLastUniforms();
+                draw_text(m_queue, vgl::vec3(-0.98f, 0.35f, 0.0f), vgl::mat4::identity(), font, glyph, fs, uniforms.c_str());
+            }
         }
 #endif
     }
@@ -7,6 +7,296 @@ constexpr unsigned WORLD_GLYPH_SLICE_COUNT = 8;
 /// Glyph mesh array type.
 using GlyphMeshArray = vgl::array<const vgl::Mesh*, WORLD_GLYPH_SLICE_COUNT>;
 
+#if defined(VGL_ENABLE_MESH_LOD)
+/// Maximum allowed level of detail error in pixels.
+constexpr float WORLD_LOD_PIXEL_ERROR = 2.0f;
+#endif
+
+/// Cell size of the grid used for collision checks when placing entities.
+constexpr float WORLD_PLACEMENT_CELL_SIZE = 16.0f;
+
+#if defined(VGL_ENABLE_OCCLUSION_CULLING)
+/// Scale of occluder bounding boxes around their centers, since meshes do not fill their bounding boxes completely.
+constexpr float WORLD_OCCLUDER_SCALE = 0.75f;
+#endif
+
+#if defined(VGL_ENABLE_STATIC_BATCHING)
+/// Maximum Z span of entity centers merged into one static batch.
+constexpr float WORLD_BATCH_DEPTH = 32.0f;
+#endif
+
+#if defined(DNLOAD_USE_LD)
+
+/// Statistics on triangles pushed for rendering from worlds and on state changes and uniform calls when drawing.
+///
+/// Frames are generated one at a time and drawn on the main thread, but the last frame may be read from other
+/// threads.
+class IntroWorldStatistics
+{
+private:
+    /// Triangles pushed during the frame being generated.
+    unsigned m_triangles = 0;
+
+    /// Triangles that would have been pushed at full detail during the frame being generated.
+    unsigned m_triangles_full = 0;
+
+    /// Triangles pushed during the last frame.
+    std::atomic<unsigned> m_last_triangles = 0;
+
+    /// Triangles that would have been pushed at full detail during the last frame.
+    std::atomic<unsigned> m_last_triangles_full = 0;
+
+    /// Total triangles pushed.
+    uint64_t m_total_triangles = 0;
+
+    /// Total triangles that would have been pushed at full detail.
+    uint64_t m_total_triangles_full = 0;
+
+    /// Most triangles pushed during a frame.
+    unsigned m_peak_triangles = 0;
+
+    /// Entities submitted during the frame being generated.
+    unsigned m_submitted = 0;
+
+    /// Entities culled by the view frustum during the frame being generated.
+    unsigned m_culled = 0;
+
+    /// Entities submitted during the last frame.
+    std::atomic<unsigned> m_last_submitted = 0;
+
+    /// Entities culled by the view frustum during the last frame.
+    std::atomic<unsigned> m_last_culled = 0;
+
+    /// Total entities submitted.
+    uint64_t m_total_submitted = 0;
+
+    /// Total entities culled by the view frustum.
+    uint64_t m_total_culled = 0;
+
+    /// Entities culled by occluders during the frame being generated.
+    unsigned m_occluded = 0;
+
+    /// Entities culled by occluders during the last frame.
+    std::atomic<unsigned> m_last_occluded = 0;
+
+    /// Total entities culled by occluders.
+    uint64_t m_total_occluded = 0;
+
+    /// Attempts to place entities without collisions.
+    unsigned m_placement_attempts = 0;
+
+    /// Placement attempts rejected due to collisions.
+    unsigned m_placement_rejections = 0;
+
+    /// Time spent placing entities.
+    std::chrono::steady_clock::duration m_placement_time = std::chrono::steady_clock::duration::zero();
+
+    /// Number of frames.
+    unsigned m_frame_count = 0;
+
+    /// Draw calls during the last drawn frame.
+    std::atomic<unsigned> m_last_draw_calls = 0;
+
+    /// Total draw calls.
+    uint64_t m_total_draw_calls = 0;
+
+    /// Vertex array object bind requests during the last drawn frame.
+    std::atomic<unsigned> m_last_binds = 0;
+
+    /// Vertex array object switches during the last drawn frame.
+    std::atomic<unsigned> m_last_switches = 0;
+
+    /// Program switches during the last drawn frame.
+    std::atomic<unsigned> m_last_program_switches = 0;
+
+    /// Total vertex array object bind requests.
+    uint64_t m_total_binds = 0;
+
+    /// Total vertex array object switches.
+    uint64_t m_total_switches = 0;
+
+    /// Total program switches.
+    uint64_t m_total_program_switches = 0;
+
+    /// Uniform calls issued during the last drawn frame.
+    std::atomic<unsigned> m_last_uniforms = 0;
+
+    /// Uniform calls skipped during the last drawn frame.
+    std::atomic<unsigned> m_last_uniforms_skipped = 0;
+
+    /// Total uniform calls issued.
+    uint64_t m_total_uniforms = 0;
+
+    /// Total uniform calls skipped.
+    uint64_t m_total_uniforms_skipped = 0;
+
+    /// Number of drawn frames.
+    unsigned m_draw_count = 0;
+
+public:
+    /// Default constructor.
+    explicit IntroWorldStatistics() = default;
+
+    /// Destructor.
+    ///
+    /// Prints the summary.
+    ~IntroWorldStatistics()
+    {
+        if(m_placement_attempts)
+        {
+            std::cout << "IntroWorld: " << m_placement_attempts << " placement attempts, " << m_placement_rejections <<
+                " rejected, " << std::chrono::duration_cast<std::chrono::microseconds>(m_placement_time).count() <<
+                " us" << std::endl;
+        }
+        if(m_frame_count)
+        {
+            std::cout << "IntroWorld: " << (m_total_triangles / m_frame_count) << " triangles per frame (" <<
+                (m_total_triangles_full / m_frame_count) << " at full detail), peak " << m_peak_triangles <<
+                " over " << m_frame_count << " frames" << std::endl;
+            std::cout << "IntroWorld: " << (m_total_submitted / m_frame_count) << " entities submitted, " <<
+                (m_total_culled / m_frame_count) << " culled and " << (m_total_occluded / m_frame_count) <<
+                " occluded per frame" << std::endl;
+        }
+        if(m_draw_count)
+        {
+            std::cout << "IntroWorld: " << (m_total_draw_calls / m_draw_count) << " draw calls and " <<
+                (m_total_binds / m_draw_count) << " VAO binds and " <<
+                (m_total_switches / m_draw_count) << " VAO switches and " <<
+                (m_total_program_switches / m_draw_count) << " program switches per frame over " << m_draw_count <<
+                " drawn frames" << std::endl;
+            std::cout << "IntroWorld: " << (m_total_uniforms / m_draw_count) << " uniform calls issued and " <<
+                (m_total_uniforms_skipped / m_draw_count) << " skipped per frame" << std::endl;
+        }
+    }
+
+public:
+    /// Add a pushed mesh.
+    ///
+    /// \param mesh Mesh pushed.
+    /// \param full Full detail version of the mesh.
+    void add(const vgl::Mesh& mesh, const vgl::Mesh& full)
+    {
+        m_triangles += mesh.getData().getIndexCount() / 3;
+        m_triangles_full += full.getData().getIndexCount() / 3;
+    }
+
+    /// Add a placement attempt.
+    ///
+    /// \param accepted True if the entity was placed, false if rejected.
+    /// \param time Time spent.
+    void addPlacement(bool accepted, std::chrono::steady_clock::duration time)
+    {
+        ++m_placement_attempts;
+        if(!accepted)
+        {
+            ++m_placement_rejections;
+        }
+        m_placement_time += time;
+    }
+
+    /// Add a submitted entity or static batch.
+    void addSubmitted()
+    {
+        ++m_submitted;
+    }
+
+    /// Add entities or static batches culled by the view frustum.
+    ///
+    /// \param op Number of culled entities.
+    void addCulled(unsigned op)
+    {
+        m_culled += op;
+    }
+
+    /// Add an entity culled by occluders.
+    void addOccluded()
+    {
+        ++m_occluded;
+    }
+
+    /// End the frame being generated.
+    void endFrame()
+    {
+        m_last_triangles = m_triangles;
+        m_last_triangles_full = m_triangles_full;
+        m_total_triangles += m_triangles;
+        m_total_triangles_full += m_triangles_full;
+        m_peak_triangles = vgl::max(m_peak_triangles, m_triangles);
+        ++m_frame_count;
+        m_triangles = 0;
+        m_triangles_full = 0;
+        m_last_submitted = m_submitted;
+        m_last_culled = m_culled;
+        m_total_submitted += m_submitted;
+        m_total_culled += m_culled;
+        m_last_occluded = m_occluded;
+        m_total_occluded += m_occluded;
+        m_submitted = 0;
+        m_culled = 0;
+        m_occluded = 0;
+    }
+
+    /// End the frame being drawn.
+    ///
+    /// \param draw_calls Draw calls during the frame.
+    /// \param binds Vertex array object bind requests during the frame.
+    /// \param switches Vertex array object switches during the frame.
+    /// \param program_switches Program switches during the frame.
+    /// \param uniforms Uniform calls issued during the frame.
+    /// \param uniforms_skipped Uniform calls skipped during the frame.
+    void endDraw(unsigned draw_calls, unsigned binds, unsigned switches, unsigned program_switches, unsigned uniforms,
+            unsigned uniforms_skipped)
+    {
+        m_last_draw_calls = draw_calls;
+        m_total_draw_calls += draw_calls;
+        m_last_binds = binds;
+        m_last_switches = switches;
+        m_last_program_switches = program_switches;
+        m_total_program_switches += program_switches;
+        m_last_uniforms = uniforms;
+        m_last_uniforms_skipped = uniforms_skipped;
+        m_total_binds += binds;
+        m_total_switches += switches;
+        m_total_uniforms += uniforms;
+        m_total_uniforms_skipped += uniforms_skipped;
+        ++m_draw_count;
+    }
+
+    /// Get statistics of the last frame.
+    ///
+    /// \return Human-readable string.
+    std::string getLastFrame() const
+    {
+        return "triangles: " + std::to_string(m_last_triangles.load()) + " / " +
+            std::to_string(m_last_triangles_full.load()) + " entities: " + std::to_string(m_last_submitted.load()) +
+            " / " + std::to_string(m_last_culled.load()) + " / " + std::to_string(m_last_occluded.load());
+    }
+
+    /// Get draw statistics of the last frame.
+    ///
+    /// \return Human-readable string.
+    std::string getLastDraw() const
+    {
+        return "draws: " + std::to_string(m_last_draw_calls.load()) + " vao: " +
+            std::to_string(m_last_binds.load()) + " / " + std::to_string(m_last_switches.load()) + " program: " +
+            std::to_string(m_last_program_switches.load());
+    }
+
+    /// Get uniform statistics of the last frame.
+    ///
+    /// \return Human-readable string.
+    std::string getLastUniforms() const
+    {
+        return "uniforms: " + std::to_string(m_last_uniforms.load()) + " / " +
+            std::to_string(m_last_uniforms_skipped.load());
+    }
+};
+
+/// Global world statistics.
+static IntroWorldStatistics g_world_statistics;
+
+#endif
+
 /// Create world position.
 ///
 /// \param px X position (x10).
@@ -148,6 +438,11 @@ private:
         /// Cached before sorting.
         vgl::BoundingBox m_transformed_bounding_box;
 
+#if defined(VGL_ENABLE_STATIC_BATCHING)
+        /// Set if the entity has been merged into a static batch and is not rendered by itself.
+        bool m_batched = false;
+#endif
+
     public:
         /// Constructor.
         ///
@@ -231,14 +526,62 @@ private:
             return m_transform;
         }
 
-        /// Test if the bounding box collides with another bounding box.
+        /// Accessor.
+        ///
+        /// \return Bounding box (transformed).
+        constexpr const vgl::BoundingBox& getBoundingBox() const noexcept
+        {
+            return m_transformed_bounding_box;
+        }
+
+        /// Tell if the entity is a static mesh.
+        ///
+        /// Entities with callbacks may move and text may extend past the cached bounding box, so only static meshes
+        /// may be culled with the view frustum or merged into static batches.
+        ///
+        /// \return True if the entity is a static mesh.
+        constexpr bool isStatic() const noexcept
+        {
+            return m_mesh && !m_callback;
+        }
+
+        /// Test if the entity is within the view frustum.
+        ///
+        /// Only static meshes are culled.
         ///
-        /// \param op Bounding box to test with.
-        constexpr bool collides(const vgl::BoundingBox& op) const noexcept
+        /// \param op View frustum.
+        /// \return True if visible, false otherwise.
+        constexpr bool isVisible(const vgl::Frustum& op) const noexcept
         {
-            return m_transformed_bounding_box.collides(op);
+            return !isStatic() || op.isVisible(m_transformed_bounding_box);
         }
 
+#if defined(VGL_ENABLE_STATIC_BATCHING)
+        /// Accessor.
+        ///
+        /// \return Program.
+        constexpr const vgl::GlslProgram& getProgram() const noexcept
+        {
+            return m_program;
+        }
+
+        /// Tell if the entity has been merged into a static batch.
+        ///
+        /// \return True if batched.
+        constexpr bool isBatched() const noexcept
+        {
+            return m_batched;
+        }
+
+        /// Set the batched flag.
+        ///
+        /// \param op New value.
+        constexpr void setBatched(bool op) noexcept
+        {
+            m_batched = op;
+        }
+#endif
+
         /// Test if the bounding box collides with given z range.
         ///
         /// \param zmin Smaller Z value.
@@ -257,26 +600,64 @@ private:
             return m_transformed_bounding_box.getCenter();
         }
 
+#if defined(VGL_ENABLE_MESH_LOD)
+        /// Select the level of detail to render the mesh with.
+        ///
+        /// Uses the distance from the camera to the bounding sphere of the entity. Entity transformations are assumed
+        /// not to scale.
+        ///
+        /// \param pos Camera position.
+        /// \param lod_scale Pixels per unit of length at unit distance.
+        /// \return Mesh to render.
+        const vgl::Mesh& selectLod(const vgl::vec3& pos, float lod_scale) const
+        {
+            const vgl::BoundingBox& box = m_transformed_bounding_box;
+            float radius = length(box.getMax() - box.getMin()) * 0.5f;
+            float distance = length(box.getCenter() - pos) - radius;
+            if(distance <= 0.0f)
+            {
+                return *m_mesh;
+            }
+            return m_mesh->selectLod(distance * WORLD_LOD_PIXEL_ERROR / lod_scale);
+        }
+#endif
+
         /// Render the entity.
         ///
         /// \param queue Queue to push the entity to.
-        void render(vgl::RenderQueue& queue) const
+        /// \param pos Camera position.
+        /// \param lod_scale Pixels per unit of length at unit distance.
+        void render(vgl::RenderQueue& queue, const vgl::vec3& pos, float lod_scale) const
         {
+#if defined(DNLOAD_USE_LD)
+            g_world_statistics.addSubmitted();
+#endif
             if(m_callback)
             {
+                queue.flushSorted();
                 m_callback(queue, m_program, *m_mesh, m_transform);
             }
             else
             {
                 if(m_font)
                 {
+                    queue.flushSorted();
                     queue.push(m_program);
                     draw_text(queue, m_pen_pos, m_transform, *m_font, *m_glyph, m_font_size, m_text);
                 }
                 else
                 {
-                    queue.push(m_program);
-                    queue.push(*m_mesh, m_transform);
+#if defined(VGL_ENABLE_MESH_LOD)
+                    const vgl::Mesh& mesh = selectLod(pos, lod_scale);
+#else
+                    (void)pos;
+                    (void)lod_scale;
+                    const vgl::Mesh& mesh = *m_mesh;
+#endif
+                    queue.pushSorted(m_program, mesh, m_transform);
+#if defined(DNLOAD_USE_LD)
+                    g_world_statistics.add(mesh, *m_mesh);
+#endif
                 }
             }
         }
@@ -307,15 +688,145 @@ private:
         }
     };
 
+#if defined(VGL_ENABLE_STATIC_BATCHING)
+    /// Static entities drawn with the same program, merged into one mesh.
+    class Batch
+    {
+    private:
+        /// Program to use for rendering.
+        const vgl::GlslProgram& m_program;
+
+        /// Merged mesh.
+        vgl::MeshUptr m_mesh;
+
+        /// First entity merged.
+        Entity* m_first;
+
+        /// Number of entities merged.
+        unsigned m_entity_count = 0;
+
+    public:
+        /// Constructor.
+        ///
+        /// \param first First entity of the batch.
+        explicit Batch(Entity& first) :
+            m_program(first.getProgram()),
+            m_mesh(new vgl::Mesh()),
+            m_first(&first)
+        {
+        }
+
+    public:
+        /// Accessor.
+        ///
+        /// \return Program.
+        constexpr const vgl::GlslProgram& getProgram() const noexcept
+        {
+            return m_program;
+        }
+
+        /// Accessor.
+        ///
+        /// \return First entity merged.
+        constexpr Entity& getFirst() const noexcept
+        {
+            return *m_first;
+        }
+
+        /// Accessor.
+        ///
+        /// \return Number of entities merged.
+        constexpr unsigned getEntityCount() const noexcept
+        {
+            return m_entity_count;
+        }
+
+        /// Try to merge an entity into this batch.
+        ///
+        /// \param op Entity to merge.
+        /// \return True if merged, false if the entity does not fit into this batch.
+        bool tryAdd(Entity& op)
+        {
+            const vgl::Mesh& mesh = *op.getMesh();
+            if((&op.getProgram() != &m_program) ||
+                    ((op.getCenter().z() - m_first->getCenter().z()) > WORLD_BATCH_DEPTH) ||
+                    ((m_mesh->getData().getVertexCount() + mesh.getData().getVertexCount()) >
+                     vgl::GEOMETRY_BUFFER_MAX_VERTICES) ||
+                    !m_mesh->appendTransformed(mesh, op.getTransform()))
+            {
+                return false;
+            }
+            op.setBatched(true);
+            ++m_entity_count;
+            return true;
+        }
+
+        /// Update the merged mesh to the GPU.
+        void update()
+        {
+            m_mesh->update();
+        }
+
+        /// Render the batch if it collides with given z range and is within the view frustum.
+        ///
+        /// \param queue Queue to push the batch to.
+        /// \param frustum View frustum.
+        /// \param zmin Smaller Z value.
+        /// \param zmax Larger Z value.
+        void render(vgl::RenderQueue& queue, const vgl::Frustum& frustum, float zmin, float zmax) const
+        {
+            const vgl::BoundingBox& box = m_mesh->getBoundingBox();
+            if(!box.collidesZ(zmin, zmax))
+            {
+                return;
+            }
+            if(!frustum.isVisible(box))
+            {
+#if defined(DNLOAD_USE_LD)
+                g_world_statistics.addCulled(1);
+#endif
+                return;
+            }
+            queue.pushSorted(m_program, *m_mesh, vgl::mat4::identity());
+#if defined(DNLOAD_USE_LD)
+            g_world_statistics.addSubmitted();
+            g_world_statistics.add(*m_mesh, *m_mesh);
+#endif
+        }
+    };
+#endif
+
 private:
     /// List of entities.
     vgl::vector<Entity> m_entities;
 
-    /// Z extents to use for rendering.
-    /// 0: Positive extent.
-    /// 1: Negative extent.
-    /// 2: Search range.
-    vgl::vec3 m_z_extents;
+#if defined(VGL_ENABLE_STATIC_BATCHING)
+    /// Static batches.
+    vgl::vector<Batch> m_batches;
+#endif
+
+    /// Grid over all entities for collision checks when placing entities.
+    vgl::UniformGrid m_placement{WORLD_PLACEMENT_CELL_SIZE};
+
+#if defined(VGL_ENABLE_OCCLUSION_CULLING)
+    /// Meshes designated as occluders.
+    vgl::vector<const vgl::Mesh*> m_occluder_meshes;
+
+    /// Scaled bounding boxes of static entities with occluder meshes, built when sorting.
+    vgl::vector<vgl::BoundingBox> m_occluders;
+
+    /// Occlusion buffer for the view being rendered.
+    vgl::OcclusionBuffer m_occlusion;
+
+    /// Entities within the view being rendered, static entities are tested against the occlusion buffer.
+    vgl::vector<const Entity*> m_visible;
+
+    /// Minimum Z coordinate of the view being rendered.
+    float m_occlusion_zmin = 0.0f;
+
+    /// Maximum Z coordinate of the view being rendered.
+    float m_occlusion_zmax = 0.0f;
+#endif
 
 public:
     /// Default constructor.
@@ -332,6 +843,7 @@ public:
             EntityCallback callback = nullptr)
     {
         m_entities.emplace_back(program, mesh, transform, callback);
+        m_placement.insert(m_entities.back().getBoundingBox());
     }
     /// Add a new entity.
     ///
@@ -400,6 +912,7 @@ public:
             EntityCallback callback = nullptr)
     {
         m_entities.emplace_back(program, font, glyph, font_size, pen_pos, text, transform, callback);
+        m_placement.insert(m_entities.back().getBoundingBox());
     }
 
     /// Try to add entity, do not add if it conflicts with bounding box of an existing entity.
@@ -414,77 +927,215 @@ public:
     /// \param rz Z rotation.
     bool tryAddEntity(const vgl::GlslProgram& program, const vgl::Mesh& mesh, const vgl::vec3& pos, float rx, float ry, float rz)
     {
+#if defined(DNLOAD_USE_LD)
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#endif
         vgl::mat4 trns = vgl::mat4::rotation_euler(rx, ry, rz, pos);
         vgl::BoundingBox trns_box = mesh.getBoundingBox().transform(trns);
-        for(auto& vv : m_entities)
+        bool ret = !m_placement.collides(trns_box);
+        if(ret)
         {
-            if(vv.collides(trns_box))
-            {
-                return false;
-            }
+            addEntity(program, mesh, trns);
         }
-        addEntity(program, mesh, trns);
-        return true;
+#if defined(DNLOAD_USE_LD)
+        g_world_statistics.addPlacement(ret, std::chrono::steady_clock::now() - start);
+#endif
+        return ret;
     }
 
+#if defined(VGL_ENABLE_OCCLUSION_CULLING)
+    /// Designate a mesh as an occluder.
+    ///
+    /// Static entities with the mesh hide other static entities behind them. The mesh should be solid and fill most of
+    /// its bounding box. Must be called before sort().
+    ///
+    /// \param op Mesh.
+    void addOccluder(const vgl::Mesh& op)
+    {
+        m_occluder_meshes.push_back(&op);
+    }
+#endif
+
     /// Sort the entities.
     ///
     /// Should be called after everything has been done.
     void sort()
     {
         dnload_qsort(m_entities.data(), m_entities.size(), sizeof(Entity), Entity::qsort_compare);
+
+#if defined(VGL_ENABLE_OCCLUSION_CULLING)
+        m_occluders.clear();
+        for(const auto& entity : m_entities)
+        {
+            if(!entity.isStatic())
+            {
+                continue;
+            }
+            for(const auto& vv : m_occluder_meshes)
+            {
+                if(entity.getMesh() == vv)
+                {
+                    const vgl::BoundingBox& box = entity.getBoundingBox();
+                    vgl::vec3 center = box.getCenter();
+                    vgl::vec3 extent = (box.getMax() - box.getMin()) * (WORLD_OCCLUDER_SCALE * 0.5f);
+                    m_occluders.emplace_back(center - extent, center + extent);
+                    break;
+                }
+            }
+        }
+#endif
     }
 
-    /// Render the world.
+#if defined(VGL_ENABLE_STATIC_BATCHING)
+    /// Merge static entities into batches.
     ///
-    /// Draws all entities from given z coordinate towards the negative.
-    ///
-    /// \param queue Render queue to use.
-    /// \param zmax Maximum Z coordinate - where to start from.
-    /// \param zmin Minimum Z coordinate - where to extend to.
-    /// \param tolerance Tolerance in coordinates to keep looking for.
-    void render(vgl::RenderQueue& queue, float zmax, float zmin, float tolerance)
+    /// Entities drawn with the same program are merged if their centers are within WORLD_BATCH_DEPTH of each other
+    /// on the Z axis. Merged entities are no longer rendered by themselves and do not use levels of detail. Must be
+    /// called after sort(). Does not require the main thread, batches are uploaded with update().
+    void batch()
     {
-        // First, find the center position.
-        unsigned idx = findClosestEntityIndex(zmax);
-
-        // Search towards negative.
-        for(int ii = static_cast<int>(idx); (ii >= 0); --ii)
+        for(auto& vv : m_entities)
         {
-            Entity& entity = m_entities[ii];
+            vv.setBatched(false);
+        }
+        m_batches.clear();
 
-            // Colliding entities are rendered immediately.
-            if(entity.collidesZ(zmin, zmax))
+        vgl::vector<Batch> batches;
+#if defined(DNLOAD_USE_LD)
+        unsigned incompatible_count = 0;
+#endif
+        for(auto& entity : m_entities)
+        {
+            if(!entity.isStatic())
             {
-                entity.render(queue);
                 continue;
             }
 
-            // Otherwise check if we've gone too far.
-            if(entity.getCenter().z() < (zmin - tolerance))
+            bool merged = false;
+            for(unsigned ii = batches.size(); (ii > 0); --ii)
             {
-                break;
+                if(batches[ii - 1].tryAdd(entity))
+                {
+                    merged = true;
+                    break;
+                }
+            }
+            if(!merged)
+            {
+                batches.emplace_back(entity);
+                if(!batches.back().tryAdd(entity))
+                {
+                    batches.pop_back();
+#if defined(DNLOAD_USE_LD)
+                    ++incompatible_count;
+#endif
+                }
             }
         }
-
-        // Search towards positive.
-        for(unsigned ii = idx; (ii < m_entities.size()); ++ii)
+#if defined(DNLOAD_USE_LD)
+        if(incompatible_count)
         {
-            Entity& entity = m_entities[ii];
+            std::cerr << "WARNING: " << incompatible_count <<
+                " static entities can not be batched, quantized meshes can not be merged" << std::endl;
+        }
+#endif
 
-            // Colliding entities are rendered immediately.
-            if(entity.collidesZ(zmin, zmax))
+        // Batches of only one entity would just lose the level of detail.
+        for(auto& vv : batches)
+        {
+            if(vv.getEntityCount() > 1)
             {
-                entity.render(queue);
-                continue;
+                m_batches.push_back(vgl::move(vv));
+            }
+            else
+            {
+                vv.getFirst().setBatched(false);
             }
+        }
+    }
 
-            // Otherwise check if we've gone too far.
-            if(entity.getCenter().z() > (zmax + tolerance))
+    /// Update static batches to the GPU.
+    ///
+    /// Must be called from the main thread after batch().
+    void update()
+    {
+        for(auto& vv : m_batches)
+        {
+            vv.update();
+        }
+    }
+#endif
+
+    /// Render the world.
+    ///
+    /// Draws all entities from given z coordinate towards the negative. Static entities outside the view frustum
+    /// of the current view settings in the queue are culled.
+    ///
+    /// If occlusion culling is enabled, occluders are rasterized in another thread while entities within the view
+    /// frustum are collected, or first if rendering from the main thread. Static entities hidden behind occluders are
+    /// then culled.
+    ///
+    /// \param queue Render queue to use.
+    /// \param zmax Maximum Z coordinate - where to start from.
+    /// \param zmin Minimum Z coordinate - where to extend to.
+    /// \param tolerance Tolerance in coordinates to keep looking for.
+    /// \param pos Camera position.
+    /// \param lod_scale Pixels per unit of length at unit distance.
+    void render(vgl::RenderQueue& queue, float zmax, float zmin, float tolerance, const vgl::vec3& pos,
+            float lod_scale)
+    {
+        vgl::Frustum frustum(queue.getProjectionCameraMatrix());
+
+#if defined(VGL_ENABLE_OCCLUSION_CULLING)
+        m_occlusion.setProjectionCamera(queue.getProjectionCameraMatrix());
+        m_occlusion_zmin = zmin;
+        m_occlusion_zmax = zmax;
+        m_visible.clear();
+
+        auto collect = [this](const Entity& entity)
+        {
+            m_visible.push_back(&entity);
+        };
+        if(vgl::TaskDispatcher::is_main_thread())
+        {
+            // Main thread cannot wait, rasterize occluders before collecting.
+            task_rasterize_occluders(this);
+            findVisibleEntities(zmax, zmin, tolerance, frustum, collect);
+        }
+        else
+        {
+            // Need scope to wait on fences.
+            vgl::Fence fence_occluders = vgl::TaskDispatcher::wait(task_rasterize_occluders, this,
+                    vgl::TaskPriority::HIGH);
+            findVisibleEntities(zmax, zmin, tolerance, frustum, collect);
+        }
+
+        for(const auto& vv : m_visible)
+        {
+            if(vv->isStatic() && m_occlusion.isOccluded(vv->getBoundingBox()))
             {
-                break;
+#if defined(DNLOAD_USE_LD)
+                g_world_statistics.addOccluded();
+#endif
+                continue;
             }
+            vv->render(queue, pos, lod_scale);
         }
+#else
+        findVisibleEntities(zmax, zmin, tolerance, frustum, [&queue, &pos, lod_scale](const Entity& entity)
+                {
+                    entity.render(queue, pos, lod_scale);
+                });
+#endif
+
+#if defined(VGL_ENABLE_STATIC_BATCHING)
+        for(const auto& vv : m_batches)
+        {
+            vv.render(queue, frustum, zmin, zmax);
+        }
+#endif
+
+        queue.flushSorted();
     }
     /// Render the world.
     ///
@@ -495,15 +1146,19 @@ public:
     ///
     /// Rendered objects are selected based on position and z extent search.
     ///
+    /// Level of detail scale is the number of pixels covered by an unit of length at unit distance from the camera,
+    /// i.e. half of viewport width divided by the tangent of half of horizontal field of view.
+    ///
     /// \param queue Render queue to use.
     /// \param pos Camera position.
     /// \param z_extents Z extents to use for rendering.
-    void render(vgl::RenderQueue& queue, const vgl::vec3& pos, const vgl::vec3& z_extents)
+    /// \param lod_scale Level of detail scale.
+    void render(vgl::RenderQueue& queue, const vgl::vec3& pos, const vgl::vec3& z_extents, float lod_scale)
     {
         VGL_ASSERT(z_extents.x() > 0.0f);
         VGL_ASSERT(z_extents.y() < 0.0f);
         VGL_ASSERT(z_extents.z() > 0.0f);
-        render(queue, pos.z() + z_extents.x(), pos.z() + z_extents.y(), z_extents.z());
+        render(queue, pos.z() + z_extents.x(), pos.z() + z_extents.y(), z_extents.z(), pos, lod_scale);
     }
 
 protected:
@@ -511,7 +1166,7 @@ protected:
     ///
     /// \param op Z coordinate value.
     /// \return Index in the entioty array with an entity with closest center position.
-    unsigned findClosestEntityIndex(float op)
+    unsigned findClosestEntityIndex(float op) const
     {
         unsigned lo = 0;
         unsigned hi = m_entities.size() - 1;
@@ -548,6 +1203,100 @@ protected:
 
         return lo;
     }
+
+    /// Find entities to render.
+    ///
+    /// Searches from given z coordinate towards the negative, then towards the positive, in the order entities are
+    /// drawn. Batched entities are skipped, static entities outside the view frustum are culled.
+    ///
+    /// \param zmax Maximum Z coordinate - where to start from.
+    /// \param zmin Minimum Z coordinate - where to extend to.
+    /// \param tolerance Tolerance in coordinates to keep looking for.
+    /// \param frustum View frustum.
+    /// \param func Function called for every visible entity.
+    template<typename F> void findVisibleEntities(float zmax, float zmin, float tolerance, const vgl::Frustum& frustum,
+            F func) const
+    {
+        auto select = [&frustum, &func](const Entity& entity)
+        {
+#if defined(VGL_ENABLE_STATIC_BATCHING)
+            if(entity.isBatched())
+            {
+                return;
+            }
+#endif
+            if(!entity.isVisible(frustum))
+            {
+#if defined(DNLOAD_USE_LD)
+                g_world_statistics.addCulled(1);
+#endif
+                return;
+            }
+            func(entity);
+        };
+
+        // First, find the center position.
+        unsigned idx = findClosestEntityIndex(zmax);
+
+        // Search towards negative.
+        for(int ii = static_cast<int>(idx); (ii >= 0); --ii)
+        {
+            const Entity& entity = m_entities[ii];
+
+            // Colliding entities are selected immediately.
+            if(entity.collidesZ(zmin, zmax))
+            {
+                select(entity);
+                continue;
+            }
+
+            // Otherwise check if we've gone too far.
+            if(entity.getCenter().z() < (zmin - tolerance))
+            {
+                break;
+            }
+        }
+
+        // Search towards positive.
+        for(unsigned ii = idx + 1; (ii < m_entities.size()); ++ii)
+        {
+            const Entity& entity = m_entities[ii];
+
+            // Colliding entities are selected immediately.
+            if(entity.collidesZ(zmin, zmax))
+            {
+                select(entity);
+                continue;
+            }
+
+            // Otherwise check if we've gone too far.
+            if(entity.getCenter().z() > (zmax + tolerance))
+            {
+                break;
+            }
+        }
+    }
+
+#if defined(VGL_ENABLE_OCCLUSION_CULLING)
+private:
+    /// Task for rasterizing occluders within the view being rendered.
+    ///
+    /// \param op World passed as pointer.
+    /// \return nullptr
+    static void* task_rasterize_occluders(void* op)
+    {
+        IntroWorld* world = static_cast<IntroWorld*>(op);
+        world->m_occlusion.clear();
+        for(const auto& vv : world->m_occluders)
+        {
+            if(vv.collidesZ(world->m_occlusion_zmin, world->m_occlusion_zmax))
+            {
+                world->m_occlusion.addOccluder(vv);
+            }
+        }
+        return nullptr;
+    }
+#endif
 };
 
 #endif
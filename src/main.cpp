@@ -2,6 +2,7 @@
 
 #if defined(DNLOAD_USE_LD)
 #include <atomic>
+#include <chrono>
 #include "image_png.hpp"
 #include <boost/algorithm/string.hpp>
 #include <boost/exception/diagnostic_information.hpp>
@@ -188,10 +189,14 @@ static void puts_ptr(void* op)
 #include "vgl/vgl_animation_state.hpp"
 #include "vgl/vgl_font.hpp"
 #include "vgl/vgl_frame_buffer.hpp"
+#include "vgl/vgl_frustum.hpp"
 #include "vgl/vgl_image_2d_gray.hpp"
 #include "vgl/vgl_logical_mesh.hpp"
+#include "vgl/vgl_mesh_compiler.hpp"
+#include "vgl/vgl_occlusion_buffer.hpp"
 #include "vgl/vgl_opus.hpp"
 #include "vgl/vgl_render_queue.hpp"
+#include "vgl/vgl_uniform_grid.hpp"
 
 #if defined(ENABLE_CHARTS) && ENABLE_CHARTS
 #include "vgl/vgl_spline.hpp"
@@ -247,6 +252,9 @@ static const char *usage = ""
 "For Assembly 2022 real wild compo.\n"
 "Release version does not pertain to any size limitations.\n";
 
+/// Benchmark mode global toggle.
+static bool g_flag_benchmark = false;
+
 /// Developer mode global toggle.
 static bool g_flag_developer = false;
 
@@ -262,6 +270,9 @@ static int g_screen_w = SCREEN_W;
 /// Global screen height.
 static int g_screen_h = SCREEN_H;
 
+/// Worker thread count (0: detect from processor count).
+static unsigned g_threads = 0;
+
 #else
 
 /// Developer mode disabled.
@@ -279,6 +290,9 @@ static int g_screen_h = SCREEN_H;
 /// Global screen height.
 #define g_screen_h SCREEN_H
 
+/// Fixed worker thread count, processor count is not queried.
+#define g_threads 3
+
 #endif
 
 //######################################
@@ -838,6 +852,9 @@ static void teardown()
 
 #include "offscreen.vert.glsl.hpp" // g_shader_vertex_offscreen
 #include "offscreen.frag.glsl.hpp" // g_shader_fragment_offscreen
+#if defined(VGL_ENABLE_INSTANCING)
+#include "offscreen_instanced.vert.glsl.hpp" // g_shader_vertex_offscreen_instanced
+#endif
 
 #include "skeleton.vert.glsl.hpp" // g_shader_vertex_skeleton
 #include "skeleton.frag.glsl.hpp" // g_shader_fragment_skeleton
@@ -850,6 +867,9 @@ static void teardown()
 
 #include "intro_data.hpp"
 #include "intro_state.hpp"
+#if defined(DNLOAD_USE_LD)
+#include "intro_benchmark.hpp"
+#endif
 
 /// \cond
 static void* intro_state_move(void*);
@@ -893,9 +913,12 @@ static void* intro_state_generate(void* op)
 
     // Need scope to wait on fences.
     {
-        vgl::Fence fence_next = vgl::TaskDispatcher::wait(intro_state_generate_next, &frame_number);
-        vgl::Fence fence_fft = vgl::TaskDispatcher::wait(intro_state_generate_mesh_fft, &frame_number);
-        vgl::Fence fence_wave = vgl::TaskDispatcher::wait(intro_state_generate_mesh_wave, &frame_number);
+        vgl::Fence fence_next = vgl::TaskDispatcher::wait(intro_state_generate_next, &frame_number,
+                vgl::TaskPriority::HIGH);
+        vgl::Fence fence_fft = vgl::TaskDispatcher::wait(intro_state_generate_mesh_fft, &frame_number,
+                vgl::TaskPriority::HIGH);
+        vgl::Fence fence_wave = vgl::TaskDispatcher::wait(intro_state_generate_mesh_wave, &frame_number,
+                vgl::TaskPriority::HIGH);
     }
 
     // Dispatch swap task.
@@ -922,7 +945,9 @@ static void* intro_state_move(void* op)
     vgl::TaskDispatcher::dispatch_main(intro_state_draw, nullptr);
 
     // Advance time based on time delta, then generate new frame.
-    vgl::TaskDispatcher::dispatch(intro_state_generate, advance_frame_number(op));
+    // Generation must complete within one frame to avoid skipping.
+    vgl::TaskDispatcher::dispatch(intro_state_generate, advance_frame_number(op), vgl::TaskPriority::HIGH,
+            FRAME_MILLISECONDS * 1000);
 
     return nullptr;
 }
@@ -1051,7 +1076,18 @@ void _start()
         "\nExtensions:  " << vgl::gl_extension_string(79, 13) << std::endl;
 #endif
 
-    vgl::TaskDispatcher::initialize(3);
+#if defined(DNLOAD_USE_LD)
+    vgl::TaskDispatcher::set_task_name(advance_frame_number, "advance_frame_number");
+    vgl::TaskDispatcher::set_task_name(intro_state_draw, "intro_state_draw");
+    vgl::TaskDispatcher::set_task_name(intro_state_generate, "intro_state_generate");
+    vgl::TaskDispatcher::set_task_name(intro_state_generate_mesh_fft, "intro_state_generate_mesh_fft");
+    vgl::TaskDispatcher::set_task_name(intro_state_generate_mesh_wave, "intro_state_generate_mesh_wave");
+    vgl::TaskDispatcher::set_task_name(intro_state_generate_next, "intro_state_generate_next");
+    vgl::TaskDispatcher::set_task_name(intro_state_move, "intro_state_move");
+    vgl::TaskDispatcher::set_task_name(IntroData::task_initialize, "IntroData::task_initialize");
+#endif
+
+    vgl::TaskDispatcher::initialize(g_threads);
 
     vgl::FrameBuffer::initialize_default(static_cast<unsigned>(g_screen_w), static_cast<unsigned>(g_screen_h));
     vgl::TaskDispatcher::dispatch(IntroData::task_initialize, &g_data);
@@ -1066,10 +1102,14 @@ void _start()
     }
 
 #if defined(DNLOAD_USE_LD)
-    std::cout << "Vertex data:   " << human_readable_memory(vgl::get_data_size_vertex()) <<  " in " <<
-        vgl::get_num_geometry_buffers() << " buffers\nIndex data:    " <<
+    std::cout << "Vertex data:   " << human_readable_memory(vgl::get_data_size_vertex()) <<
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+        " (" << human_readable_memory(vgl::get_data_size_vertex_unquantized()) << " unquantized)" <<
+#endif
+        " in " << vgl::get_num_geometry_buffers() << " buffers\nIndex data:    " <<
         human_readable_memory(vgl::get_data_size_index()) << "\nTexture data:  " <<
-        human_readable_memory(vgl::get_data_size_texture()) << std::endl;
+        human_readable_memory(vgl::get_data_size_texture()) << "\nBuffer upload: " <<
+        human_readable_memory(vgl::get_data_size_buffer_upload()) << std::endl;
 #endif
 
 #if defined(DNLOAD_USE_LD)
@@ -1082,6 +1122,7 @@ void _start()
 
         if(g_flag_record_video)
         {
+            IntroState state;
             for(int frame_idx = 0; (frame_idx < INTRO_LENGTH); ++frame_idx)
             {
                 SDL_Event event;
@@ -1090,7 +1131,6 @@ void _start()
                     break;
                 }
 
-                IntroState state;
                 state.initialize(frame_idx);
                 intro_state_generate_mesh_fft(&frame_idx);
                 intro_state_generate_mesh_wave(&frame_idx);
@@ -1113,9 +1153,10 @@ void _start()
     // Start draw loop.
 #if defined(DNLOAD_USE_LD)
     g_time_delta = static_cast<int>(!g_flag_developer);
-    vgl::TaskDispatcher::dispatch(intro_state_generate, &g_frame_number);
+    vgl::TaskDispatcher::dispatch(intro_state_generate, &g_frame_number, vgl::TaskPriority::HIGH);
 #else
-    vgl::TaskDispatcher::dispatch(intro_state_generate, reinterpret_cast<void*>(static_cast<size_t>(INTRO_START)));
+    vgl::TaskDispatcher::dispatch(intro_state_generate, reinterpret_cast<void*>(static_cast<size_t>(INTRO_START)),
+            vgl::TaskPriority::HIGH);
 #endif
 
     // Open audio device.
@@ -1298,6 +1339,9 @@ void _start()
                             std::endl;
                     }
                     std::cout << "ticks: " << g_frame_number.getFrameIdx() << std::endl;
+                    std::cout << g_world_statistics.getLastFrame() << std::endl;
+                    std::cout << g_world_statistics.getLastDraw() << std::endl;
+                    std::cout << g_world_statistics.getLastUniforms() << std::endl;
                     break;
 
                 case SDLK_COMMA:
@@ -1587,17 +1631,25 @@ int DNLOAD_MAIN(int argc, char **argv)
         {
             po::options_description desc("Options");
             desc.add_options()
+                ("benchmark", "Run developer benchmarks instead of the intro.")
                 ("camera,c", po::value<std::string>(), "Sets default camera location at intro start, 9 floating point values")
                 ("developer,d", "Developer mode.")
                 ("fullscreen,f", "Start in fullscreen as opposed to windowed mode.")
                 ("help,h", "Print help text.")
                 ("mesh,m", po::value<std::string>(), "Specify a mesh preview to view. Implies developer mode.")
+                ("mesh-cache", po::value<std::string>(), "Load compiled meshes from a cache file, and store meshes not found in it.")
+                ("pin-threads", "Pin worker threads to processors other than the one running the main thread.")
                 ("record-audio", "Do not play intro normally. Record audio as .raw -file.")
                 ("record-video", "Do not play intro normally. Record video as .png -files.")
                 ("record,R", "Do not play intro normally, instead record audio and video as files.")
                 ("resolution,r", po::value<std::string>(), "Resolution to use, specify as 'WIDTHxHEIGHT' or 'HEIGHTp'.")
                 ("seed,s", po::value<unsigned>(), "RNG seed, used when iterating generation settings.")
+                ("thread-priority", po::value<int>(), "Worker thread priority, negative for low, positive for high.")
+                ("thread-stack-size", po::value<unsigned>(), "Worker thread stack size in kilobytes.")
+                ("threads,j", po::value<unsigned>(), "Worker thread count (default: processor count minus one).")
                 ("ticks,t", po::value<int>(), "Timestamp to start from in frames.")
+                ("trace", po::value<std::string>(), "Write a Chrome trace event file of task execution, viewable in Perfetto.")
+                ("verbose,v", "Print statistics of every compiled mesh at exit.")
                 ("vsync,y", "Enable vertical retrace synchronization.")
                 ("window,w", "Start in windowed mode as opposed to fullscreen.");
 
@@ -1605,6 +1657,10 @@ int DNLOAD_MAIN(int argc, char **argv)
             po::store(po::command_line_parser(argc, argv).options(desc).run(), vmap);
             po::notify(vmap);
 
+            if(vmap.count("benchmark"))
+            {
+                g_flag_benchmark = true;
+            }
             if(vmap.count("camera"))
             {
                 std::vector<std::string> values;
@@ -1648,6 +1704,10 @@ int DNLOAD_MAIN(int argc, char **argv)
             {
                 g_preview_mesh = vgl::string(vmap["mesh"].as<std::string>().c_str());
             }
+            if(vmap.count("mesh-cache"))
+            {
+                vgl::MeshCache::enable(vmap["mesh-cache"].as<std::string>().c_str());
+            }
             if(vmap.count("record"))
             {
                 g_flag_record_audio = true;
@@ -1661,12 +1721,42 @@ int DNLOAD_MAIN(int argc, char **argv)
             {
                 g_flag_record_video = true;
             }
+            if(vmap.count("pin-threads"))
+            {
+                vgl::TaskDispatcher::set_worker_affinity(true);
+            }
             if(vmap.count("resolution"))
             {
                 std::pair<unsigned, unsigned> resolution = parse_resolution(vmap["resolution"].as<std::string>());
                 g_screen_w = static_cast<int>(resolution.first);
                 g_screen_h = static_cast<int>(resolution.second);
             }
+            if(vmap.count("thread-priority"))
+            {
+                vgl::TaskDispatcher::set_worker_priority(vmap["thread-priority"].as<int>());
+            }
+            if(vmap.count("thread-stack-size"))
+            {
+                vgl::TaskDispatcher::set_worker_stack_size(vmap["thread-stack-size"].as<unsigned>() * 1024u);
+            }
+            if(vmap.count("threads"))
+            {
+                g_threads = vmap["threads"].as<unsigned>();
+                if(g_threads <= 0)
+                {
+                    BOOST_THROW_EXCEPTION(std::runtime_error("thread count must be positive"));
+                }
+            }
+            if(vmap.count("trace"))
+            {
+                vgl::TaskDispatcher::enable_trace(vmap["trace"].as<std::string>().c_str());
+            }
+            if(vmap.count("verbose"))
+            {
+#if defined(VGL_ENABLE_VERTEX_CACHE_OPTIMIZATION)
+                vgl::MeshData::set_vertex_cache_report_verbose(true);
+#endif
+            }
             if(vmap.count("vsync"))
             {
                 option_vsync = true;
@@ -1677,6 +1767,18 @@ int DNLOAD_MAIN(int argc, char **argv)
             }
         }
 
+        // Default to one worker thread per processor not running the main thread.
+        if(!g_threads)
+        {
+            g_threads = vgl::TaskDispatcher::get_default_concurrency();
+        }
+
+        if(g_flag_benchmark)
+        {
+            intro_benchmark(g_threads);
+            return 0;
+        }
+
         // Enable developer mode if model view mode is on.
         if(!g_preview_mesh.empty())
         {
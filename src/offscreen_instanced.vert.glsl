@@ -0,0 +1,17 @@
+attribute vec3 position;
+attribute vec3 normal;
+attribute mat4 instance_transform;
+
+uniform mat4 projection_camera_transform;
+uniform vec3 camera_position;
+
+varying vec3 nor;
+varying vec3 cpos_minus_rpos;
+
+void main()
+{
+    vec4 world_position = instance_transform * vec4(position, 1.0);
+    nor = (instance_transform * vec4(normal, 0.0)).xyz;
+    cpos_minus_rpos = camera_position - world_position.xyz;
+    gl_Position = projection_camera_transform * world_position;
+}
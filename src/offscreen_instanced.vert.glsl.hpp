@@ -0,0 +1,63 @@
+#ifndef __g_shader_vertex_offscreen_instanced_header__
+#define __g_shader_vertex_offscreen_instanced_header__
+static const char *g_shader_vertex_offscreen_instanced = ""
+#if defined(DNLOAD_USE_LD)
+"offscreen_instanced.vert.glsl"
+#else
+"attribute vec3 r;"
+"attribute vec3 o;"
+"attribute mat4 s;"
+"uniform mat4 g;"
+"uniform vec3 m;"
+"varying vec3 e;"
+"varying vec3 a;"
+"void main()"
+"{"
+"vec4 l=s*vec4(r,1);"
+"e=(s*vec4(o,0)).rgb,a=m-l.rgb,gl_Position=g*l;"
+"}"
+#endif
+"";
+#if !defined(DNLOAD_RENAME_UNUSED)
+#if defined(__GNUC__)
+#define DNLOAD_RENAME_UNUSED __attribute__((unused))
+#else
+#define DNLOAD_RENAME_UNUSED
+#endif
+#endif
+static const char* g_shader_vertex_offscreen_instanced_attribute_position DNLOAD_RENAME_UNUSED = ""
+#if defined(DNLOAD_USE_LD)
+"position"
+#else
+"r"
+#endif
+"";
+static const char* g_shader_vertex_offscreen_instanced_attribute_normal DNLOAD_RENAME_UNUSED = ""
+#if defined(DNLOAD_USE_LD)
+"normal"
+#else
+"o"
+#endif
+"";
+static const char* g_shader_vertex_offscreen_instanced_attribute_instance_transform DNLOAD_RENAME_UNUSED = ""
+#if defined(DNLOAD_USE_LD)
+"instance_transform"
+#else
+"s"
+#endif
+"";
+static const char* g_shader_vertex_offscreen_instanced_uniform_projection_camera_transform DNLOAD_RENAME_UNUSED = ""
+#if defined(DNLOAD_USE_LD)
+"projection_camera_transform"
+#else
+"g"
+#endif
+"";
+static const char* g_shader_vertex_offscreen_instanced_uniform_camera_position DNLOAD_RENAME_UNUSED = ""
+#if defined(DNLOAD_USE_LD)
+"camera_position"
+#else
+"m"
+#endif
+"";
+#endif
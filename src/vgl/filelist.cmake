@@ -10,6 +10,7 @@ set(VGL_HEADERS
     "${VGL_ROOT}/vgl_armature.hpp"
     "${VGL_ROOT}/vgl_array.hpp"
     "${VGL_ROOT}/vgl_assert.hpp"
+    "${VGL_ROOT}/vgl_atomic.hpp"
     "${VGL_ROOT}/vgl_bitset.hpp"
     "${VGL_ROOT}/vgl_bone.hpp"
     "${VGL_ROOT}/vgl_bone_state.hpp"
@@ -18,10 +19,12 @@ set(VGL_HEADERS
     "${VGL_ROOT}/vgl_character.hpp"
     "${VGL_ROOT}/vgl_cond.hpp"
     "${VGL_ROOT}/vgl_csg_file.hpp"
+    "${VGL_ROOT}/vgl_csg_primitive_cache.hpp"
     "${VGL_ROOT}/vgl_cstddef.hpp"
     "${VGL_ROOT}/vgl_extern_freetype.hpp"
     "${VGL_ROOT}/vgl_extern_math.hpp"
     "${VGL_ROOT}/vgl_extern_opengl.hpp"
+    "${VGL_ROOT}/vgl_extern_pthread.hpp"
     "${VGL_ROOT}/vgl_extern_sdl.hpp"
     "${VGL_ROOT}/vgl_extern_stdlib.hpp"
     "${VGL_ROOT}/vgl_fence.hpp"
@@ -29,6 +32,8 @@ set(VGL_HEADERS
     "${VGL_ROOT}/vgl_filesystem.hpp"
     "${VGL_ROOT}/vgl_font.hpp"
     "${VGL_ROOT}/vgl_frame_buffer.hpp"
+    "${VGL_ROOT}/vgl_frustum.hpp"
+    "${VGL_ROOT}/vgl_futex.hpp"
     "${VGL_ROOT}/vgl_geometry_buffer.hpp"
     "${VGL_ROOT}/vgl_geometry_channel.hpp"
     "${VGL_ROOT}/vgl_geometry_handle.hpp"
@@ -41,6 +46,7 @@ set(VGL_HEADERS
     "${VGL_ROOT}/vgl_image_2d_rgb.hpp"
     "${VGL_ROOT}/vgl_image_2d_rgba.hpp"
     "${VGL_ROOT}/vgl_index_block.hpp"
+    "${VGL_ROOT}/vgl_index_type.hpp"
     "${VGL_ROOT}/vgl_ivec3.hpp"
     "${VGL_ROOT}/vgl_limits.hpp"
     "${VGL_ROOT}/vgl_logical_face.hpp"
@@ -52,14 +58,19 @@ set(VGL_HEADERS
     "${VGL_ROOT}/vgl_mat4.hpp"
     "${VGL_ROOT}/vgl_math.hpp"
     "${VGL_ROOT}/vgl_mesh.hpp"
+    "${VGL_ROOT}/vgl_mesh_cache.hpp"
+    "${VGL_ROOT}/vgl_mesh_compiler.hpp"
     "${VGL_ROOT}/vgl_mesh_data.hpp"
+    "${VGL_ROOT}/vgl_mesh_simplifier.hpp"
     "${VGL_ROOT}/vgl_mutex.hpp"
+    "${VGL_ROOT}/vgl_occlusion_buffer.hpp"
     "${VGL_ROOT}/vgl_optional.hpp"
     "${VGL_ROOT}/vgl_opus.hpp"
     "${VGL_ROOT}/vgl_packed_data.hpp"
     "${VGL_ROOT}/vgl_packed_data_reader.hpp"
     "${VGL_ROOT}/vgl_quat.hpp"
     "${VGL_ROOT}/vgl_queue.hpp"
+    "${VGL_ROOT}/vgl_radix_sort.hpp"
     "${VGL_ROOT}/vgl_rand.hpp"
     "${VGL_ROOT}/vgl_realloc.hpp"
     "${VGL_ROOT}/vgl_render_queue.hpp"
@@ -70,6 +81,7 @@ set(VGL_HEADERS
     "${VGL_ROOT}/vgl_task.hpp"
     "${VGL_ROOT}/vgl_task_dispatcher.hpp"
     "${VGL_ROOT}/vgl_task_queue.hpp"
+    "${VGL_ROOT}/vgl_task_tracer.hpp"
     "${VGL_ROOT}/vgl_texture.hpp"
     "${VGL_ROOT}/vgl_texture_2d.hpp"
     "${VGL_ROOT}/vgl_texture_3d.hpp"
@@ -78,6 +90,7 @@ set(VGL_HEADERS
     "${VGL_ROOT}/vgl_thread.hpp"
     "${VGL_ROOT}/vgl_throw_exception.hpp"
     "${VGL_ROOT}/vgl_type_traits.hpp"
+    "${VGL_ROOT}/vgl_uniform_grid.hpp"
     "${VGL_ROOT}/vgl_unique_ptr.hpp"
     "${VGL_ROOT}/vgl_uvec4.hpp"
     "${VGL_ROOT}/vgl_vec.hpp"
@@ -85,6 +98,7 @@ set(VGL_HEADERS
     "${VGL_ROOT}/vgl_vec3.hpp"
     "${VGL_ROOT}/vgl_vec4.hpp"
     "${VGL_ROOT}/vgl_vector.hpp"
+    "${VGL_ROOT}/vgl_vertex_cache_optimizer.hpp"
     "${VGL_ROOT}/vgl_wave.hpp")
 set(VGL_SOURCES
     "${VGL_ROOT}/vgl_buffer.cpp"
@@ -97,6 +111,7 @@ set(VGL_SOURCES
     "${VGL_ROOT}/vgl_glsl_shader.cpp"
     "${VGL_ROOT}/vgl_logical_mesh.cpp"
     "${VGL_ROOT}/vgl_mesh.cpp"
+    "${VGL_ROOT}/vgl_mesh_cache.cpp"
     "${VGL_ROOT}/vgl_rand.cpp"
     "${VGL_ROOT}/vgl_realloc.cpp"
     "${VGL_ROOT}/vgl_state.cpp"
@@ -0,0 +1,30 @@
+#ifndef VGL_ATOMIC_HPP
+#define VGL_ATOMIC_HPP
+
+#include "vgl_config.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+namespace vgl
+{
+
+using std::atomic;
+using std::memory_order_acq_rel;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+
+/// Hint the processor that the calling thread is spinning.
+inline void cpu_relax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+}
+
+#endif
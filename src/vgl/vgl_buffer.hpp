@@ -2,7 +2,9 @@
 #define VGL_BUFFER_HPP
 
 #include "vgl_extern_opengl.hpp"
+#include "vgl_index_type.hpp"
 #include "vgl_packed_data.hpp"
+#include "vgl_state.hpp"
 
 namespace vgl
 {
@@ -17,6 +19,14 @@ private:
     /// Currently active VAO.
     GLuint m_vao = 0;
 
+#if defined(VGL_USE_LD)
+    /// Number of bind requests.
+    unsigned m_bind_count = 0;
+
+    /// Number of actual VAO switches.
+    unsigned m_switch_count = 0;
+#endif
+
 public:
     /// Global state.
     static OpenGlVertexArrayObjectState g_opengl_vertex_array_object_state;
@@ -27,10 +37,16 @@ public:
     /// \param op Vertex array object ID.
     void bind(GLuint op)
     {
+#if defined(VGL_USE_LD)
+        ++m_bind_count;
+#endif
         if(m_vao != op)
         {
             dnload_glBindVertexArray(op);
             m_vao = op;
+#if defined(VGL_USE_LD)
+            ++m_switch_count;
+#endif
         }
     }
 
@@ -53,11 +69,47 @@ public:
     {
         return m_vao;
     }
+
+    /// Accessor.
+    ///
+    /// \return Number of bind requests so far.
+    unsigned getBindCount() const
+    {
+        return m_bind_count;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Number of actual VAO switches so far.
+    unsigned getSwitchCount() const
+    {
+        return m_switch_count;
+    }
 #endif
 };
 
 }
 
+#if defined(VGL_USE_LD)
+
+/// Accessor.
+///
+/// \return Number of vertex array object bind requests so far.
+inline unsigned get_vertex_array_object_binds()
+{
+    return detail::OpenGlVertexArrayObjectState::g_opengl_vertex_array_object_state.getBindCount();
+}
+
+/// Accessor.
+///
+/// \return Number of actual vertex array object switches so far.
+inline unsigned get_vertex_array_object_switches()
+{
+    return detail::OpenGlVertexArrayObjectState::g_opengl_vertex_array_object_state.getSwitchCount();
+}
+
+#endif
+
 /// Represents a GL array/element buffer
 template<GLenum BufferType> class Buffer
 {
@@ -98,6 +150,12 @@ private:
         detail::OpenGlVertexArrayObjectState::g_opengl_vertex_array_object_state.bind(0);
         bind();
         dnload_glBufferData(BufferType, count, ptr, GL_STATIC_DRAW);
+#if defined(VGL_USE_LD)
+        if(ptr)
+        {
+            increment_data_size_buffer_upload(count);
+        }
+#endif
     }
 
     /// Update sub-data to GPU.
@@ -110,6 +168,9 @@ private:
         detail::OpenGlVertexArrayObjectState::g_opengl_vertex_array_object_state.bind(0);
         bind();
         dnload_glBufferSubData(BufferType, offset, count, ptr);
+#if defined(VGL_USE_LD)
+        increment_data_size_buffer_upload(count);
+#endif
     }
 
 public:
@@ -131,6 +192,32 @@ public:
         dnload_glBindBuffer(BufferType, m_id);
     }
 
+    /// Allocate storage without uploading anything.
+    ///
+    /// Previous contents are lost.
+    ///
+    /// \param op Storage size in bytes.
+    void allocate(unsigned op) const
+    {
+        update(nullptr, op);
+    }
+
+    /// Replace contents with data that is drawn once.
+    ///
+    /// Storage is reallocated for each update, so the driver does not need to wait for draws using previous contents.
+    ///
+    /// \param ptr Pointer to data to update.
+    /// \param count Number of bytes to update.
+    void stream(const void* ptr, unsigned count) const
+    {
+        detail::OpenGlVertexArrayObjectState::g_opengl_vertex_array_object_state.bind(0);
+        bind();
+        dnload_glBufferData(BufferType, count, ptr, GL_STREAM_DRAW);
+#if defined(VGL_USE_LD)
+        increment_data_size_buffer_upload(count);
+#endif
+    }
+
     /// Update data to GPU.
     ///
     /// \param op Data to update.
@@ -146,11 +233,21 @@ public:
     {
         update(data.data(), data.size(), offset);
     }
+    /// Update data past given offset to GPU.
+    ///
+    /// Data before the offset is expected to already be in the buffer.
+    ///
+    /// \param data Data to update.
+    /// \param offset Offset to update from.
+    void updateTail(const PackedData& data, unsigned offset) const
+    {
+        update(static_cast<const uint8_t*>(data.data()) + offset, data.size() - offset, offset);
+    }
 
     /// Update data to GPU.
     ///
     /// \param op Data to update.
-    void update(const vector<uint16_t>& op) const
+    void update(const vector<index_type>& op) const
     {
         update(op.data(), op.getSizeBytes());
     }
@@ -158,10 +255,20 @@ public:
     ///
     /// \param data Data to update.
     /// \param offset Offset to update into.
-    void update(const vector<uint16_t>& data, unsigned offset) const
+    void update(const vector<index_type>& data, unsigned offset) const
     {
         update(data.data(), data.getSizeBytes(), offset);
     }
+    /// Update data past given offset to GPU.
+    ///
+    /// Data before the offset is expected to already be in the buffer.
+    ///
+    /// \param data Data to update.
+    /// \param offset Offset to update from in bytes.
+    void updateTail(const vector<index_type>& data, unsigned offset) const
+    {
+        update(reinterpret_cast<const uint8_t*>(data.data()) + offset, data.getSizeBytes() - offset, offset);
+    }
 };
 
 /// Specialization of Buffer.
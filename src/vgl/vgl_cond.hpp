@@ -14,6 +14,8 @@ public:
     using cond_type =
 #if defined(VGL_ENABLE_GTK)
         GCond
+#elif defined(VGL_ENABLE_PTHREAD)
+        detail::FutexCond
 #else
         SDL_cond
 #endif
@@ -32,7 +34,7 @@ private:
 public:
     /// Constructor.
     explicit Cond() :
-#if defined(VGL_ENABLE_GTK)
+#if defined(VGL_ENABLE_GTK) || defined(VGL_ENABLE_PTHREAD)
         m_cond(new cond_type)
 #else
         m_cond(dnload_SDL_CreateCond())
@@ -40,7 +42,7 @@ public:
     {
 #if defined(VGL_ENABLE_GTK)
         dnload_g_cond_init(m_cond);
-#elif defined(VGL_USE_LD) && defined(DEBUG)
+#elif !defined(VGL_ENABLE_PTHREAD) && defined(VGL_USE_LD) && defined(DEBUG)
         if(!m_cond)
         {
             VGL_THROW_RUNTIME_ERROR(string("Cond::Cond(): ") + SDL_GetError());
@@ -87,6 +89,8 @@ public:
     {
 #if defined(VGL_ENABLE_GTK)
         dnload_g_cond_broadcast(m_cond);
+#elif defined(VGL_ENABLE_PTHREAD)
+        m_cond->broadcast();
 #else
         int err = dnload_SDL_CondBroadcast(m_cond);
 #if defined(VGL_USE_LD) && defined(DEBUG)
@@ -105,6 +109,8 @@ public:
     {
 #if defined(VGL_ENABLE_GTK)
         dnload_g_cond_broadcast(m_cond);
+#elif defined(VGL_ENABLE_PTHREAD)
+        m_cond->signal();
 #else
         int err = dnload_SDL_CondSignal(m_cond);
 #if defined(VGL_USE_LD) && defined(DEBUG)
@@ -142,6 +148,8 @@ private:
 #if defined(VGL_ENABLE_GTK)
             dnload_g_cond_clear(m_cond);
             delete m_cond;
+#elif defined(VGL_ENABLE_PTHREAD)
+            delete m_cond;
 #else
             dnload_SDL_DestroyCond(m_cond);
 #endif
@@ -156,6 +164,8 @@ private:
     {
 #if defined(VGL_ENABLE_GTK)
         dnload_g_cond_wait(m_cond, mutex);
+#elif defined(VGL_ENABLE_PTHREAD)
+        m_cond->wait(*mutex);
 #else
         int err = dnload_SDL_CondWait(m_cond, mutex);
 #if defined(VGL_USE_LD) && defined(DEBUG)
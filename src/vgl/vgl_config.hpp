@@ -42,15 +42,80 @@
 ///
 ///   Disable support for stencil buffer. Decreases code footprint.
 ///
+/// - VGL_ENABLE_32BIT_INDICES
+///
+///   Use 32-bit vertex indices. Geometry buffers may then hold up to VGL_GEOMETRY_BUFFER_VERTICES vertices instead of
+///   65535, so fewer buffers and vertex array objects are needed. Increases index memory usage. Requires OpenGL ES 3.0
+///   or OES_element_index_uint.
+///
 /// - VGL_ENABLE_GTK
 ///
 ///   Enable support for GTK, mainly for implementing concurrency primitives. If not set, SDL is used instead.
 ///
+/// - VGL_ENABLE_INSTANCING
+///
+///   Replace consecutive draws of the same mesh within sorted sections of render queues with one instanced draw, if
+///   the program has an instanced variant. Only has effect with VGL_ENABLE_SORTED_RENDER_QUEUE. Increases code
+///   footprint but may increase performance due to fewer draw calls. Requires OpenGL ES 3.0 or OpenGL 3.3.
+///
+/// - VGL_ENABLE_MESH_LOD
+///
+///   Enable generating simplified levels of detail for meshes compiled with level of detail generation requested.
+///   Increases code footprint, mesh compilation time and memory usage but may increase rendering performance.
+///
+/// - VGL_ENABLE_OCCLUSION_CULLING
+///
+///   Enable culling world geometry hidden behind designated occluders, using a low-resolution depth buffer rasterized
+///   on the CPU. Increases code footprint and CPU time per frame but may increase performance due to fewer draws,
+///   especially on software renderers.
+///
+/// - VGL_ENABLE_PTHREAD
+///
+///   Implement concurrency primitives natively using POSIX threads and futexes instead of SDL. Mutexes spin
+///   adaptively before sleeping, avoiding system calls on short critical sections. Linux only. Increases code
+///   footprint.
+///
+/// - VGL_ENABLE_SORTED_RENDER_QUEUE
+///
+///   Reorder draws pushed into sorted sections of render queues by program, geometry buffer and depth. Increases code
+///   footprint but may increase performance due to fewer state changes.
+///
+/// - VGL_ENABLE_STATIC_BATCHING
+///
+///   Enable appending meshes into each other with a transform applied, for merging static geometry drawn with the
+///   same program into one draw. Only meshes with unquantized float positions and normals can be merged, so with
+///   VGL_ENABLE_VERTEX_QUANTIZATION meshes compiled with quantization requested are never batched. Merged meshes are
+///   always drawn at full detail, levels of detail from VGL_ENABLE_MESH_LOD are not used for them. Increases code
+///   footprint, startup time and memory usage but may increase performance due to fewer draw calls.
+///
+/// - VGL_ENABLE_UNIFORM_CACHE
+///
+///   Keep a shadow copy of the matrix and camera uniforms applied for each mesh, and skip uniform calls when the
+///   value is unchanged. View uniforms are applied into each program only once per view. Increases code footprint
+///   but may increase performance, especially on software renderers.
+///
+/// - VGL_ENABLE_VERTEX_CACHE_OPTIMIZATION
+///
+///   Reorder triangles and vertices of compiled meshes for post-transform vertex cache and vertex fetch locality.
+///   Increases code footprint and mesh compilation time but may increase rendering performance. Non-minified builds
+///   report ACMR and ATVR before and after optimization over all meshes at exit, and for each mesh with --verbose.
+///
 /// - VGL_ENABLE_VERTEX_NORMAL_PACKING
 ///
 ///   Pack vertex normals into normalized short integers. Increases code footprint but may increase performance due to
 ///   reduced memory usage. May also decrease performance due to vertex attribute misalignment on some platforms.
 ///
+/// - VGL_ENABLE_VERTEX_QUANTIZATION
+///
+///   Enable quantizing vertex positions of meshes compiled with quantization requested into 16-bit integers and
+///   normals into 10-bit integers. Quantized meshes can not be merged by VGL_ENABLE_STATIC_BATCHING. Increases code
+///   footprint but may increase rendering performance due to reduced vertex bandwidth and memory usage. Non-minified
+///   builds report vertex data size before quantization.
+///
+/// - VGL_GEOMETRY_BUFFER_VERTICES
+///
+///   Maximum number of vertices in one geometry buffer when using 32-bit indices. Default: 1048576.
+///
 /// - VGL_USE_BONE_STATE_FULL_TRANSFORM
 ///
 ///   Interpolate complete transformation matrices and renormalize them after interpolation as opposed to
@@ -72,11 +137,20 @@
 #define VGL_USE_GLES DNLOAD_USE_GLES
 #endif
 
+#if defined(VGL_ENABLE_GTK) && defined(VGL_ENABLE_PTHREAD)
+#error "VGL_ENABLE_GTK and VGL_ENABLE_PTHREAD are mutually exclusive"
+#endif
+
 #if !defined(VGL_DISABLE_EDGE)
 /// Edge buffers are not currently supported.
 #define VGL_DISABLE_EDGE
 #endif
 
+#if defined(VGL_ENABLE_32BIT_INDICES) && !defined(VGL_GEOMETRY_BUFFER_VERTICES)
+/// Default maximum number of vertices in one geometry buffer.
+#define VGL_GEOMETRY_BUFFER_VERTICES 1048576u
+#endif
+
 /// Declarator for functions that allow returning iterators.
 ///
 /// Must be inserted into class public scope.
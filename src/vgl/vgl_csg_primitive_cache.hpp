@@ -0,0 +1,414 @@
+#ifndef VGL_CSG_PRIMITIVE_CACHE_HPP
+#define VGL_CSG_PRIMITIVE_CACHE_HPP
+
+#include "vgl_array.hpp"
+#include "vgl_atomic.hpp"
+#include "vgl_vec2.hpp"
+#include "vgl_vector.hpp"
+
+#if defined(VGL_USE_LD)
+#include <iostream>
+#endif
+
+namespace vgl
+{
+
+namespace detail
+{
+
+/// CSG primitive type.
+enum class CsgPrimitiveType
+{
+    /// Cone (or cylinder).
+    CONE,
+
+    /// Pipe.
+    PIPE,
+};
+
+/// Face template of a CSG primitive.
+///
+/// Indices are relative to the first vertex of the primitive.
+class CsgPrimitiveFace
+{
+private:
+    /// Corner indices.
+    array<unsigned, 4> m_indices;
+
+    /// Corner count.
+    unsigned m_num_corners;
+
+public:
+    /// Constructor.
+    ///
+    /// \param c1 First corner index.
+    /// \param c2 Second corner index.
+    /// \param c3 Third corner index.
+    constexpr explicit CsgPrimitiveFace(unsigned c1, unsigned c2, unsigned c3) noexcept :
+        m_indices{c1, c2, c3, 0u},
+        m_num_corners(3)
+    {
+    }
+
+    /// Constructor.
+    ///
+    /// \param c1 First corner index.
+    /// \param c2 Second corner index.
+    /// \param c3 Third corner index.
+    /// \param c4 Fourth corner index.
+    constexpr explicit CsgPrimitiveFace(unsigned c1, unsigned c2, unsigned c3, unsigned c4) noexcept :
+        m_indices{c1, c2, c3, c4},
+        m_num_corners(4)
+    {
+    }
+
+public:
+    /// Accessor.
+    ///
+    /// \param idx Corner index.
+    /// \return Relative vertex index at corner.
+    constexpr unsigned getIndex(unsigned idx) const noexcept
+    {
+        return m_indices[idx];
+    }
+
+    /// Tell if the face is a quad.
+    ///
+    /// \return True if quad, false if triangle.
+    constexpr bool isQuad() const noexcept
+    {
+        return (m_num_corners >= 4);
+    }
+};
+
+/// Cached CSG primitive.
+///
+/// Contains the unit circle directions of the ring vertices and the face topology of a primitive. Both depend only on
+/// the primitive type, fidelity, segment count and capping, not on the transform or radius.
+class CsgPrimitive
+{
+private:
+    /// Ring vertex directions, cosine and sine.
+    vector<vec2> m_ring;
+
+    /// Face templates in the order they are added.
+    vector<CsgPrimitiveFace> m_faces;
+
+    /// Next primitive in cache.
+    CsgPrimitive* m_next = nullptr;
+
+    /// Primitive type.
+    CsgPrimitiveType m_type;
+
+    /// Fidelity.
+    unsigned m_fidelity;
+
+    /// Point count (pipes only).
+    unsigned m_count;
+
+    /// Is the front capped?
+    bool m_front;
+
+    /// Is the back capped?
+    bool m_back;
+
+public:
+    /// Constructor.
+    ///
+    /// \param type Primitive type.
+    /// \param fidelity Fidelity.
+    /// \param count Point count (pipes only).
+    /// \param front Is the front capped?
+    /// \param back Is the back capped?
+    explicit CsgPrimitive(CsgPrimitiveType type, unsigned fidelity, unsigned count, bool front, bool back) :
+        m_type(type),
+        m_fidelity(fidelity),
+        m_count(count),
+        m_front(front),
+        m_back(back)
+    {
+        const float rad_offset = static_cast<float>(M_PI) * 2.0f / static_cast<float>(fidelity) * 0.5f;
+        for(unsigned ii = 0; (ii < fidelity); ++ii)
+        {
+            float rad = static_cast<float>(ii) / static_cast<float>(fidelity) * static_cast<float>(M_PI * 2.0) +
+                rad_offset;
+            m_ring.emplace_back(cos(rad), sin(rad));
+        }
+
+        if(type == CsgPrimitiveType::CONE)
+        {
+            generateConeFaces();
+        }
+        else
+        {
+            generatePipeFaces();
+        }
+    }
+
+    /// Deleted copy constructor.
+    CsgPrimitive(const CsgPrimitive&) = delete;
+    /// Deleted assignment.
+    CsgPrimitive& operator=(const CsgPrimitive&) = delete;
+
+private:
+    /// Generate face templates for a cone.
+    ///
+    /// Vertices 0 and 1 are the front and back centers, followed by interleaved front and back ring vertices.
+    void generateConeFaces()
+    {
+        for(unsigned ii = 0; (ii < m_fidelity); ++ii)
+        {
+            unsigned c1 = 2 + (ii * 2);
+            unsigned n1 = c1 + 1;
+            unsigned c2 = n1 + 1;
+            unsigned n2 = c2 + 1;
+            if((ii + 1) >= m_fidelity)
+            {
+                c2 = 2;
+                n2 = 3;
+            }
+
+            if(m_front)
+            {
+                m_faces.emplace_back(0u, c1, c2);
+            }
+            if(m_back)
+            {
+                m_faces.emplace_back(1u, n2, n1);
+            }
+            m_faces.emplace_back(c1, n1, n2, c2);
+        }
+    }
+
+    /// Generate face templates for a pipe.
+    ///
+    /// Vertices 0 and 1 are the beginning and end centers, followed by one ring per point.
+    void generatePipeFaces()
+    {
+        for(unsigned ii = 1; ((ii + 1) < m_count); ++ii)
+        {
+            if(ii == 1)
+            {
+                for(unsigned jj = 0; (jj < m_fidelity); ++jj)
+                {
+                    unsigned c1 = 2 + jj;
+                    unsigned c2 = c1 + 1;
+                    if((jj + 1) >= m_fidelity)
+                    {
+                        c2 = 2;
+                    }
+
+                    if(m_front)
+                    {
+                        m_faces.emplace_back(0u, c1, c2);
+                    }
+                }
+            }
+
+            generatePipeSegmentFaces(ii, false);
+
+            if(ii == (m_count - 2))
+            {
+                generatePipeSegmentFaces(m_count - 1, m_back);
+            }
+        }
+    }
+
+    /// Generate face templates connecting a pipe ring to the previous ring.
+    ///
+    /// \param ring Ring index.
+    /// \param back Cap back with this ring?
+    void generatePipeSegmentFaces(unsigned ring, bool back)
+    {
+        for(unsigned jj = 0; (jj < m_fidelity); ++jj)
+        {
+            unsigned n1 = 2 + (ring * m_fidelity) + jj;
+            unsigned e1 = n1 - m_fidelity;
+            unsigned n2 = n1 + 1;
+            unsigned e2 = e1 + 1;
+            if((jj + 1) >= m_fidelity)
+            {
+                n2 = 2 + (ring * m_fidelity);
+                e2 = n2 - m_fidelity;
+            }
+
+            if(back)
+            {
+                m_faces.emplace_back(1u, n2, n1);
+            }
+            m_faces.emplace_back(e1, n1, n2, e2);
+        }
+    }
+
+public:
+    /// Accessor.
+    ///
+    /// \param idx Ring vertex index.
+    /// \return Unit circle direction, cosine and sine.
+    constexpr const vec2& getRing(unsigned idx) const noexcept
+    {
+        return m_ring[idx];
+    }
+
+    /// Accessor.
+    ///
+    /// \return Face templates.
+    constexpr const vector<CsgPrimitiveFace>& getFaces() const noexcept
+    {
+        return m_faces;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Next primitive in cache.
+    constexpr CsgPrimitive* getNext() const noexcept
+    {
+        return m_next;
+    }
+    /// Setter.
+    ///
+    /// \param op Next primitive in cache.
+    constexpr void setNext(CsgPrimitive* op) noexcept
+    {
+        m_next = op;
+    }
+
+    /// Tell if this primitive matches given parameters.
+    ///
+    /// \param type Primitive type.
+    /// \param fidelity Fidelity.
+    /// \param count Point count (pipes only).
+    /// \param front Is the front capped?
+    /// \param back Is the back capped?
+    /// \return True if match, false if no.
+    constexpr bool matches(CsgPrimitiveType type, unsigned fidelity, unsigned count, bool front, bool back) const noexcept
+    {
+        return (m_type == type) && (m_fidelity == fidelity) && (m_count == count) && (m_front == front) &&
+            (m_back == back);
+    }
+};
+
+/// Cache of CSG primitives.
+///
+/// Primitives are kept in a lock-free list and never released while the cache exists, so references to them remain
+/// valid and the cache may be used from multiple threads. Primitive counts are low, so linear lookup suffices.
+class CsgPrimitiveCache
+{
+private:
+    /// First primitive in cache.
+    atomic<CsgPrimitive*> m_primitives = nullptr;
+
+#if defined(VGL_USE_LD)
+    /// Number of cache hits.
+    atomic<unsigned> m_hits = 0;
+
+    /// Number of cache misses.
+    atomic<unsigned> m_misses = 0;
+#endif
+
+public:
+    /// Default constructor.
+    constexpr explicit CsgPrimitiveCache() noexcept = default;
+
+#if defined(VGL_USE_LD)
+    /// Destructor.
+    ~CsgPrimitiveCache()
+    {
+        unsigned hits = m_hits.load(memory_order_relaxed);
+        unsigned misses = m_misses.load(memory_order_relaxed);
+        if(hits + misses)
+        {
+            std::cout << "CsgPrimitiveCache: " << misses << " primitives generated, " << hits << " of " <<
+                (hits + misses) << " lookups hit (" << (hits * 100 / (hits + misses)) << "%)" << std::endl;
+        }
+
+        for(CsgPrimitive* ii = m_primitives.load(memory_order_acquire); ii;)
+        {
+            CsgPrimitive* next = ii->getNext();
+            delete ii;
+            ii = next;
+        }
+    }
+#endif
+
+    /// Deleted copy constructor.
+    CsgPrimitiveCache(const CsgPrimitiveCache&) = delete;
+    /// Deleted assignment.
+    CsgPrimitiveCache& operator=(const CsgPrimitiveCache&) = delete;
+
+private:
+    /// Find a primitive.
+    ///
+    /// \param first First primitive to search from.
+    /// \param last Primitive to stop searching at.
+    /// \param type Primitive type.
+    /// \param fidelity Fidelity.
+    /// \param count Point count (pipes only).
+    /// \param front Is the front capped?
+    /// \param back Is the back capped?
+    /// \return Primitive found or nullptr.
+    static CsgPrimitive* find(CsgPrimitive* first, CsgPrimitive* last, CsgPrimitiveType type, unsigned fidelity,
+            unsigned count, bool front, bool back)
+    {
+        for(CsgPrimitive* ii = first; (ii != last); ii = ii->getNext())
+        {
+            if(ii->matches(type, fidelity, count, front, back))
+            {
+                return ii;
+            }
+        }
+        return nullptr;
+    }
+
+public:
+    /// Get a primitive, generating it if it does not exist yet.
+    ///
+    /// \param type Primitive type.
+    /// \param fidelity Fidelity.
+    /// \param count Point count (pipes only).
+    /// \param front Is the front capped?
+    /// \param back Is the back capped?
+    /// \return Primitive.
+    const CsgPrimitive& get(CsgPrimitiveType type, unsigned fidelity, unsigned count, bool front, bool back)
+    {
+        CsgPrimitive* head = m_primitives.load(memory_order_acquire);
+        CsgPrimitive* ret = find(head, nullptr, type, fidelity, count, front, back);
+        if(ret)
+        {
+#if defined(VGL_USE_LD)
+            m_hits.fetch_add(1, memory_order_relaxed);
+#endif
+            return *ret;
+        }
+
+        // Insert a new primitive, unless another thread inserted a matching one in the meantime.
+        CsgPrimitive* created = new CsgPrimitive(type, fidelity, count, front, back);
+        for(;;)
+        {
+            created->setNext(head);
+            if(m_primitives.compare_exchange_weak(head, created, memory_order_acq_rel, memory_order_acquire))
+            {
+#if defined(VGL_USE_LD)
+                m_misses.fetch_add(1, memory_order_relaxed);
+#endif
+                return *created;
+            }
+
+            ret = find(head, created->getNext(), type, fidelity, count, front, back);
+            if(ret)
+            {
+                delete created;
+#if defined(VGL_USE_LD)
+                m_hits.fetch_add(1, memory_order_relaxed);
+#endif
+                return *ret;
+            }
+        }
+    }
+};
+
+}
+
+}
+
+#endif
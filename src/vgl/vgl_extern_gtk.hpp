@@ -26,6 +26,9 @@
 #if !defined(dnload_g_cond_wait)
 #define dnload_g_cond_wait g_cond_wait
 #endif
+#if !defined(dnload_g_get_num_processors)
+#define dnload_g_get_num_processors g_get_num_processors
+#endif
 #if !defined(dnload_g_mutex_clear)
 #define dnload_g_mutex_clear g_mutex_clear
 #endif
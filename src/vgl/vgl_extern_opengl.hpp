@@ -123,6 +123,9 @@
 #if !defined(dnload_glDrawElements)
 #define dnload_glDrawElements glDrawElements
 #endif
+#if !defined(dnload_glDrawElementsInstanced)
+#define dnload_glDrawElementsInstanced glDrawElementsInstanced
+#endif
 #if !defined(dnload_glEnable)
 #define dnload_glEnable glEnable
 #endif
@@ -213,6 +216,9 @@
 #if !defined(dnload_glUseProgram)
 #define dnload_glUseProgram glUseProgram
 #endif
+#if !defined(dnload_glVertexAttribDivisor)
+#define dnload_glVertexAttribDivisor glVertexAttribDivisor
+#endif
 #if !defined(dnload_glVertexAttribPointer)
 #define dnload_glVertexAttribPointer glVertexAttribPointer
 #endif
@@ -0,0 +1,53 @@
+#ifndef VGL_EXTERN_PTHREAD_HPP
+#define VGL_EXTERN_PTHREAD_HPP
+
+/// \file
+/// \brief External include: POSIX threads
+
+#include "vgl_config.hpp"
+
+#if defined(VGL_ENABLE_PTHREAD)
+
+// System headers are needed for types and constants in all builds, symbols go through dnload.
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(VGL_USE_LD)
+
+/// \cond
+#if !defined(dnload_pthread_attr_destroy)
+#define dnload_pthread_attr_destroy pthread_attr_destroy
+#endif
+#if !defined(dnload_pthread_attr_init)
+#define dnload_pthread_attr_init pthread_attr_init
+#endif
+#if !defined(dnload_pthread_attr_setstacksize)
+#define dnload_pthread_attr_setstacksize pthread_attr_setstacksize
+#endif
+#if !defined(dnload_pthread_create)
+#define dnload_pthread_create pthread_create
+#endif
+#if !defined(dnload_pthread_join)
+#define dnload_pthread_join pthread_join
+#endif
+#if !defined(dnload_pthread_self)
+#define dnload_pthread_self pthread_self
+#endif
+#if !defined(dnload_setpriority)
+#define dnload_setpriority setpriority
+#endif
+#if !defined(dnload_syscall)
+#define dnload_syscall syscall
+#endif
+#if !defined(dnload_sysconf)
+#define dnload_sysconf sysconf
+#endif
+/// \endcond
+
+#endif
+
+#endif
+
+#endif
@@ -29,18 +29,27 @@
 #if !defined(dnload_SDL_CreateThread)
 #define dnload_SDL_CreateThread SDL_CreateThread
 #endif
+#if !defined(dnload_SDL_CreateThreadWithStackSize)
+#define dnload_SDL_CreateThreadWithStackSize SDL_CreateThreadWithStackSize
+#endif
 #if !defined(dnload_SDL_DestroyCond)
 #define dnload_SDL_DestroyCond SDL_DestroyCond
 #endif
 #if !defined(dnload_SDL_DestroyMutex)
 #define dnload_SDL_DestroyMutex SDL_DestroyMutex
 #endif
+#if !defined(dnload_SDL_GetCPUCount)
+#define dnload_SDL_GetCPUCount SDL_GetCPUCount
+#endif
 #if !defined(dnload_SDL_GetThreadID)
 #define dnload_SDL_GetThreadID SDL_GetThreadID
 #endif
 #if !defined(dnload_SDL_LockMutex)
 #define dnload_SDL_LockMutex SDL_LockMutex
 #endif
+#if !defined(dnload_SDL_SetThreadPriority)
+#define dnload_SDL_SetThreadPriority SDL_SetThreadPriority
+#endif
 #if !defined(dnload_SDL_ThreadID)
 #define dnload_SDL_ThreadID SDL_ThreadID
 #endif
@@ -3,6 +3,7 @@
 
 #include "vgl_assert.hpp"
 #include "vgl_cond.hpp"
+#include "vgl_futex.hpp"
 #include "vgl_scoped_acquire.hpp"
 #include "vgl_unique_ptr.hpp"
 
@@ -26,17 +27,37 @@ void* internal_fence_wait(Fence& op);
 /// \endcond
 
 /// Internal fence state.
+///
+/// Fence state is an atomic word so the fence can be signalled and checked without locking. Waiters first spin on
+/// the state, then go to sleep. Sleeping uses a futex on the state word where available, otherwise a condition
+/// variable protected by the task dispatcher mutex.
 class FenceData
 {
+public:
+    /// Fence state: signalled.
+    static const uint32_t STATE_INACTIVE = 0;
+    /// Fence state: active, nobody sleeping on it.
+    static const uint32_t STATE_ACTIVE = 1;
+    /// Fence state: active, someone sleeping on it.
+    static const uint32_t STATE_SLEEPING = 2;
+
+    /// Default number of iterations to spin before sleeping.
+    static const unsigned SPIN_COUNT = 256;
+
 private:
+#if !defined(VGL_HAS_FUTEX)
     /// Condition variable for this fence.
     Cond m_cond;
+#endif
 
     /// Return value from an associated function.
     void* m_return_value = nullptr;
 
-    /// Is the fence still active?
-    bool m_active = true;
+    /// Next fence data in a fence pool.
+    FenceData* m_next = nullptr;
+
+    /// Fence state word.
+    atomic<uint32_t> m_state = STATE_ACTIVE;
 
 private:
     /// Deleted copy constructor.
@@ -49,16 +70,6 @@ public:
     explicit FenceData() = default;
 
 public:
-#if defined(VGL_USE_LD)
-    /// Accessor.
-    ///
-    /// \return Internal implementation.
-    constexpr Cond::cond_type* getCondImpl() const noexcept
-    {
-        return m_cond.getCondImpl();
-    }
-#endif
-
     /// Accessor.
     ///
     /// \return Return value stored in the fence data.
@@ -74,34 +85,118 @@ public:
         m_return_value = ret;
     }
 
+    /// Accessor.
+    ///
+    /// \return Next fence data in pool.
+    constexpr FenceData* getNext() const noexcept
+    {
+        return m_next;
+    }
+    /// Setter.
+    ///
+    /// \param op Next fence data in pool.
+    constexpr void setNext(FenceData* op) noexcept
+    {
+        m_next = op;
+    }
+
     /// Is the fence still active?
     ///
     /// \return True if fence is still active.
-    constexpr bool isActive() const noexcept
+    bool isActive() const noexcept
     {
-        return m_active;
+        return (m_state.load(memory_order_acquire) != STATE_INACTIVE);
     }
     /// Setter.
     ///
+    /// Only to be used when nobody can be waiting on the fence.
+    ///
     /// \param op New active status flag.
-    constexpr void setActive(bool op) noexcept
+    void setActive(bool op) noexcept
+    {
+        m_state.store(op ? STATE_ACTIVE : STATE_INACTIVE, memory_order_release);
+    }
+
+    /// Mark fence inactive.
+    ///
+    /// Return value must have been set before calling.
+    ///
+    /// \return True if someone was sleeping on the fence and must be woken.
+    bool deactivate() noexcept
+    {
+        return (m_state.exchange(STATE_INACTIVE, memory_order_acq_rel) == STATE_SLEEPING);
+    }
+
+    /// Spin on the fence for a while, waiting for it to become inactive.
+    ///
+    /// \param op Number of iterations to spin.
+    /// \return True if fence became inactive, false if the caller should sleep.
+    bool spin(unsigned op) const noexcept
     {
-        m_active = op;
+        for(unsigned ii = 0; (ii < op); ++ii)
+        {
+            if(!isActive())
+            {
+                return true;
+            }
+            cpu_relax();
+        }
+        return !isActive();
+    }
+
+    /// Announce that a thread is about to sleep on the fence.
+    ///
+    /// \return True if fence is still active and the caller should sleep, false if it became inactive.
+    bool prepareSleep() noexcept
+    {
+        uint32_t expected = STATE_ACTIVE;
+        if(m_state.compare_exchange_strong(expected, STATE_SLEEPING, memory_order_acq_rel))
+        {
+            return true;
+        }
+        return (expected != STATE_INACTIVE);
+    }
+
+#if defined(VGL_HAS_FUTEX)
+    /// Wake everyone sleeping on the fence.
+    void wake()
+    {
+        futex_wake(m_state);
     }
 
-    /// Signal anyone waiting on the fence.
-    void signal() const
+    /// Sleep on the fence until it becomes inactive.
+    ///
+    /// Must be preceded by prepareSleep().
+    void sleep()
+    {
+        while(m_state.load(memory_order_acquire) == STATE_SLEEPING)
+        {
+            futex_wait(m_state, STATE_SLEEPING);
+        }
+    }
+#else
+    /// Wake everyone sleeping on the fence.
+    ///
+    /// \param op Locked scope.
+    void wake(const ScopedAcquire& op) const
     {
-        m_cond.signal();
+        (void)op;
+        m_cond.broadcast();
     }
 
-    /// Wait on the fence.
+    /// Sleep on the fence until it becomes inactive.
+    ///
+    /// Must be preceded by prepareSleep().
     ///
     /// \param op Locked scope.
-    void wait(const ScopedAcquire& op) const
+    void sleep(const ScopedAcquire& op) const
     {
-        m_cond.wait(op);
+        while(isActive())
+        {
+            m_cond.wait(op);
+        }
     }
+#endif
 
 public:
 #if defined(VGL_USE_LD)
@@ -112,7 +207,7 @@ public:
     /// \return Output stream.
     friend std::ostream& operator<<(std::ostream& lhs, const FenceData& rhs)
     {
-        return lhs << "FenceData(" << rhs.getCondImpl() << ")";
+        return lhs << "FenceData(" << rhs.m_state.load(memory_order_relaxed) << ")";
     }
 #endif
 };
@@ -187,20 +282,12 @@ public:
         return ret;
     }
 
-    /// Signal anyone waiting on the fence.
-    void signal() const
-    {
-        VGL_ASSERT(m_fence_data);
-        m_fence_data->signal();
-    }
-
-    /// Wait on the fence.
+    /// Accessor.
     ///
-    /// \param op Locked scope.
-    void wait(ScopedAcquire& op) const
+    /// \return Fence data.
+    constexpr detail::FenceData* getData() const noexcept
     {
-        VGL_ASSERT(m_fence_data);
-        m_fence_data->wait(op);
+        return m_fence_data;
     }
 
 private:
@@ -238,7 +325,7 @@ public:
     /// Bool operator.
     ///
     /// \return Flag indicating if the fence is still active.
-    constexpr operator bool() const noexcept
+    operator bool() const noexcept
     {
         VGL_ASSERT(m_fence_data);
         return m_fence_data->isActive();
@@ -254,7 +341,7 @@ public:
     /// \return Output stream.
     friend std::ostream& operator<<(std::ostream& lhs, const Fence& rhs)
     {
-        return lhs << "Fence(" << rhs.m_fence_data->getCondImpl() << ")";
+        return lhs << "Fence(" << rhs.m_fence_data << ")";
     }
 #endif
 };
@@ -2,7 +2,6 @@
 #define VGL_FENCE_POOL_HPP
 
 #include "vgl_fence.hpp"
-#include "vgl_queue.hpp"
 
 namespace vgl
 {
@@ -14,59 +13,79 @@ namespace detail
 ///
 /// Hides the internal implementation from task dispatcher.
 /// Uses explicit memory management because the fence data pointers are passed naked.
+///
+/// Implemented as an intrusive lock-free stack. Fence data may be released into the pool from any thread without
+/// locking. Acquiring must be serialized by the caller, which guarantees that an element cannot be popped and pushed
+/// back during another pop (ABA).
 class FencePool
 {
 private:
-    /// Container for fence data.
-    queue<FenceData*> m_pool;
+    /// Top of the fence data stack.
+    atomic<FenceData*> m_head = nullptr;
 
 public:
+    /// Default constructor.
+    explicit FencePool() = default;
+
     /// Destructor.
     ~FencePool()
     {
 #if defined(VGL_USE_LD)
-        while(!m_pool.empty())
+        FenceData* data = m_head.load(memory_order_acquire);
+        while(data)
         {
-            FenceData* data = m_pool.front();
-            VGL_ASSERT(data);
+            FenceData* next = data->getNext();
             delete data;
-            m_pool.pop();
+            data = next;
         }
 #endif
     }
 
+    /// Deleted copy constructor.
+    FencePool(const FencePool&) = delete;
+    /// Deleted assignment.
+    FencePool& operator=(const FencePool&) = delete;
+
 public:
     /// Is the fence pool empty?
     ///
     /// \return True if empty, false otherwise.
-    constexpr bool empty() noexcept
+    bool empty() const noexcept
     {
-        return m_pool.empty();
+        return !m_head.load(memory_order_acquire);
     }
 
     /// Acquire fence data.
     ///
+    /// Calls to acquire must be serialized.
+    ///
     /// \return Fence data.
     FenceData* acquire()
     {
-        if(m_pool.empty())
+        FenceData* ret = m_head.load(memory_order_acquire);
+        while(ret)
         {
-            return new FenceData();
+            if(m_head.compare_exchange_weak(ret, ret->getNext(), memory_order_acq_rel, memory_order_acquire))
+            {
+                ret->setNext(nullptr);
+                return ret;
+            }
         }
-
-        FenceData* ret = m_pool.front();
-        m_pool.pop();
-        VGL_ASSERT(ret);
-        return ret;
+        return new FenceData();
     }
 
     /// Release fence data back to the pool.
     ///
+    /// May be called from any thread without locking.
+    ///
     /// \param op Fence data to release.
     void emplace(FenceData* op)
     {
         VGL_ASSERT(op);
-        m_pool.emplace(op);
+        FenceData* head = m_head.load(memory_order_relaxed);
+        do {
+            op->setNext(head);
+        } while(!m_head.compare_exchange_weak(head, op, memory_order_release, memory_order_relaxed));
     }
 };
 
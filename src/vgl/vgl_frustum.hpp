@@ -0,0 +1,81 @@
+#ifndef VGL_FRUSTUM_HPP
+#define VGL_FRUSTUM_HPP
+
+#include "vgl_bounding_box.hpp"
+
+namespace vgl
+{
+
+/// View frustum for visibility tests.
+///
+/// Planes are stored as separate arrays of each coordinate, so tests against all planes vectorize.
+class Frustum
+{
+private:
+    /// Number of frustum planes.
+    static const unsigned PLANE_COUNT = 6;
+
+private:
+    /// Plane normal X components.
+    array<float, PLANE_COUNT> m_nx;
+
+    /// Plane normal Y components.
+    array<float, PLANE_COUNT> m_ny;
+
+    /// Plane normal Z components.
+    array<float, PLANE_COUNT> m_nz;
+
+    /// Plane distances.
+    array<float, PLANE_COUNT> m_d;
+
+public:
+    /// Constructor.
+    ///
+    /// Extracts the left, right, bottom, top, near and far planes from a combined matrix. Planes are not normalized,
+    /// so only the sign of the distance to them is meaningful.
+    ///
+    /// \param op Projection * camera matrix.
+    constexpr explicit Frustum(const mat4& op) noexcept
+    {
+        for(unsigned ii = 0; (ii < 3); ++ii)
+        {
+            for(unsigned jj = 0; (jj < 2); ++jj)
+            {
+                float sign = jj ? -1.0f : 1.0f;
+                unsigned plane = (ii * 2) + jj;
+                m_nx[plane] = op[3u] + (op[ii] * sign);
+                m_ny[plane] = op[7u] + (op[4u + ii] * sign);
+                m_nz[plane] = op[11u] + (op[8u + ii] * sign);
+                m_d[plane] = op[15u] + (op[12u + ii] * sign);
+            }
+        }
+    }
+
+public:
+    /// Tell if a bounding box is at least partially within the frustum.
+    ///
+    /// Conservative, boxes near frustum corners may be reported visible even if they are not.
+    ///
+    /// \param op Bounding box (world space).
+    /// \return True if visible, false if completely outside.
+    constexpr bool isVisible(const BoundingBox& op) const noexcept
+    {
+        const vec3& bmin = op.getMin();
+        const vec3& bmax = op.getMax();
+
+        // Test the box corner furthest along each plane normal.
+        bool outside = false;
+        for(unsigned ii = 0; (ii < PLANE_COUNT); ++ii)
+        {
+            float px = (m_nx[ii] >= 0.0f) ? bmax.x() : bmin.x();
+            float py = (m_ny[ii] >= 0.0f) ? bmax.y() : bmin.y();
+            float pz = (m_nz[ii] >= 0.0f) ? bmax.z() : bmin.z();
+            outside |= ((m_nx[ii] * px) + (m_ny[ii] * py) + (m_nz[ii] * pz) + m_d[ii]) < 0.0f;
+        }
+        return !outside;
+    }
+};
+
+}
+
+#endif
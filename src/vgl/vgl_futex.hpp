@@ -0,0 +1,201 @@
+#ifndef VGL_FUTEX_HPP
+#define VGL_FUTEX_HPP
+
+#include "vgl_atomic.hpp"
+
+#if defined(__linux__) && (defined(VGL_USE_LD) || defined(VGL_ENABLE_PTHREAD))
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+/// Futex is available for waiting on atomic words.
+#define VGL_HAS_FUTEX
+#if defined(VGL_USE_LD)
+/// \cond
+#if !defined(dnload_syscall)
+#define dnload_syscall syscall
+#endif
+/// \endcond
+#endif
+#elif defined(VGL_ENABLE_PTHREAD)
+#error "VGL_ENABLE_PTHREAD requires Linux futexes"
+#endif
+
+namespace vgl
+{
+
+#if defined(VGL_HAS_FUTEX)
+
+/// Sleep until an atomic word is woken or no longer contains the expected value.
+///
+/// May return spuriously, caller must re-check the value.
+///
+/// \param word Atomic word.
+/// \param expected Expected value.
+inline void futex_wait(atomic<uint32_t>& word, uint32_t expected)
+{
+    static_assert(sizeof(atomic<uint32_t>) == sizeof(uint32_t), "atomic<uint32_t> not usable as a futex word");
+    dnload_syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+/// Wake threads sleeping on an atomic word.
+///
+/// \param word Atomic word.
+/// \param count Number of threads to wake.
+inline void futex_wake(atomic<uint32_t>& word, int count = INT_MAX)
+{
+    dnload_syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+/// Futex primitives are also compiled in LD builds so the benchmark can compare them against SDL.
+#if defined(VGL_ENABLE_PTHREAD) || defined(VGL_USE_LD)
+
+namespace detail
+{
+
+/// Futex-based mutex.
+///
+/// Not recursive. Spins adaptively before sleeping: the spin limit follows the number of spins that were recently
+/// needed to acquire the mutex, so mutexes that are typically held for a short time are acquired without sleeping.
+class FutexMutex
+{
+private:
+    /// Mutex state: unlocked.
+    static const uint32_t STATE_UNLOCKED = 0;
+    /// Mutex state: locked, nobody sleeping on it.
+    static const uint32_t STATE_LOCKED = 1;
+    /// Mutex state: locked, someone (possibly) sleeping on it.
+    static const uint32_t STATE_CONTENDED = 2;
+
+    /// Maximum number of spins before sleeping.
+    static const unsigned SPIN_MAX = 256;
+
+private:
+    /// Mutex state word.
+    atomic<uint32_t> m_state = STATE_UNLOCKED;
+
+    /// Estimate of spins needed to acquire the mutex.
+    ///
+    /// Only a heuristic, races on the value are harmless.
+    atomic<unsigned> m_spin_estimate = 8;
+
+public:
+    /// Default constructor.
+    constexpr explicit FutexMutex() = default;
+
+    /// Deleted copy constructor.
+    FutexMutex(const FutexMutex&) = delete;
+    /// Deleted assignment.
+    FutexMutex& operator=(const FutexMutex&) = delete;
+
+private:
+    /// Try to acquire the mutex without sleeping.
+    ///
+    /// \return True on success.
+    bool tryAcquire() noexcept
+    {
+        uint32_t expected = STATE_UNLOCKED;
+        return m_state.compare_exchange_weak(expected, STATE_LOCKED, memory_order_acquire, memory_order_relaxed);
+    }
+
+public:
+    /// Lock.
+    void acquire() noexcept
+    {
+        if(tryAcquire())
+        {
+            return;
+        }
+
+        // Spin up to twice the recently needed amount.
+        unsigned estimate = m_spin_estimate.load(memory_order_relaxed);
+        unsigned limit = (estimate * 2 + 8 < SPIN_MAX) ? (estimate * 2 + 8) : SPIN_MAX;
+        for(unsigned ii = 1; (ii <= limit); ++ii)
+        {
+            cpu_relax();
+            if((m_state.load(memory_order_relaxed) == STATE_UNLOCKED) && tryAcquire())
+            {
+                m_spin_estimate.store(estimate - (estimate / 8) + (ii / 8), memory_order_relaxed);
+                return;
+            }
+        }
+        m_spin_estimate.store(estimate - (estimate / 8) + (limit / 8), memory_order_relaxed);
+
+        acquireContended();
+    }
+
+    /// Lock, assuming other threads are sleeping on the mutex.
+    ///
+    /// Used when re-acquiring the mutex after sleeping on a condition variable.
+    void acquireContended() noexcept
+    {
+        while(m_state.exchange(STATE_CONTENDED, memory_order_acquire) != STATE_UNLOCKED)
+        {
+            futex_wait(m_state, STATE_CONTENDED);
+        }
+    }
+
+    /// Unlock.
+    void release() noexcept
+    {
+        if(m_state.exchange(STATE_UNLOCKED, memory_order_release) == STATE_CONTENDED)
+        {
+            futex_wake(m_state, 1);
+        }
+    }
+};
+
+/// Futex-based condition variable.
+///
+/// Sleepers wait on a sequence number that is incremented by every signal. Spurious wakeups are possible.
+class FutexCond
+{
+private:
+    /// Sequence number.
+    atomic<uint32_t> m_sequence = 0;
+
+public:
+    /// Default constructor.
+    constexpr explicit FutexCond() = default;
+
+    /// Deleted copy constructor.
+    FutexCond(const FutexCond&) = delete;
+    /// Deleted assignment.
+    FutexCond& operator=(const FutexCond&) = delete;
+
+public:
+    /// Wake all sleepers.
+    void broadcast() noexcept
+    {
+        m_sequence.fetch_add(1, memory_order_release);
+        futex_wake(m_sequence);
+    }
+
+    /// Wake one sleeper.
+    void signal() noexcept
+    {
+        m_sequence.fetch_add(1, memory_order_release);
+        futex_wake(m_sequence, 1);
+    }
+
+    /// Sleep on the condition variable.
+    ///
+    /// \param op Locked mutex.
+    void wait(FutexMutex& op) noexcept
+    {
+        uint32_t sequence = m_sequence.load(memory_order_acquire);
+        op.release();
+        futex_wait(m_sequence, sequence);
+        op.acquireContended();
+    }
+};
+
+}
+
+#endif
+
+#endif
+
+}
+
+#endif
@@ -95,6 +95,17 @@ private:
     /// Vertex array objects.
     vector<VaoMapping> m_vao_mapping;
 
+    /// Vertex buffer storage size in bytes.
+    unsigned m_vertex_capacity = 0;
+
+    /// Index buffer storage size in bytes.
+    unsigned m_index_capacity = 0;
+
+#if defined(VGL_ENABLE_INSTANCING)
+    /// Per-instance transform buffer.
+    VertexBuffer m_instance_buffer;
+#endif
+
 public:
     /// Default constructor.
     explicit GeometryBuffer() = default;
@@ -107,7 +118,7 @@ public:
     explicit GeometryBuffer(const MeshData& op) :
         m_data(op)
     {
-        update();
+        update(0, 0);
 #if defined(VGL_USE_LD)
         detail::increment_buffer_data_sizes(op);
 #endif
@@ -119,9 +130,11 @@ private:
     /// \param op Mesh data to append.
     GeometryHandle appendInternal(const MeshData& op)
     {
-        GeometryHandle ret(*this, m_data.getVertexOffset(), m_data.getIndexOffset());
+        unsigned vertex_offset = m_data.getVertexOffset();
+        unsigned index_offset = m_data.getIndexOffset();
+        GeometryHandle ret(*this, vertex_offset, index_offset);
         m_data.append(op);
-        update();
+        update(vertex_offset, index_offset);
 #if defined(VGL_USE_LD)
         detail::increment_buffer_data_sizes(op);
 #endif
@@ -129,9 +142,42 @@ private:
     }
 
     /// Update to GPU.
-    void update()
+    ///
+    /// Only data past the given offsets is uploaded, unless buffer storage needs to grow.
+    ///
+    /// \param vertex_offset Vertex data offset already on GPU.
+    /// \param index_offset Index data offset already on GPU.
+    void update(unsigned vertex_offset, unsigned index_offset)
+    {
+        if(reserve(m_vertex_buffer, m_vertex_capacity, m_data.getVertexOffset()))
+        {
+            vertex_offset = 0;
+        }
+        if(reserve(m_index_buffer, m_index_capacity, m_data.getIndexOffset()))
+        {
+            index_offset = 0;
+        }
+        m_data.update(m_vertex_buffer, m_index_buffer, vertex_offset, index_offset);
+    }
+
+    /// Ensure buffer storage is large enough.
+    ///
+    /// Storage grows geometrically, so appending meshes one at a time uploads a linear amount of data in total.
+    ///
+    /// \param buffer Buffer to reserve storage in.
+    /// \param capacity Current storage size in bytes, updated on growth.
+    /// \param size Required storage size in bytes.
+    /// \return True if storage was reallocated and previous contents were lost.
+    template<GLenum BufferType> static bool reserve(const Buffer<BufferType>& buffer, unsigned& capacity,
+            unsigned size)
     {
-        m_data.update(m_vertex_buffer, m_index_buffer);
+        if(size <= capacity)
+        {
+            return false;
+        }
+        capacity = max(size, capacity * 2);
+        buffer.allocate(capacity);
+        return true;
     }
 
 public:
@@ -153,7 +199,7 @@ public:
         {
             return nullopt;
         }
-        if((m_data.getVertexCount() + op.getVertexCount()) > 0xFFFFu)
+        if((m_data.getVertexCount() + op.getVertexCount()) > GEOMETRY_BUFFER_MAX_VERTICES)
         {
             return nullopt;
         }
@@ -176,8 +222,38 @@ public:
 
         // Creating new VAO leaves it bound.
         m_vao_mapping.emplace_back(op, m_vertex_buffer, m_index_buffer, m_data);
+#if defined(VGL_ENABLE_INSTANCING)
+        // Per-instance transform columns advance once per instance.
+        GLint location = op.getInstanceTransformLocation();
+        if(location >= 0)
+        {
+            m_instance_buffer.bind();
+            for(unsigned ii = 0; (ii < 4); ++ii)
+            {
+                GLuint idx = static_cast<GLuint>(location) + ii;
+                dnload_glEnableVertexAttribArray(idx);
+                dnload_glVertexAttribPointer(idx, 4, GL_FLOAT, GL_FALSE, sizeof(mat4),
+                        reinterpret_cast<const void*>(ii * sizeof(vec4)));
+                dnload_glVertexAttribDivisor(idx, 1);
+            }
+        }
+#endif
     }
 
+#if defined(VGL_ENABLE_INSTANCING)
+    /// Bind this geometry buffer for instanced drawing.
+    ///
+    /// \param op Program to bind with.
+    /// \param transforms Per-instance transforms.
+    /// \param count Number of instances.
+    void bindInstances(const GlslProgram& op, const mat4* transforms, unsigned count)
+    {
+        // Streaming unbinds vertex array objects, so it must be done first.
+        m_instance_buffer.stream(transforms, count * static_cast<unsigned>(sizeof(mat4)));
+        bind(op);
+    }
+#endif
+
 #if defined(VGL_USE_LD)
 public:
     /// Stream output operator.
@@ -207,6 +283,20 @@ inline void geometry_buffer_bind(GeometryBuffer& geometry_buffer, const GlslProg
     geometry_buffer.bind(prog);
 }
 
+#if defined(VGL_ENABLE_INSTANCING)
+/// Bind a geometry buffer for instanced rendering.
+///
+/// \param geometry_buffer Geometry buffer to bind.
+/// \param prog Program to bind with.
+/// \param transforms Per-instance transforms.
+/// \param count Number of instances.
+inline void geometry_buffer_bind_instances(GeometryBuffer& geometry_buffer, const GlslProgram& prog,
+        const mat4* transforms, unsigned count)
+{
+    geometry_buffer.bindInstances(prog, transforms, count);
+}
+#endif
+
 /// Update mesh data into GPU as described by geometry handle.
 ///
 /// \param handle Handle into GPU data.
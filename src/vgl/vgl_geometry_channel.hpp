@@ -147,6 +147,48 @@ constexpr GLboolean geometry_channel_element_normalized(GeometryChannel op)
     }
 }
 
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+
+/// Returns the size of a geometry channel element type.
+///
+/// \param op Element type.
+/// \return Element size in bytes.
+constexpr unsigned geometry_element_type_size(GLenum op)
+{
+    switch(op)
+    {
+    case GL_FLOAT:
+        return 4;
+
+    case GL_SHORT:
+        return 2;
+
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+#if !defined(VGL_USE_LD)
+    default:
+#endif
+        return 1;
+
+#if defined(VGL_USE_LD)
+    default:
+        VGL_THROW_RUNTIME_ERROR("no element size defined for type " + to_string(static_cast<int>(op)));
+#endif
+    }
+}
+
+/// Returns the size of a geometry channel before quantization.
+///
+/// \param op Channel ID.
+/// \return Channel size in bytes.
+constexpr unsigned geometry_channel_size(GeometryChannel op)
+{
+    return static_cast<unsigned>(geometry_channel_element_count(op)) *
+        geometry_element_type_size(geometry_channel_element_type(op));
+}
+
+#endif
+
 }
 
 }
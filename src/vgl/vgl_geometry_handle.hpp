@@ -1,7 +1,8 @@
 #ifndef VGL_GEOMETRY_HANDLE_HPP
 #define VGL_GEOMETRY_HANDLE_HPP
 
-#include "vgl_extern_opengl.hpp"
+#include "vgl_index_type.hpp"
+#include "vgl_state.hpp"
 
 namespace vgl
 {
@@ -9,6 +10,7 @@ namespace vgl
 /// \cond
 class GeometryBuffer;
 class GlslProgram;
+class mat4;
 /// \endcond
 
 namespace detail
@@ -16,6 +18,10 @@ namespace detail
 
 /// \cond
 void geometry_buffer_bind(GeometryBuffer& geometry_buffer, const GlslProgram& prog);
+#if defined(VGL_ENABLE_INSTANCING)
+void geometry_buffer_bind_instances(GeometryBuffer& geometry_buffer, const GlslProgram& prog, const mat4* transforms,
+        unsigned count);
+#endif
 /// \endcond
 
 }
@@ -81,9 +87,32 @@ public:
     void draw(const GlslProgram& prog, GLenum mode, unsigned count) const
     {
         detail::geometry_buffer_bind(m_geometry_buffer, prog);
-        dnload_glDrawElements(mode, static_cast<GLsizei>(count), GL_UNSIGNED_SHORT,
+        dnload_glDrawElements(mode, static_cast<GLsizei>(count), INDEX_TYPE_GL,
                 reinterpret_cast<void*>(m_index_offset));
+#if defined(VGL_USE_LD)
+        increment_draw_calls();
+#endif
+    }
+
+#if defined(VGL_ENABLE_INSTANCING)
+    /// Draw multiple instances from this handle.
+    ///
+    /// \param prog Program to draw with, must have a per-instance transform attribute.
+    /// \param mode Mode to draw with.
+    /// \param count Number of elements to draw.
+    /// \param transforms Per-instance transforms.
+    /// \param instances Number of instances.
+    void drawInstanced(const GlslProgram& prog, GLenum mode, unsigned count, const mat4* transforms,
+            unsigned instances) const
+    {
+        detail::geometry_buffer_bind_instances(m_geometry_buffer, prog, transforms, instances);
+        dnload_glDrawElementsInstanced(mode, static_cast<GLsizei>(count), INDEX_TYPE_GL,
+                reinterpret_cast<void*>(m_index_offset), static_cast<GLsizei>(instances));
+#if defined(VGL_USE_LD)
+        increment_draw_calls();
+#endif
     }
+#endif
 
 #if defined(VGL_USE_LD)
 public:
@@ -5,6 +5,16 @@ namespace vgl
 
 const GlslProgram* GlslProgram::g_current_program = nullptr;
 
+#if defined(VGL_ENABLE_UNIFORM_CACHE)
+unsigned GlslProgram::g_view_serial = 0;
+#endif
+
+#if defined(VGL_USE_LD)
+unsigned GlslProgram::g_switch_count = 0;
+unsigned GlslProgram::g_uniform_count = 0;
+unsigned GlslProgram::g_uniform_skip_count = 0;
+#endif
+
 #if defined(VGL_USE_LD)
 
 string to_string(UniformSemantic op)
@@ -1,6 +1,7 @@
 #ifndef VGL_GLSL_PROGRAM_HPP
 #define VGL_GLSL_PROGRAM_HPP
 
+#include "vgl_array.hpp"
 #include "vgl_geometry_channel.hpp"
 #include "vgl_glsl_shader.hpp"
 #include "vgl_mat2.hpp"
@@ -191,6 +192,14 @@ public:
     /// Corresponding uniform semantic.
     UniformSemantic m_semantic;
 
+#if defined(VGL_ENABLE_UNIFORM_CACHE)
+    /// Shadow copy of the last applied value.
+    array<uint8_t, sizeof(mat4)> m_shadow;
+
+    /// Size of the shadow copy in bytes, zero if no value has been applied.
+    unsigned m_shadow_size = 0;
+#endif
+
 public:
     /// Constructor.
     ///
@@ -221,6 +230,29 @@ public:
         return m_semantic;
     }
 
+#if defined(VGL_ENABLE_UNIFORM_CACHE)
+    /// Update the shadow copy of the uniform value.
+    ///
+    /// \param data Value to compare against.
+    /// \param size Value size in bytes, at most the size of a mat4.
+    /// \return True if the value differs from the last applied value.
+    bool updateShadow(const void* data, unsigned size)
+    {
+        const uint8_t* src = static_cast<const uint8_t*>(data);
+        bool ret = (size != m_shadow_size);
+        for(unsigned ii = 0; (ii < size); ++ii)
+        {
+            if(m_shadow[ii] != src[ii])
+            {
+                m_shadow[ii] = src[ii];
+                ret = true;
+            }
+        }
+        m_shadow_size = size;
+        return ret;
+    }
+#endif
+
 #if defined(VGL_USE_LD)
     /// Refresh name
     ///
@@ -228,6 +260,9 @@ public:
     void refresh(GLuint op)
     {
         m_location = lookup(op, m_name.data());
+#if defined(VGL_ENABLE_UNIFORM_CACHE)
+        m_shadow_size = 0;
+#endif
     }
 #endif
 };
@@ -269,10 +304,42 @@ private:
     /// Program ID.
     GLuint m_id = 0;
 
+#if defined(VGL_ENABLE_UNIFORM_CACHE)
+    /// Serial of the last view applied to this program, zero if none.
+    unsigned m_view_serial = 0;
+#endif
+
+#if defined(VGL_ENABLE_INSTANCING)
+    /// Instanced variant of this program.
+    const GlslProgram* m_instanced_program = nullptr;
+
+    /// Per-instance transform attribute name.
+    const char* m_instance_transform_name = nullptr;
+
+    /// Per-instance transform attribute location, negative if the program is not instanced.
+    GLint m_instance_transform_location = -1;
+#endif
+
 public:
     /// Currently active program.
     static const GlslProgram* g_current_program;
 
+#if defined(VGL_ENABLE_UNIFORM_CACHE)
+    /// Serial of the current view.
+    static unsigned g_view_serial;
+#endif
+
+#if defined(VGL_USE_LD)
+    /// Number of actual program switches.
+    static unsigned g_switch_count;
+
+    /// Number of uniform calls issued through the uniform cache.
+    static unsigned g_uniform_count;
+
+    /// Number of uniform calls skipped by the uniform cache.
+    static unsigned g_uniform_skip_count;
+#endif
+
 public:
     /// Default constructor.
     constexpr explicit GlslProgram() noexcept = default;
@@ -394,6 +461,15 @@ private:
         {
             vv.refresh(m_id);
         }
+#if defined(VGL_ENABLE_UNIFORM_CACHE)
+        m_view_serial = 0;
+#endif
+#if defined(VGL_ENABLE_INSTANCING)
+        if(m_instance_transform_name)
+        {
+            m_instance_transform_location = dnload_glGetAttribLocation(m_id, m_instance_transform_name);
+        }
+#endif
     }
 #endif
 
@@ -445,6 +521,51 @@ public:
         return -1;
     }
 
+#if defined(VGL_ENABLE_INSTANCING)
+    /// Set the per-instance transform attribute.
+    ///
+    /// The attribute is a mat4, taking four consecutive attribute locations. Programs with a per-instance transform
+    /// attribute read the transform of each instance from it instead of modelview uniforms.
+    ///
+    /// \param name Name of the attribute.
+    void setInstanceTransform(const char* name)
+    {
+        m_instance_transform_name = name;
+        m_instance_transform_location = dnload_glGetAttribLocation(m_id, name);
+#if defined(VGL_USE_LD)
+        if(m_instance_transform_location < 0)
+        {
+            VGL_THROW_RUNTIME_ERROR("cannot set instance transform '" + string(name) + "' to program " +
+                    to_string(m_id));
+        }
+#endif
+    }
+    /// Accessor.
+    ///
+    /// \return Per-instance transform attribute location or negative value.
+    constexpr GLint getInstanceTransformLocation() const noexcept
+    {
+        return m_instance_transform_location;
+    }
+
+    /// Set the instanced variant of this program.
+    ///
+    /// Repeated draws of the same mesh with this program may be replaced with one instanced draw using the variant.
+    ///
+    /// \param op Instanced program.
+    void setInstanced(const GlslProgram& op)
+    {
+        m_instanced_program = &op;
+    }
+    /// Accessor.
+    ///
+    /// \return Instanced variant of this program or nullptr.
+    constexpr const GlslProgram* getInstanced() const noexcept
+    {
+        return m_instanced_program;
+    }
+#endif
+
     /// Add an uniform.
     ///
     /// \param name Name of the uniform.
@@ -507,6 +628,9 @@ public:
         {
             dnload_glUseProgram(m_id);
             g_current_program = this;
+#if defined(VGL_USE_LD)
+            ++g_switch_count;
+#endif
         }
     }
 
@@ -586,6 +710,69 @@ public:
         }
         return false;
     }
+    /// Feed uniform to the program unless the value is unchanged.
+    ///
+    /// Programs retain their uniform values, so applying the same value again is redundant. Uniforms fed using this
+    /// function must not be fed by other means. Without VGL_ENABLE_UNIFORM_CACHE, the value is always applied.
+    ///
+    /// If uniform semantic is not present, this function silently does nothing.
+    ///
+    /// \param semantic Uniform semantic.
+    /// \param value Uniform value.
+    template<typename T> void uniformCached(UniformSemantic semantic, const T& value)
+    {
+        static_assert(sizeof(T) <= sizeof(mat4));
+#if defined(VGL_ENABLE_UNIFORM_CACHE)
+        for(auto& vv : m_uniforms)
+        {
+            if(vv.getSemantic() == semantic)
+            {
+                if(vv.getLocation() < 0)
+                {
+                    return;
+                }
+                if(vv.updateShadow(&value, static_cast<unsigned>(sizeof(T))))
+                {
+                    applyUniform(vv.getLocation(), value);
+#if defined(VGL_USE_LD)
+                    ++g_uniform_count;
+#endif
+                }
+#if defined(VGL_USE_LD)
+                else
+                {
+                    ++g_uniform_skip_count;
+                }
+#endif
+                return;
+            }
+        }
+#else
+#if defined(VGL_USE_LD)
+        if(uniform(semantic, value))
+        {
+            ++g_uniform_count;
+        }
+#else
+        uniform(semantic, value);
+#endif
+#endif
+    }
+
+#if defined(VGL_ENABLE_UNIFORM_CACHE)
+    /// Mark the current view as applied to this program.
+    ///
+    /// \return True if the current view had not yet been applied.
+    bool updateView()
+    {
+        if(m_view_serial == g_view_serial)
+        {
+            return false;
+        }
+        m_view_serial = g_view_serial;
+        return true;
+    }
+#endif
 
 public:
     /// Apply uniform.
@@ -759,6 +946,46 @@ public:
     }
 };
 
+#if defined(VGL_ENABLE_UNIFORM_CACHE)
+
+/// Begin a new view.
+///
+/// View uniforms are applied to each program once per view.
+inline void glsl_program_new_view()
+{
+    ++GlslProgram::g_view_serial;
+}
+
+#endif
+
+#if defined(VGL_USE_LD)
+
+/// Accessor.
+///
+/// \return Number of actual program switches so far.
+inline unsigned get_program_switches()
+{
+    return GlslProgram::g_switch_count;
+}
+
+/// Accessor.
+///
+/// \return Number of uniform calls issued through the uniform cache so far.
+inline unsigned get_uniform_calls()
+{
+    return GlslProgram::g_uniform_count;
+}
+
+/// Accessor.
+///
+/// \return Number of uniform calls skipped by the uniform cache so far.
+inline unsigned get_uniform_calls_skipped()
+{
+    return GlslProgram::g_uniform_skip_count;
+}
+
+#endif
+
 }
 
 #if !defined(VGL_USE_LD)
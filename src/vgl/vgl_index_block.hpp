@@ -1,6 +1,8 @@
 #ifndef VGL_INDEX_BLOCK_HPP
 #define VGL_INDEX_BLOCK_HPP
 
+#include "vgl_index_type.hpp"
+
 namespace vgl
 {
 
@@ -49,7 +51,7 @@ private:
     IndexBlock(GLenum type, unsigned count, unsigned offset) :
         m_type(type),
         m_count(count),
-        m_offset(reinterpret_cast<uint16_t*>(offset))
+        m_offset(reinterpret_cast<index_type*>(offset))
     {
     }
 
@@ -57,7 +59,7 @@ private:
     /// Draw indexed geometry.
     void drawGeometry() const
     {
-        dnload_glDrawElements(m_type, static_cast<GLsizei>(m_count), GL_UNSIGNED_SHORT, m_offset);
+        dnload_glDrawElements(m_type, static_cast<GLsizei>(m_count), INDEX_TYPE_GL, m_offset);
     }
 };
 
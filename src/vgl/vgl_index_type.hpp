@@ -0,0 +1,35 @@
+#ifndef VGL_INDEX_TYPE_HPP
+#define VGL_INDEX_TYPE_HPP
+
+#include "vgl_extern_opengl.hpp"
+
+namespace vgl
+{
+
+#if defined(VGL_ENABLE_32BIT_INDICES)
+
+/// Vertex index type.
+using index_type = uint32_t;
+
+/// OpenGL element type of vertex indices.
+static const GLenum INDEX_TYPE_GL = GL_UNSIGNED_INT;
+
+/// Maximum number of vertices in one geometry buffer.
+static const unsigned GEOMETRY_BUFFER_MAX_VERTICES = VGL_GEOMETRY_BUFFER_VERTICES;
+
+#else
+
+/// Vertex index type.
+using index_type = uint16_t;
+
+/// OpenGL element type of vertex indices.
+static const GLenum INDEX_TYPE_GL = GL_UNSIGNED_SHORT;
+
+/// Maximum number of vertices in one geometry buffer.
+static const unsigned GEOMETRY_BUFFER_MAX_VERTICES = 0xFFFFu;
+
+#endif
+
+}
+
+#endif
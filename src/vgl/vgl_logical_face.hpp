@@ -370,6 +370,20 @@ public:
         return verify();
     }
 
+    /// Remap all vertex indices.
+    ///
+    /// \param op Remap table, indexed by old vertex index.
+    /// \return True if the face is still valid after the remap, false if not.
+    constexpr bool remapVertexIndices(const unsigned* op)
+    {
+        for(unsigned ii = 0; (ii < m_num_corners); ++ii)
+        {
+            m_indices[ii] = op[m_indices[ii]];
+        }
+
+        return verify();
+    }
+
     /// Try to repair any inconsistencies in the face.
     ///
     /// \return True if the face is appropriate.
@@ -420,16 +434,16 @@ public:
             VGL_THROW_RUNTIME_ERROR("don't know how to write face with " + to_string(m_num_corners) + " corners");
         }
 #endif
-        op.write(static_cast<uint16_t>(m_indices[0]));
-        op.write(static_cast<uint16_t>(m_indices[1]));
-        op.write(static_cast<uint16_t>(m_indices[2]));
+        op.write(static_cast<index_type>(m_indices[0]));
+        op.write(static_cast<index_type>(m_indices[1]));
+        op.write(static_cast<index_type>(m_indices[2]));
 
         // Write another triangle if this is a quad.
         if(isQuad())
         {
-            op.write(static_cast<uint16_t>(m_indices[2]));
-            op.write(static_cast<uint16_t>(m_indices[3]));
-            op.write(static_cast<uint16_t>(m_indices[0]));
+            op.write(static_cast<index_type>(m_indices[2]));
+            op.write(static_cast<index_type>(m_indices[3]));
+            op.write(static_cast<index_type>(m_indices[0]));
         }
     }
 
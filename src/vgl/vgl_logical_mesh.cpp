@@ -1,16 +1,47 @@
 #include "vgl_logical_mesh.hpp"
 
+#if !defined(VGL_DISABLE_CSG)
+#include "vgl_csg_primitive_cache.hpp"
+#endif
+
 namespace vgl
 {
 
 #if defined(VGL_USE_LD)
-unsigned int LogicalMesh::g_vertices_erased = 0;
+atomic<unsigned> LogicalMesh::g_vertices_erased(0);
+bool LogicalMesh::g_orphan_removal_reference = false;
 #endif
 
 #if !defined(VGL_DISABLE_CSG)
 namespace
 {
 
+/// Cache of cone and pipe primitives.
+detail::CsgPrimitiveCache g_csg_primitive_cache;
+
+/// Add faces of a CSG primitive into a logical mesh.
+///
+/// \param lmesh Target logical mesh.
+/// \param primitive CSG primitive.
+/// \param index_base Index of the first vertex of the primitive.
+/// \param flat Are the faces flat?
+void csg_add_faces(LogicalMesh& lmesh, const detail::CsgPrimitive& primitive, unsigned index_base, bool flat)
+{
+    for(const auto& vv : primitive.getFaces())
+    {
+        if(vv.isQuad())
+        {
+            lmesh.addFace(index_base + vv.getIndex(0), index_base + vv.getIndex(1), index_base + vv.getIndex(2),
+                    index_base + vv.getIndex(3), flat);
+        }
+        else
+        {
+            lmesh.addFace(index_base + vv.getIndex(0), index_base + vv.getIndex(1), index_base + vv.getIndex(2),
+                    flat);
+        }
+    }
+}
+
 /// Normalizes a direction vector and ensures it's not perpendicular to another vector.
 ///
 /// Direction vector does not need to be an unit vector, it is normalized.
@@ -241,9 +272,9 @@ void LogicalMesh::csgCone(const vec3& p1, const vec3& p2, const vec3 param_fw, c
     vec3 unit_up = perpendiculate(param_up, unit_fw);
     vec3 unit_rt = normalize(cross(unit_fw, unit_up));
 
-    const float rad_offset = static_cast<float>(M_PI) * 2.0f / static_cast<float>(fidelity) * 0.5f;
+    const detail::CsgPrimitive& primitive = g_csg_primitive_cache.get(detail::CsgPrimitiveType::CONE, fidelity, 0,
+            !flags[CSG_FLAG_NO_FRONT], !flags[CSG_FLAG_NO_BACK]);
     unsigned index_base = getLogicalVertexCount();
-    bool flat = flags[CSG_FLAG_FLAT];
 
     // Invalid values for cylinders.
     VGL_ASSERT(!flags[CSG_FLAG_NO_BOTTOM]);
@@ -257,40 +288,22 @@ void LogicalMesh::csgCone(const vec3& p1, const vec3& p2, const vec3 param_fw, c
 
     for(unsigned ii = 0; (ii < fidelity); ++ii)
     {
-        float rad = static_cast<float>(ii) / static_cast<float>(fidelity) * static_cast<float>(M_PI * 2.0) + rad_offset;
-        vec3 dir1 = (cos(rad) * unit_rt + sin(rad) * unit_up) * radius1;
-        vec3 dir2 = (cos(rad) * unit_rt + sin(rad) * unit_up) * radius2;
+        const vec2& ring = primitive.getRing(ii);
+        vec3 dir1 = (ring.x() * unit_rt + ring.y() * unit_up) * radius1;
+        vec3 dir2 = (ring.x() * unit_rt + ring.y() * unit_up) * radius2;
         addVertex(p1 + dir1);
         addVertex(p2 + dir2);
-
-        unsigned c1 = index_base + 2 + (ii * 2);
-        unsigned n1 = c1 + 1;
-        unsigned c2 = n1 + 1;
-        unsigned n2 = c2 + 1;
-        if((ii + 1) >= fidelity)
-        {
-            c2 = index_base + 2;
-            n2 = index_base + 3;
-        }
-
-        if(!flags[CSG_FLAG_NO_FRONT])
-        {
-            addFace(index_base + 0, c1, c2, flat);
-        }
-        if(!flags[CSG_FLAG_NO_BACK])
-        {
-            addFace(index_base + 1, n2, n1, flat);
-        }
-        addFace(c1, n1, n2, c2, flat);
     }
+
+    csg_add_faces(*this, primitive, index_base, flags[CSG_FLAG_FLAT]);
 }
 
 void LogicalMesh::csgPipe(const vec3* points, unsigned count, unsigned fidelity, float radius,
         CsgFlags flags)
 {
-    const float rad_offset = static_cast<float>(M_PI) * 2.0f / static_cast<float>(fidelity) * 0.5f;
+    const detail::CsgPrimitive& primitive = g_csg_primitive_cache.get(detail::CsgPrimitiveType::PIPE, fidelity, count,
+            !flags[CSG_FLAG_NO_FRONT], !flags[CSG_FLAG_NO_BACK]);
     unsigned index_base = getLogicalVertexCount();
-    bool flat = flags[CSG_FLAG_FLAT];
     vgl::vec3 prev_unit_up;
 
     // Invalid values for pipes.
@@ -330,25 +343,12 @@ void LogicalMesh::csgPipe(const vec3* points, unsigned count, unsigned fidelity,
 
             for(unsigned jj = 0; (jj < fidelity); ++jj)
             {
-                float rad = static_cast<float>(jj) / static_cast<float>(fidelity) * static_cast<float>(M_PI * 2.0) + rad_offset;
-                vec3 dir = cos(rad) * rt + sin(rad) * up;
-                addVertex(p1 + dir);
-
-                unsigned c1 = index_base + 2 + jj;
-                unsigned c2 = c1 + 1;
-                if((jj + 1) >= fidelity)
-                {
-                    c2 = index_base + 2;
-                }
-
-                if(!flags[CSG_FLAG_NO_FRONT])
-                {
-                    addFace(index_base + 0, c1, c2, flat);
-                }
+                const vec2& ring = primitive.getRing(jj);
+                addVertex(p1 + (ring.x() * rt + ring.y() * up));
             }
         }
 
-        // Make mid-vertices and connect earlier segment.
+        // Make mid-vertices.
         {
             // radmul is 1 for straight pipe and sqrt(2) for straight angle.
             float radmul = sqrt(1.0f - (dot(diff1, diff2) - 1.0f));
@@ -356,53 +356,25 @@ void LogicalMesh::csgPipe(const vec3* points, unsigned count, unsigned fidelity,
 
             for(unsigned jj = 0; (jj < fidelity); ++jj)
             {
-                float rad = static_cast<float>(jj) / static_cast<float>(fidelity) * static_cast<float>(M_PI * 2.0) + rad_offset;
-                vec3 dir = cos(rad) * rt + sin(rad) * up;
-                addVertex(p2 + dir);
-
-                unsigned n1 = index_base + 2 + (ii * fidelity) + jj;
-                unsigned e1 = n1 - fidelity;
-                unsigned n2 = n1 + 1;
-                unsigned e2 = e1 + 1;
-                if((jj + 1) >= fidelity)
-                {
-                    n2 = index_base + 2 + (ii * fidelity);
-                    e2 = n2 - fidelity;
-                }
-
-                addFace(e1, n1, n2, e2, flat);
+                const vec2& ring = primitive.getRing(jj);
+                addVertex(p2 + (ring.x() * rt + ring.y() * up));
             }
         }
 
-        // If at the end, make the ending vertices and connect to previous segment.
+        // If at the end, make the ending vertices.
         if(ii == (count - 2))
         {
             vec3 rt = unit_rt2 * radius;
 
             for(unsigned jj = 0; (jj < fidelity); ++jj)
             {
-                float rad = static_cast<float>(jj) / static_cast<float>(fidelity) * static_cast<float>(M_PI * 2.0) + rad_offset;
-                vec3 dir = cos(rad) * rt + sin(rad) * up;
-                addVertex(p3 + dir);
-
-                unsigned n1 = index_base + 2 + ((count - 1) * fidelity) + jj;
-                unsigned e1 = n1 - fidelity;
-                unsigned n2 = n1 + 1;
-                unsigned e2 = e1 + 1;
-                if((jj + 1) >= fidelity)
-                {
-                    n2 = index_base + 2 + ((count - 1) * fidelity);
-                    e2 = n2 - fidelity;
-                }
-
-                if(!flags[CSG_FLAG_NO_BACK])
-                {
-                    addFace(index_base + 1, n2, n1, flat);
-                }
-                addFace(e1, n1, n2, e2, flat);
+                const vec2& ring = primitive.getRing(jj);
+                addVertex(p3 + (ring.x() * rt + ring.y() * up));
             }
         }
     }
+
+    csg_add_faces(*this, primitive, index_base, flags[CSG_FLAG_FLAT]);
 }
 
 void LogicalMesh::csgReadData(const int16_t* data)
@@ -166,9 +166,15 @@ private:
     vector<LogicalFace> m_faces;
 
 private:
+    /// Remap table entry for a vertex that is erased without replacement.
+    static const unsigned NO_VERTEX = ~0u;
+
 #if defined(VGL_USE_LD)
     /// Number of vertices erased during logical mesh generation.
-    static unsigned int g_vertices_erased;
+    static atomic<unsigned> g_vertices_erased;
+
+    /// Erase orphaned vertices one at a time instead of in one compaction pass.
+    static bool g_orphan_removal_reference;
 #endif
 
 public:
@@ -293,95 +299,193 @@ private:
         return (m_vertices[op].getFaceReferences().size() <= 0);
     }
 
-    /// Erase orphaned vertex at given index.
+    /// Erase vertices according to a remap table.
     ///
-    /// \param op Vertex index.
-    void eraseOrphanedVertex(unsigned op)
+    /// Each remap table entry must be either the index of the vertex itself to keep it, the index of a preceding
+    /// vertex to merge it into, or NO_VERTEX if the vertex is orphaned. Kept vertices retain their relative order.
+    /// Faces are remapped in one sweep, and the ones that become degenerate are erased.
+    ///
+    /// \param remap Remap table, will be overwritten with new vertex indices.
+    void eraseVertices(vector<unsigned>& remap)
     {
+        // Compact vertices.
+        unsigned vertex_count = m_vertices.size();
+        unsigned vertex_dst = 0;
+        for(unsigned ii = 0; (ii < vertex_count); ++ii)
+        {
+            unsigned target = remap[ii];
+            if(target == ii)
+            {
+                if(ii != vertex_dst)
+                {
+                    m_vertices[vertex_dst] = move(m_vertices[ii]);
+                }
+                remap[ii] = vertex_dst;
+                ++vertex_dst;
+            }
+            else if(target != NO_VERTEX)
+            {
+                remap[ii] = remap[target];
+            }
 #if defined(VGL_USE_LD)
-        if(!isOrphanedVertex(op))
+            else if(!isOrphanedVertex(ii))
+            {
+                VGL_THROW_RUNTIME_ERROR("cannot erase non-orphaned vertex " + to_string(ii));
+            }
+#endif
+        }
+        if(vertex_dst >= vertex_count)
         {
-            VGL_THROW_RUNTIME_ERROR("cannot erase non-orphaned vertex " + to_string(op));
+            return;
         }
-        ++g_vertices_erased;
+#if defined(VGL_USE_LD)
+        g_vertices_erased += vertex_count - vertex_dst;
 #endif
-        if((op + 1) < m_vertices.size())
+        while(m_vertices.size() > vertex_dst)
         {
-            m_vertices[op] = move(m_vertices.back());
-            unsigned erase_count = replaceVertexIndex(m_vertices.size() - 1, op);
-#if defined(VGL_USE_LD)
-            if(erase_count)
+            m_vertices.pop_back();
+        }
+
+        // Remap faces, erasing the ones that became degenerate.
+        unsigned face_dst = 0;
+        for(unsigned ii = 0; (ii < m_faces.size()); ++ii)
+        {
+            if(m_faces[ii].remapVertexIndices(remap.data()))
             {
-                VGL_THROW_RUNTIME_ERROR("erasing orphaned vertex turned a face degenerate");
+                if(ii != face_dst)
+                {
+                    m_faces[face_dst] = move(m_faces[ii]);
+                }
+                ++face_dst;
             }
-#else
-            (void)erase_count;
-#endif
         }
-        m_vertices.pop_back();
+
+        // Face references are pointers, must be rebuilt if faces moved.
+        if(face_dst < m_faces.size())
+        {
+            while(m_faces.size() > face_dst)
+            {
+                m_faces.pop_back();
+            }
+            rebuildFaceReferences();
+        }
     }
 
-    /// Replaces vertex index.
-    ///
-    /// Erases faces that become degenerate as a consequence.
+#if defined(VGL_USE_LD)
+    /// Erase orphaned vertices one at a time.
     ///
-    /// \param src Source vertex index.
-    /// \param dst Destination vertex index.
-    /// \return Number of faces erased by the process.
-    unsigned replaceVertexIndex(unsigned src, unsigned dst)
+    /// Reference implementation for benchmarking the compaction pass. Each erased vertex is replaced by the last
+    /// vertex, and all faces are rewritten for it, so the cost is O(orphans * faces).
+    void eraseOrphanedVerticesReference()
     {
-        unsigned ret = 0;
-
-        for(unsigned ii = 0; (ii < m_faces.size());)
+        for(unsigned ii = 0; (ii < m_vertices.size());)
         {
-            LogicalFace& face = m_faces[ii];
-
-            if(!face.replaceVertexIndex(src, dst))
+            if(!isOrphanedVertex(ii))
             {
-                if((ii + 1) < m_faces.size())
-                {
-                    face = move(m_faces.back());
-                }
-                m_faces.pop_back();
-                ++ret;
+                ++ii;
+                continue;
             }
-            else
+            ++g_vertices_erased;
+            unsigned last = m_vertices.size() - 1;
+            if(ii < last)
             {
-                ++ii;
+                m_vertices[ii] = move(m_vertices[last]);
+                for(auto& face : m_faces)
+                {
+                    if(!face.replaceVertexIndex(last, ii))
+                    {
+                        VGL_THROW_RUNTIME_ERROR("erasing orphaned vertex turned a face degenerate");
+                    }
+                }
             }
+            m_vertices.pop_back();
         }
-
-#if defined(VGL_USE_LD)
-        // Clear face references to mark vertex really as orphan.
-        LogicalVertex& srcVertex = m_vertices[src];
-        srcVertex.clearFaceReferences();
+    }
 #endif
 
-        return ret;
+    /// Rebuild face references of all vertices from face data.
+    void rebuildFaceReferences()
+    {
+        for(auto& vv : m_vertices)
+        {
+            vv.clearFaceReferences();
+        }
+        for(auto& face : m_faces)
+        {
+            for(unsigned ii = 0; (ii < face.getNumCorners()); ++ii)
+            {
+                m_vertices[face.getIndex(ii)].addFaceReference(face);
+            }
+        }
     }
 
     /// Remove identical vertices.
+    ///
+    /// Vertices are inserted into a spatial hash of quantized positions, so matches are only searched for within
+    /// adjacent cells. Each vertex is merged into the first preceding vertex it matches. Remaining vertices keep
+    /// their relative order and all faces are remapped in one sweep.
     void removeIdenticalVertices()
     {
-        for(unsigned ii = 0; (ii < m_vertices.size()); ++ii)
+        unsigned vertex_count = m_vertices.size();
+        unsigned bucket_count = 1;
+        while(bucket_count < (vertex_count * 2))
         {
-            LogicalVertex& lhs = m_vertices[ii];
+            bucket_count *= 2;
+        }
 
-            for(unsigned jj = ii + 1; (jj < m_vertices.size());)
-            {
-                LogicalVertex& rhs = m_vertices[jj];
+        vector<unsigned> buckets(bucket_count);
+        vector<unsigned> chain(vertex_count);
+        vector<unsigned> remap(vertex_count);
+        for(auto& vv : buckets)
+        {
+            vv = NO_VERTEX;
+        }
 
-                if(lhs.matches(rhs))
-                {
-                    lhs.appendFaceReferences(rhs);
-                    replaceVertexIndex(jj, ii);
-                    eraseOrphanedVertex(jj);
-                }
-                else
+        // Find the first matching preceding vertex for all vertices.
+        unsigned weld_count = 0;
+        for(unsigned ii = 0; (ii < vertex_count); ++ii)
+        {
+            LogicalVertex& vertex = m_vertices[ii];
+            array<int32_t, 3> cell = vertex.getWeldCell();
+            unsigned found = NO_VERTEX;
+
+            for(int32_t zz = -1; (zz <= 1); ++zz)
+            {
+                for(int32_t yy = -1; (yy <= 1); ++yy)
                 {
-                    ++jj;
+                    for(int32_t xx = -1; (xx <= 1); ++xx)
+                    {
+                        array<int32_t, 3> neighbor{cell[0u] + xx, cell[1u] + yy, cell[2u] + zz};
+                        unsigned bucket = vertex.getWeldHash(neighbor) & (bucket_count - 1);
+                        for(unsigned jj = buckets[bucket]; (jj != NO_VERTEX); jj = chain[jj])
+                        {
+                            if((jj < found) && m_vertices[jj].matches(vertex))
+                            {
+                                found = jj;
+                            }
+                        }
+                    }
                 }
             }
+
+            if(found != NO_VERTEX)
+            {
+                m_vertices[found].appendFaceReferences(vertex);
+                remap[ii] = found;
+                ++weld_count;
+            }
+            else
+            {
+                remap[ii] = ii;
+                unsigned bucket = vertex.getWeldHash(cell) & (bucket_count - 1);
+                chain[ii] = buckets[bucket];
+                buckets[bucket] = ii;
+            }
+        }
+
+        if(weld_count)
+        {
+            eraseVertices(remap);
         }
     }
 
@@ -424,6 +528,19 @@ public:
     /// \param removeIdentical Flag determining whether to perform the identical vertex erase pass (default: true).
     /// \return Mesh.
     MeshUptr compile(bool removeIdentical = true)
+    {
+        MeshUptr ret(compileMesh(removeIdentical));
+        TaskDispatcher::wait_main(task_update_mesh, ret.get());
+        return ret;
+    }
+
+    /// Compiles the logical mesh into a mesh without uploading it to the GPU.
+    ///
+    /// Does not require the main thread.
+    ///
+    /// \param removeIdentical Flag determining whether to perform the identical vertex erase pass (default: true).
+    /// \return Pointer to new mesh.
+    Mesh* compileMesh(bool removeIdentical = true)
     {
 #if defined(VGL_USE_LD)
         // Clear all face references to destroy state.
@@ -530,17 +647,25 @@ public:
             }
         }
 
-        // Loop through vertices, and remove vertices that are not used by any face.
-        for(unsigned ii = 0; (ii < m_vertices.size());)
+        // Remove vertices that are not used by any face.
+#if defined(VGL_USE_LD)
+        if(g_orphan_removal_reference)
         {
-            if(isOrphanedVertex(ii))
-            {
-                eraseOrphanedVertex(ii);
-            }
-            else
+            eraseOrphanedVerticesReference();
+        }
+        else
+#endif
+        {
+            vector<unsigned> remap(m_vertices.size());
+            for(unsigned ii = 0; (ii < m_vertices.size()); ++ii)
             {
-                ++ii;
+                remap[ii] = ii;
+                if(isOrphanedVertex(ii))
+                {
+                    remap[ii] = NO_VERTEX;
+                }
             }
+            eraseVertices(remap);
         }
         
         // Loop through vertices and remove identical ones.
@@ -549,12 +674,13 @@ public:
             removeIdenticalVertices();
         }
 
-        Fence ret = TaskDispatcher::wait_main(task_create_mesh, this);
-        return MeshUptr(static_cast<Mesh*>(ret.getReturnValue()));
+        return createMesh();
     }
 
     /// Create a mesh from the data in this logical mesh.
     ///
+    /// The mesh is not uploaded to the GPU.
+    ///
     /// \return Pointer to new mesh.
     Mesh* createMesh()
     {        
@@ -586,8 +712,10 @@ public:
             face.write(*ret);
         }
 
-        // Update to GPU before returning.
-        ret->update();
+#if defined(VGL_ENABLE_VERTEX_CACHE_OPTIMIZATION)
+        ret->getData().optimizeVertexCache();
+#endif
+
         return ret;
     }
 
@@ -771,16 +899,28 @@ public:
     }
 
 private:
-    /// Export a mesh from this logical mesh.
+    /// Upload a mesh to the GPU.
     ///
-    /// \param op Pointer to logical mesh.
-    static void* task_create_mesh(void* op)
+    /// \param op Pointer to mesh.
+    /// \return nullptr
+    static void* task_update_mesh(void* op)
     {
-        return static_cast<LogicalMesh*>(op)->createMesh();
+        static_cast<Mesh*>(op)->update();
+        return nullptr;
     }
 
 #if defined(VGL_USE_LD)
 public:
+    /// Select the orphaned vertex removal implementation.
+    ///
+    /// Only for benchmarks, must not be called while meshes are being compiled.
+    ///
+    /// \param op True to erase orphaned vertices one at a time, false for the compaction pass (default).
+    static void set_orphan_removal_reference(bool op)
+    {
+        g_orphan_removal_reference = op;
+    }
+
     /// Move operator.
     ///
     /// \param other Source object.
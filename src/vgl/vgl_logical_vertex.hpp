@@ -12,6 +12,49 @@
 namespace vgl
 {
 
+namespace detail
+{
+
+/// Map a float into an integer with the same ordering.
+///
+/// Adjacent representable floats map to adjacent integers, so integer distance equals distance in ulps.
+///
+/// \param op Float value.
+/// \return Ordered integer.
+inline int32_t float_to_ordered_int(float op) noexcept
+{
+    uint32_t bits = 0;
+    internal_memcpy(&bits, &op, sizeof(bits));
+    int32_t ret = static_cast<int32_t>(bits & 0x7FFFFFFFu);
+    return (bits & 0x80000000u) ? -ret : ret;
+}
+
+/// Mix a value into a hash.
+///
+/// \param hash Existing hash.
+/// \param op Value to mix in.
+/// \return New hash.
+constexpr uint32_t weld_hash_mix(uint32_t hash, uint32_t op) noexcept
+{
+    return (hash ^ op) * 16777619u;
+}
+
+/// Mix all components of an integer vector into a hash.
+///
+/// \param hash Existing hash.
+/// \param op Vector to mix in.
+/// \return New hash.
+constexpr uint32_t weld_hash_mix(uint32_t hash, const uvec4& op) noexcept
+{
+    for(unsigned ii = 0; (ii < 4); ++ii)
+    {
+        hash = weld_hash_mix(hash, op[ii]);
+    }
+    return hash;
+}
+
+}
+
 /// Logical vertex class.
 ///
 /// Only limited number of faces can attach to a vertex.
@@ -399,6 +442,49 @@ public:
             (m_bone_ref == rhs.m_bone_ref);
     }
 
+    /// Calculate the weld cell of this vertex.
+    ///
+    /// Position components are quantized into cells 32 ulps wide. Any vertex that matches this vertex is either in
+    /// the same cell or in one of the adjacent cells.
+    ///
+    /// \return Weld cell coordinates.
+    array<int32_t, 3> getWeldCell() const noexcept
+    {
+        return array<int32_t, 3>{detail::float_to_ordered_int(m_position[0u]) >> 5,
+            detail::float_to_ordered_int(m_position[1u]) >> 5,
+            detail::float_to_ordered_int(m_position[2u]) >> 5};
+    }
+
+    /// Calculate a weld hash for given weld cell.
+    ///
+    /// Attributes that must match exactly are mixed into the hash, attributes compared with tolerance are not.
+    ///
+    /// \param cell Weld cell coordinates.
+    /// \return Hash value.
+    constexpr uint32_t getWeldHash(const array<int32_t, 3>& cell) const noexcept
+    {
+        uint32_t ret = 2166136261u;
+        for(unsigned ii = 0; (ii < 3); ++ii)
+        {
+            ret = detail::weld_hash_mix(ret, static_cast<uint32_t>(cell[ii]));
+        }
+        if(m_color)
+        {
+            ret = detail::weld_hash_mix(ret, *m_color);
+        }
+        if(m_bone_ref)
+        {
+            ret = detail::weld_hash_mix(ret, m_bone_ref->getWeights());
+            ret = detail::weld_hash_mix(ret, m_bone_ref->getReferences());
+        }
+        // Multiplication only propagates bits upwards, finalize so low bits depend on all input.
+        ret ^= ret >> 16;
+        ret *= 0x85EBCA6Bu;
+        ret ^= ret >> 13;
+        ret *= 0xC2B2AE35u;
+        return ret ^ (ret >> 16);
+    }
+
     /// Write this vertex into a mesh.
     ///
     /// \param op Mesh to write to.
@@ -5,5 +5,9 @@ namespace vgl
 
 vector<GeometryBufferUptr> Mesh::g_geometry_buffers;
 
+#if defined(VGL_ENABLE_VERTEX_CACHE_OPTIMIZATION) && defined(VGL_USE_LD)
+detail::VertexCacheReport MeshData::g_vertex_cache_report;
+#endif
+
 }
 
@@ -25,6 +25,14 @@ private:
     /// Bounding box for the mesh.
     BoundingBox m_box;
 
+#if defined(VGL_ENABLE_MESH_LOD)
+    /// Next coarser level of detail or nullptr.
+    unique_ptr<Mesh> m_lod;
+
+    /// Geometric error of this level of detail compared to the full detail mesh.
+    float m_lod_error = 0.0f;
+#endif
+
 #if defined(VGL_USE_LD)
     /// Name of the mesh, for debugging.
     string m_name;
@@ -38,6 +46,30 @@ public:
     /// Default constructor.
     explicit Mesh() = default;
 
+#if defined(VGL_USE_LD)
+    /// Constructor from serialized data.
+    ///
+    /// \param op Reader positioned at data written by serialize().
+    explicit Mesh(PackedDataReader& op) :
+        m_data(op)
+    {
+        if(op.read<uint32_t>())
+        {
+            vec3 bmin = op.read<vec3>();
+            vec3 bmax = op.read<vec3>();
+            m_box = BoundingBox(bmin, bmax);
+        }
+#if defined(VGL_ENABLE_MESH_LOD)
+        if(op.read<uint32_t>())
+        {
+            float lod_error = op.read<float>();
+            m_lod.reset(new Mesh(op));
+            m_lod->m_lod_error = lod_error;
+        }
+#endif
+    }
+#endif
+
 public:
     /// Accessor.
     ///
@@ -99,6 +131,24 @@ public:
         m_handle->draw(op, GL_TRIANGLES, m_data.getIndexCount());
     }
 
+#if defined(VGL_ENABLE_INSTANCING)
+    /// Draw multiple instances of the mesh.
+    ///
+    /// \param op Program to draw with, must have a per-instance transform attribute.
+    /// \param transforms Per-instance transforms.
+    /// \param count Number of instances.
+    void drawInstanced(const GlslProgram& op, const mat4* transforms, unsigned count) const
+    {
+#if defined(VGL_USE_LD) && defined(DEBUG)
+        if(!m_handle)
+        {
+            VGL_THROW_RUNTIME_ERROR("cannot draw mesh with invalid geometry handle");
+        }
+#endif
+        m_handle->drawInstanced(op, GL_TRIANGLES, m_data.getIndexCount(), transforms, count);
+    }
+#endif
+
     /// End vertex input.
     ///
     /// Called after last vertes element has been written.
@@ -110,7 +160,7 @@ public:
     /// Write index data.
     ///
     /// \param op Index.
-    void write(uint16_t op)
+    void write(index_type op)
     {
         m_data.write(op);
     }
@@ -161,9 +211,37 @@ public:
         m_data.write(channel, data);
     }
 
+#if defined(VGL_ENABLE_STATIC_BATCHING)
+    /// Append another mesh into this with a transform applied.
+    ///
+    /// Must be called before the mesh is updated to the GPU.
+    ///
+    /// \param op Mesh to append.
+    /// \param transform Transform to apply.
+    /// \return True on success, false if the meshes are not compatible.
+    bool appendTransformed(const Mesh& op, const mat4& transform)
+    {
+        if(!op.m_box.isInitialized() || !m_data.appendTransformed(op.m_data, transform))
+        {
+            return false;
+        }
+        BoundingBox box = op.m_box.transform(transform);
+        m_box.addPoint(box.getMin());
+        m_box.addPoint(box.getMax());
+        return true;
+    }
+#endif
+
     /// Update to the GPU.
     void update()
     {
+#if defined(VGL_ENABLE_MESH_LOD)
+        if(m_lod)
+        {
+            m_lod->update();
+        }
+#endif
+
         // If handle already set, update existing data.
         if(m_handle)
         {
@@ -186,7 +264,106 @@ public:
         m_handle = GeometryHandle(*(g_geometry_buffers.back()), 0, 0);
     }
 
+#if defined(VGL_ENABLE_MESH_LOD)
+    /// Generate coarser levels of detail.
+    ///
+    /// Each level is simplified from this mesh with a grid cell size relative to the bounding box. Levels that would
+    /// not reduce the triangle count enough over the previous level are skipped.
+    void generateLods()
+    {
+        const unsigned LOD_DIVISIONS[] = {64, 24, 8};
+
+        if(!m_box.isInitialized())
+        {
+            return;
+        }
+        vec3 extent = m_box.getMax() - m_box.getMin();
+        float size = max(max(extent.x(), extent.y()), extent.z());
+
+        Mesh* prev = this;
+        for(const auto& vv : LOD_DIVISIONS)
+        {
+            unique_ptr<Mesh> lod(new Mesh());
+            float error = m_data.simplify(lod->m_data, size / static_cast<float>(vv));
+            unsigned index_count = lod->m_data.getIndexCount();
+            if(!index_count)
+            {
+                break;
+            }
+            if((index_count * 4) > (prev->m_data.getIndexCount() * 3))
+            {
+                continue;
+            }
+#if defined(VGL_ENABLE_VERTEX_CACHE_OPTIMIZATION)
+            lod->m_data.optimizeVertexCache();
+#endif
+            lod->m_box = m_box;
+            lod->m_lod_error = max(error, prev->m_lod_error);
+            prev->m_lod = move(lod);
+            prev = prev->m_lod.get();
+        }
+    }
+
+    /// Select a level of detail.
+    ///
+    /// \param op Maximum allowed geometric error.
+    /// \return Coarsest level of detail with error within given limit.
+    const Mesh& selectLod(float op) const noexcept
+    {
+        const Mesh* ret = this;
+        while(ret->m_lod && (ret->m_lod->m_lod_error <= op))
+        {
+            ret = ret->m_lod.get();
+        }
+        return *ret;
+    }
+#endif
+
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+    /// Quantize vertex data of this mesh and all levels of detail.
+    ///
+    /// Levels of detail share the bounding box and thus the quantization grid.
+    void quantize()
+    {
+        if(!m_box.isInitialized())
+        {
+            return;
+        }
+        m_data.quantize(m_box.getMin(), m_box.getMax());
+#if defined(VGL_ENABLE_MESH_LOD)
+        if(m_lod)
+        {
+            m_lod->quantize();
+        }
+#endif
+    }
+#endif
+
 #if defined(VGL_USE_LD)
+    /// Serialize the mesh.
+    ///
+    /// Stores mesh data, bounding box and levels of detail, but not the geometry handle or name.
+    ///
+    /// \param op Packed data to append to.
+    void serialize(PackedData& op) const
+    {
+        m_data.serialize(op);
+        op.push<uint32_t>(m_box.isInitialized() ? 1u : 0u);
+        if(m_box.isInitialized())
+        {
+            op.push(m_box.getMin());
+            op.push(m_box.getMax());
+        }
+#if defined(VGL_ENABLE_MESH_LOD)
+        op.push<uint32_t>(m_lod ? 1u : 0u);
+        if(m_lod)
+        {
+            op.push(m_lod->m_lod_error);
+            m_lod->serialize(op);
+        }
+#endif
+    }
+
     /// Accessor.
     ///
     /// \return Name.
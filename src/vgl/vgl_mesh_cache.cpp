@@ -0,0 +1,276 @@
+#include "vgl_mesh_cache.hpp"
+
+#include <cstdio>
+#include <iostream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vgl
+{
+
+namespace detail
+{
+
+MeshCacheKey::MeshCacheKey(bool remove_identical, bool lod, bool quantize)
+{
+    add<uint32_t>(MeshCache::VERSION);
+    add<uint8_t>(remove_identical ? 1u : 0u);
+#if defined(VGL_ENABLE_MESH_LOD)
+    add<uint8_t>(lod ? 1u : 0u);
+#else
+    (void)lod;
+    add<uint8_t>(0u);
+#endif
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+    add<uint8_t>(quantize ? 1u : 0u);
+#else
+    (void)quantize;
+    add<uint8_t>(0u);
+#endif
+#if defined(VGL_ENABLE_VERTEX_CACHE_OPTIMIZATION)
+    add<uint8_t>(1u);
+#else
+    add<uint8_t>(0u);
+#endif
+#if defined(VGL_ENABLE_VERTEX_NORMAL_PACKING)
+    add<uint8_t>(1u);
+#else
+    add<uint8_t>(0u);
+#endif
+    add<uint8_t>(static_cast<uint8_t>(sizeof(index_type)));
+}
+
+void MeshCacheKey::add(const LogicalMesh& op)
+{
+    add<uint32_t>(op.getLogicalVertexCount());
+    for(unsigned ii = 0; (ii < op.getLogicalVertexCount()); ++ii)
+    {
+        const LogicalVertex& vertex = op.getLogicalVertex(ii);
+        add(vertex.getPosition());
+        add(vertex.getNormal());
+        add(vertex.getTexcoord());
+        add(vertex.getColor());
+        add(vertex.getWeights());
+        add(vertex.getReferences());
+    }
+
+    add<uint32_t>(op.getLogicalFaceCount());
+    for(unsigned ii = 0; (ii < op.getLogicalFaceCount()); ++ii)
+    {
+        const LogicalFace& face = op.getLogicalFace(ii);
+        add<uint32_t>(face.getNumCorners());
+        for(unsigned jj = 0; (jj < face.getNumCorners()); ++jj)
+        {
+            add<uint32_t>(face.getIndex(jj));
+            add(face.getTexcoord(jj));
+        }
+        add(face.getColor());
+        add<uint8_t>(face.isFlat() ? 1u : 0u);
+    }
+}
+
+}
+
+const uint32_t MeshCache::VERSION;
+const uint32_t MeshCache::MAGIC;
+const unsigned MeshCache::HEADER_SIZE;
+const unsigned MeshCache::ENTRY_HEADER_SIZE;
+
+unique_ptr<MeshCache> MeshCache::g_instance;
+
+MeshCache::MeshCache(const path& filename) :
+    m_filename(filename)
+{
+    if(!m_filename.exists())
+    {
+        return;
+    }
+
+    const uint8_t* data = map();
+    size_t size = m_mapping ? m_mapping_size : m_contents.size();
+    if(!data || !parse(data, size))
+    {
+        std::cerr << "MeshCache: ignoring invalid or outdated cache '" << m_filename.getString() << "'" << std::endl;
+        m_entries.clear();
+        unmap();
+        return;
+    }
+
+    std::cout << "MeshCache: " << m_entries.size() << " meshes in '" << m_filename.getString() << "'" << std::endl;
+}
+
+MeshCache::~MeshCache()
+{
+    if(m_hits + m_misses)
+    {
+        std::cout << "MeshCache: " << m_hits << " of " << (m_hits + m_misses) << " meshes loaded from cache" <<
+            std::endl;
+    }
+
+    if(m_stored_count)
+    {
+        write();
+    }
+    unmap();
+}
+
+const uint8_t* MeshCache::map()
+{
+#if !defined(_WIN32)
+    int fd = open(m_filename.getString().c_str(), O_RDONLY);
+    if(fd >= 0)
+    {
+        struct stat st;
+        if((fstat(fd, &st) == 0) && (st.st_size > 0))
+        {
+            void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if(mapping != MAP_FAILED)
+            {
+                m_mapping = mapping;
+                m_mapping_size = static_cast<size_t>(st.st_size);
+            }
+        }
+        close(fd);
+        if(m_mapping)
+        {
+            return static_cast<const uint8_t*>(m_mapping);
+        }
+    }
+#endif
+
+    // Fall back to reading the whole file.
+    optional<vector<uint8_t>> contents = m_filename.readToVector();
+    if(!contents || contents->empty())
+    {
+        return nullptr;
+    }
+    m_contents = move(*contents);
+    return m_contents.data();
+}
+
+void MeshCache::unmap()
+{
+#if !defined(_WIN32)
+    if(m_mapping)
+    {
+        munmap(m_mapping, m_mapping_size);
+    }
+#endif
+    m_mapping = nullptr;
+    m_mapping_size = 0;
+    m_contents.clear();
+}
+
+bool MeshCache::parse(const uint8_t* data, size_t size)
+{
+    if((size < HEADER_SIZE) || (size > 0xFFFFFFFFu))
+    {
+        return false;
+    }
+
+    PackedDataReader reader(data, static_cast<unsigned>(size));
+    if((reader.read<uint32_t>() != MAGIC) || (reader.read<uint32_t>() != VERSION))
+    {
+        return false;
+    }
+    unsigned entry_count = reader.read<uint32_t>();
+    reader.align(HEADER_SIZE);
+
+    for(unsigned ii = 0; (ii < entry_count); ++ii)
+    {
+        if(reader.remaining() < ENTRY_HEADER_SIZE)
+        {
+            return false;
+        }
+        uint64_t key = reader.read<uint64_t>();
+        unsigned entry_size = reader.read<uint32_t>();
+        reader.read<uint32_t>();
+        if(reader.remaining() < entry_size)
+        {
+            return false;
+        }
+        m_entries.emplace_back(key, &reader.read<uint8_t>(entry_size), entry_size);
+        reader.align(8);
+    }
+    return true;
+}
+
+bool MeshCache::write() const
+{
+    PackedData contents;
+    contents.push<uint32_t>(MAGIC);
+    contents.push<uint32_t>(VERSION);
+    contents.push<uint32_t>(0u);
+    contents.align(HEADER_SIZE);
+
+    // Entries not used during this run are considered stale and dropped.
+    unsigned entry_count = m_stored_count;
+    for(const auto& vv : m_entries)
+    {
+        if(vv.isUsed())
+        {
+            contents.push<uint64_t>(vv.getKey());
+            contents.push<uint32_t>(vv.getSize());
+            contents.push<uint32_t>(0u);
+            contents.append(vv.getData(), vv.getSize());
+            contents.align(8);
+            ++entry_count;
+        }
+    }
+    contents.append(m_stored);
+    static_cast<uint32_t*>(contents.data())[2] = entry_count;
+
+    // Write into a temporary file first, the current file may still be mapped.
+    path tmp_filename = path(m_filename.getString() + ".tmp");
+    if(!tmp_filename.write(string_view(static_cast<const char*>(contents.data()), contents.size())))
+    {
+        return false;
+    }
+    if(std::rename(tmp_filename.getString().c_str(), m_filename.getString().c_str()))
+    {
+        std::cerr << "MeshCache: could not replace '" << m_filename.getString() << "'" << std::endl;
+        return false;
+    }
+
+    std::cout << "MeshCache: wrote " << entry_count << " meshes (" << contents.size() << " bytes) to '" <<
+        m_filename.getString() << "'" << std::endl;
+    return true;
+}
+
+Mesh* MeshCache::load(uint64_t key)
+{
+    for(auto& vv : m_entries)
+    {
+        if(vv.getKey() == key)
+        {
+            PackedDataReader reader(vv.getData(), vv.getSize());
+            Mesh* ret = new Mesh(reader);
+            vv.setUsed();
+            ++m_hits;
+            return ret;
+        }
+    }
+
+    ++m_misses;
+    return nullptr;
+}
+
+void MeshCache::store(uint64_t key, const Mesh& mesh)
+{
+    PackedData data;
+    mesh.serialize(data);
+
+    m_stored.push<uint64_t>(key);
+    m_stored.push<uint32_t>(data.size());
+    m_stored.push<uint32_t>(0u);
+    m_stored.append(data);
+    m_stored.align(8);
+    ++m_stored_count;
+}
+
+}
@@ -0,0 +1,292 @@
+#ifndef VGL_MESH_CACHE_HPP
+#define VGL_MESH_CACHE_HPP
+
+/// \file Compiled mesh cache.
+/// This file only makes sense when not building size-minimized. It's not header-only.
+
+#include "vgl_config.hpp"
+
+#if defined(VGL_USE_LD)
+
+#include "vgl_filesystem.hpp"
+#include "vgl_logical_mesh.hpp"
+
+namespace vgl
+{
+
+namespace detail
+{
+
+/// Key calculation for the mesh cache.
+///
+/// 64-bit FNV-1a over all compilation input. The cache format version and compilation settings are always included,
+/// so changing either invalidates existing entries.
+///
+/// The constructor is defined in the source file, since the version is only known after the cache class.
+class MeshCacheKey
+{
+private:
+    /// Current hash value.
+    uint64_t m_hash = 14695981039346656037ull;
+
+public:
+    /// Constructor.
+    ///
+    /// \param remove_identical Flag determining whether to perform the identical vertex erase pass.
+    /// \param lod Flag determining whether to generate levels of detail.
+    /// \param quantize Flag determining whether to quantize vertex data.
+    explicit MeshCacheKey(bool remove_identical, bool lod, bool quantize);
+
+public:
+    /// Accessor.
+    ///
+    /// \return Key value.
+    constexpr uint64_t get() const noexcept
+    {
+        return m_hash;
+    }
+
+    /// Add raw data.
+    ///
+    /// \param data Data to add.
+    /// \param count Data size in bytes.
+    void add(const void* data, unsigned count)
+    {
+        const uint8_t* src = static_cast<const uint8_t*>(data);
+        for(unsigned ii = 0; (ii < count); ++ii)
+        {
+            m_hash = (m_hash ^ src[ii]) * 1099511628211ull;
+        }
+    }
+
+    /// Add a value.
+    ///
+    /// \param op Value to add.
+    template<typename T> void add(const T& op)
+    {
+        add(&op, static_cast<unsigned>(sizeof(T)));
+    }
+
+    /// Add an optional value.
+    ///
+    /// \param op Optional value to add.
+    template<typename T> void add(const optional<T>& op)
+    {
+        add<uint8_t>(op ? 1u : 0u);
+        if(op)
+        {
+            add(*op);
+        }
+    }
+
+    /// Add a logical mesh.
+    ///
+    /// \param op Logical mesh to add.
+    void add(const LogicalMesh& op);
+};
+
+/// Loaded mesh cache entry.
+class MeshCacheEntry
+{
+private:
+    /// Serialized mesh.
+    const uint8_t* m_data;
+
+    /// Serialized mesh size in bytes.
+    unsigned m_size;
+
+    /// Key.
+    uint64_t m_key;
+
+    /// Was the entry used during this run?
+    bool m_used = false;
+
+public:
+    /// Constructor.
+    ///
+    /// \param key Key.
+    /// \param data Serialized mesh.
+    /// \param size Serialized mesh size in bytes.
+    constexpr explicit MeshCacheEntry(uint64_t key, const uint8_t* data, unsigned size) noexcept :
+        m_data(data),
+        m_size(size),
+        m_key(key)
+    {
+    }
+
+public:
+    /// Accessor.
+    ///
+    /// \return Serialized mesh.
+    constexpr const uint8_t* getData() const noexcept
+    {
+        return m_data;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Serialized mesh size in bytes.
+    constexpr unsigned getSize() const noexcept
+    {
+        return m_size;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Key.
+    constexpr uint64_t getKey() const noexcept
+    {
+        return m_key;
+    }
+
+    /// Tell if the entry was used.
+    ///
+    /// \return True if used during this run.
+    constexpr bool isUsed() const noexcept
+    {
+        return m_used;
+    }
+
+    /// Mark the entry as used.
+    constexpr void setUsed() noexcept
+    {
+        m_used = true;
+    }
+};
+
+}
+
+/// Compiled mesh cache.
+///
+/// Stores compiled meshes keyed by a hash of their compilation input, so CSG evaluation and compilation can be
+/// skipped on subsequent runs. The cache file is memory-mapped and meshes are constructed directly from the mapping.
+/// Entries used or added during the run are written back when the cache is destroyed.
+///
+/// Not thread-safe. Meshes are loaded and stored by MeshCompiler from the thread that owns the compiler, i.e. the
+/// data initialization task, never from the compile tasks themselves. Only one mesh compiler may use the cache at a
+/// time. The cache is enabled before any tasks are dispatched and written on destruction at exit.
+class MeshCache
+{
+public:
+    /// Cache file format version.
+    ///
+    /// Must be incremented whenever the file format or the output of mesh compilation changes.
+    static const uint32_t VERSION = 4;
+
+private:
+    /// File header magic.
+    static const uint32_t MAGIC = 0x4d4c4756u;
+
+    /// File header size, header fields are magic, version and entry count.
+    static const unsigned HEADER_SIZE = 16;
+
+    /// Entry header size, header fields are key and size.
+    static const unsigned ENTRY_HEADER_SIZE = 16;
+
+private:
+    /// Loaded entries.
+    vector<detail::MeshCacheEntry> m_entries;
+
+    /// Serialized entries added during this run, including entry headers.
+    PackedData m_stored;
+
+    /// Cache filename.
+    path m_filename;
+
+    /// Mapped file contents or nullptr.
+    void* m_mapping = nullptr;
+
+    /// Mapped file size.
+    size_t m_mapping_size = 0;
+
+    /// File contents if memory mapping is not available.
+    vector<uint8_t> m_contents;
+
+    /// Number of entries added during this run.
+    unsigned m_stored_count = 0;
+
+    /// Number of meshes loaded from the cache.
+    unsigned m_hits = 0;
+
+    /// Number of meshes not found in the cache.
+    unsigned m_misses = 0;
+
+private:
+    /// Global mesh cache, nullptr if not enabled.
+    static unique_ptr<MeshCache> g_instance;
+
+public:
+    /// Constructor.
+    ///
+    /// Reads the cache file if it exists and is of the current version.
+    ///
+    /// \param filename Cache filename.
+    explicit MeshCache(const path& filename);
+
+    /// Destructor.
+    ///
+    /// Writes the cache file if any meshes were added.
+    ~MeshCache();
+
+    /// Deleted copy constructor.
+    MeshCache(const MeshCache&) = delete;
+    /// Deleted assignment.
+    MeshCache& operator=(const MeshCache&) = delete;
+
+private:
+    /// Map the cache file into memory.
+    ///
+    /// \return Pointer to file contents or nullptr.
+    const uint8_t* map();
+
+    /// Release the mapped file.
+    void unmap();
+
+    /// Parse entries from file contents.
+    ///
+    /// \param data File contents.
+    /// \param size File size in bytes.
+    /// \return True if contents were valid, false otherwise.
+    bool parse(const uint8_t* data, size_t size);
+
+    /// Write the cache file.
+    ///
+    /// \return True if the file was completely written.
+    bool write() const;
+
+public:
+    /// Load a mesh from the cache.
+    ///
+    /// \param key Mesh key.
+    /// \return New mesh or nullptr if not found.
+    Mesh* load(uint64_t key);
+
+    /// Store a mesh into the cache.
+    ///
+    /// \param key Mesh key.
+    /// \param mesh Compiled mesh.
+    void store(uint64_t key, const Mesh& mesh);
+
+public:
+    /// Enable the global mesh cache.
+    ///
+    /// \param op Cache filename.
+    static void enable(const path& op)
+    {
+        g_instance.reset(new MeshCache(op));
+    }
+
+    /// Accessor.
+    ///
+    /// \return Global mesh cache or nullptr if not enabled.
+    static MeshCache* get_instance()
+    {
+        return g_instance.get();
+    }
+};
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,384 @@
+#ifndef VGL_MESH_COMPILER_HPP
+#define VGL_MESH_COMPILER_HPP
+
+#include "vgl_logical_mesh.hpp"
+
+#if defined(VGL_USE_LD)
+#include "vgl_mesh_cache.hpp"
+#endif
+
+namespace vgl
+{
+
+namespace detail
+{
+
+/// Single mesh compilation job.
+class MeshCompileJob
+{
+private:
+#if !defined(VGL_DISABLE_CSG)
+    /// CSG input data (empty if constructed from a logical mesh).
+    vector<int16_t> m_data;
+#endif
+
+    /// Logical mesh to compile (constructed from CSG data if not given).
+    unique_ptr<LogicalMesh> m_logical_mesh;
+
+    /// Compiled mesh, not yet uploaded to the GPU.
+    Mesh* m_mesh = nullptr;
+
+    /// Target to store the mesh into when finished.
+    MeshUptr& m_target;
+
+    /// Fence for the compile task.
+    Fence m_fence = Fence(nullptr);
+
+    /// Flag determining whether to perform the identical vertex erase pass.
+    bool m_remove_identical;
+
+    /// Flag determining whether to generate levels of detail.
+    bool m_lod;
+
+    /// Flag determining whether to quantize vertex data.
+    bool m_quantize;
+
+#if defined(VGL_USE_LD)
+    /// Mesh cache key.
+    uint64_t m_cache_key = 0;
+
+    /// Should the compiled mesh be stored into the mesh cache?
+    bool m_cache_store = false;
+#endif
+
+public:
+#if !defined(VGL_DISABLE_CSG)
+    /// Constructor.
+    ///
+    /// \param target Target to store the mesh into.
+    /// \param data CSG input data.
+    /// \param remove_identical Flag determining whether to perform the identical vertex erase pass.
+    /// \param lod Flag determining whether to generate levels of detail.
+    /// \param quantize Flag determining whether to quantize vertex data.
+    explicit MeshCompileJob(MeshUptr& target, vector<int16_t>&& data, bool remove_identical, bool lod,
+            bool quantize) :
+        m_data(move(data)),
+        m_target(target),
+        m_remove_identical(remove_identical),
+        m_lod(lod),
+        m_quantize(quantize)
+    {
+    }
+#endif
+
+    /// Constructor.
+    ///
+    /// \param target Target to store the mesh into.
+    /// \param lmesh Logical mesh.
+    /// \param remove_identical Flag determining whether to perform the identical vertex erase pass.
+    /// \param lod Flag determining whether to generate levels of detail.
+    /// \param quantize Flag determining whether to quantize vertex data.
+    explicit MeshCompileJob(MeshUptr& target, LogicalMesh&& lmesh, bool remove_identical, bool lod,
+            bool quantize) :
+        m_logical_mesh(new LogicalMesh(move(lmesh))),
+        m_target(target),
+        m_remove_identical(remove_identical),
+        m_lod(lod),
+        m_quantize(quantize)
+    {
+    }
+
+    /// Destructor.
+    ~MeshCompileJob()
+    {
+        // Fence must be waited on before releasing anything the compile task might access.
+        m_fence = Fence(nullptr);
+        delete m_mesh;
+    }
+
+    /// Deleted copy constructor.
+    MeshCompileJob(const MeshCompileJob&) = delete;
+    /// Deleted assignment.
+    MeshCompileJob& operator=(const MeshCompileJob&) = delete;
+
+private:
+    /// Compile the mesh.
+    ///
+    /// Performs CSG evaluation, compilation, level of detail generation and quantization, but not GPU upload.
+    void compile()
+    {
+#if !defined(VGL_DISABLE_CSG)
+        if(!m_logical_mesh)
+        {
+            m_logical_mesh.reset(new LogicalMesh(m_data.data()));
+        }
+#endif
+        m_mesh = m_logical_mesh->compileMesh(m_remove_identical);
+        m_logical_mesh.reset();
+#if defined(VGL_ENABLE_MESH_LOD)
+        if(m_lod)
+        {
+            m_mesh->generateLods();
+        }
+#endif
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+        if(m_quantize)
+        {
+            m_mesh->quantize();
+        }
+#endif
+    }
+
+public:
+#if defined(VGL_USE_LD)
+    /// Try to load the compiled mesh from the mesh cache.
+    ///
+    /// If the mesh cache is enabled but the mesh is not found, it will be stored when finished.
+    ///
+    /// Must be called from the thread owning the mesh compiler, the mesh cache is not thread-safe.
+    ///
+    /// \return True if loaded, false if compilation is still required.
+    bool loadCached()
+    {
+        MeshCache* cache = MeshCache::get_instance();
+        if(!cache)
+        {
+            return false;
+        }
+
+        detail::MeshCacheKey key(m_remove_identical, m_lod, m_quantize);
+        if(m_logical_mesh)
+        {
+            key.add(*m_logical_mesh);
+        }
+#if !defined(VGL_DISABLE_CSG)
+        else
+        {
+            key.add(m_data.data(), m_data.getSizeBytes());
+        }
+#endif
+        m_cache_key = key.get();
+
+        m_mesh = cache->load(m_cache_key);
+        if(!m_mesh)
+        {
+            m_cache_store = true;
+            return false;
+        }
+        m_logical_mesh.reset();
+        return true;
+    }
+#endif
+
+    /// Dispatch compilation to any thread.
+    void dispatch()
+    {
+        m_fence = TaskDispatcher::wait(task_compile, this);
+    }
+
+    /// Tell if compilation has finished.
+    ///
+    /// \return True if finished, false otherwise.
+    bool isReady() const
+    {
+        return !m_fence.getData() || !m_fence;
+    }
+
+    /// Wait for compilation to finish.
+    void wait()
+    {
+        m_fence = Fence(nullptr);
+    }
+
+    /// Upload the compiled mesh to the GPU.
+    ///
+    /// Must be called from the main thread.
+    void upload()
+    {
+        m_mesh->update();
+    }
+
+    /// Store the compiled mesh into its target.
+    ///
+    /// Must be called from the thread owning the mesh compiler, the mesh cache is not thread-safe.
+    void finish()
+    {
+#if defined(VGL_USE_LD)
+        if(m_cache_store)
+        {
+            MeshCache::get_instance()->store(m_cache_key, *m_mesh);
+        }
+#endif
+        m_target.reset(m_mesh);
+        m_mesh = nullptr;
+    }
+
+private:
+    /// Compile task.
+    ///
+    /// \param op Pointer to mesh compile job.
+    /// \return nullptr
+    static void* task_compile(void* op)
+    {
+        static_cast<MeshCompileJob*>(op)->compile();
+        return nullptr;
+    }
+};
+
+/// Mesh compile job unique pointer type.
+using MeshCompileJobUptr = unique_ptr<MeshCompileJob>;
+
+}
+
+/// Parallel mesh compiler.
+///
+/// Logical mesh construction and compilation of added meshes is dispatched to worker threads. GPU uploads are
+/// batched on the main thread in the order the meshes were added, so geometry buffer layout does not depend on
+/// thread timing.
+///
+/// When the mesh cache is enabled, meshes found in the cache are not compiled at all.
+class MeshCompiler
+{
+private:
+    /// Compile jobs in order of addition.
+    vector<detail::MeshCompileJobUptr> m_jobs;
+
+    /// First job of the upload batch.
+    unsigned m_upload_begin = 0;
+
+    /// One past the last job of the upload batch.
+    unsigned m_upload_end = 0;
+
+#if defined(VGL_USE_LD)
+    /// Number of meshes compiled.
+    unsigned m_mesh_count = 0;
+
+    /// Number of upload batches.
+    unsigned m_batch_count = 0;
+#endif
+
+public:
+    /// Default constructor.
+    explicit MeshCompiler() = default;
+
+    /// Destructor.
+    ~MeshCompiler()
+    {
+#if defined(VGL_USE_LD)
+        if(m_mesh_count)
+        {
+            std::cout << "MeshCompiler: " << m_mesh_count << " meshes in " << m_batch_count << " upload batches" <<
+                std::endl;
+        }
+#endif
+    }
+
+    /// Deleted copy constructor.
+    MeshCompiler(const MeshCompiler&) = delete;
+    /// Deleted assignment.
+    MeshCompiler& operator=(const MeshCompiler&) = delete;
+
+private:
+    /// Add a compile job and dispatch it.
+    ///
+    /// \param op Job to add.
+    void addJob(detail::MeshCompileJob* op)
+    {
+        m_jobs.emplace_back(op);
+#if defined(VGL_USE_LD)
+        if(op->loadCached())
+        {
+            return;
+        }
+#endif
+        op->dispatch();
+    }
+
+    /// Upload the current batch of compiled meshes.
+    void uploadBatch()
+    {
+        for(unsigned ii = m_upload_begin; (ii < m_upload_end); ++ii)
+        {
+            m_jobs[ii]->upload();
+        }
+    }
+
+public:
+#if !defined(VGL_DISABLE_CSG)
+    /// Add a mesh to be compiled from CSG data.
+    ///
+    /// \param target Target to store the mesh into when finished.
+    /// \param data CSG input data.
+    /// \param remove_identical Flag determining whether to perform the identical vertex erase pass (default: true).
+    /// \param lod Flag determining whether to generate levels of detail (default: false).
+    /// \param quantize Flag determining whether to quantize vertex data (default: false).
+    void add(MeshUptr& target, vector<int16_t>&& data, bool remove_identical = true, bool lod = false,
+            bool quantize = false)
+    {
+        addJob(new detail::MeshCompileJob(target, move(data), remove_identical, lod, quantize));
+    }
+#endif
+
+    /// Add a mesh to be compiled from a logical mesh.
+    ///
+    /// \param target Target to store the mesh into when finished.
+    /// \param lmesh Logical mesh.
+    /// \param remove_identical Flag determining whether to perform the identical vertex erase pass (default: true).
+    /// \param lod Flag determining whether to generate levels of detail (default: false).
+    /// \param quantize Flag determining whether to quantize vertex data (default: false).
+    void add(MeshUptr& target, LogicalMesh&& lmesh, bool remove_identical = true, bool lod = false,
+            bool quantize = false)
+    {
+        addJob(new detail::MeshCompileJob(target, move(lmesh), remove_identical, lod, quantize));
+    }
+
+    /// Finish compiling all added meshes.
+    ///
+    /// Waits for compilation in order of addition. Every time a mesh is ready, it is uploaded together with all
+    /// subsequent meshes that are also ready. After this call, all targets contain their meshes.
+    void finish()
+    {
+        for(unsigned ii = 0; (ii < m_jobs.size());)
+        {
+            m_jobs[ii]->wait();
+            unsigned jj = ii + 1;
+            while((jj < m_jobs.size()) && m_jobs[jj]->isReady())
+            {
+                m_jobs[jj]->wait();
+                ++jj;
+            }
+
+            m_upload_begin = ii;
+            m_upload_end = jj;
+            TaskDispatcher::wait_main(task_upload_batch, this);
+#if defined(VGL_USE_LD)
+            ++m_batch_count;
+#endif
+            ii = jj;
+        }
+
+        for(auto& vv : m_jobs)
+        {
+            vv->finish();
+        }
+#if defined(VGL_USE_LD)
+        m_mesh_count += m_jobs.size();
+#endif
+        m_jobs.clear();
+    }
+
+private:
+    /// Upload batch task.
+    ///
+    /// \param op Pointer to mesh compiler.
+    /// \return nullptr
+    static void* task_upload_batch(void* op)
+    {
+        static_cast<MeshCompiler*>(op)->uploadBatch();
+        return nullptr;
+    }
+};
+
+}
+
+#endif
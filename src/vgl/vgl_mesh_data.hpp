@@ -6,15 +6,28 @@
 #include "vgl_geometry_handle.hpp"
 #include "vgl_glsl_program.hpp"
 #include "vgl_packed_data.hpp"
+#include "vgl_packed_data_reader.hpp"
 #include "vgl_state.hpp"
 #include "vgl_vec2.hpp"
 #include "vgl_vec3.hpp"
 #include "vgl_uvec4.hpp"
 
+#if defined(VGL_ENABLE_MESH_LOD)
+#include "vgl_mesh_simplifier.hpp"
+#endif
+
+#if defined(VGL_ENABLE_VERTEX_CACHE_OPTIMIZATION)
+#include "vgl_vertex_cache_optimizer.hpp"
+#endif
+
 #if defined(VGL_ENABLE_VERTEX_NORMAL_PACKING)
 #include "vgl_ivec3.hpp"
 #endif
 
+#if defined(VGL_ENABLE_STATIC_BATCHING) || defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+#include "vgl_mat4.hpp"
+#endif
+
 namespace vgl
 {
 
@@ -68,6 +81,25 @@ public:
         {
         }
 
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION) || defined(VGL_USE_LD)
+        /// Constructor with explicit element format.
+        ///
+        /// \param channel Channel ID.
+        /// \param offset Offset of the channel.
+        /// \param element_count Number of elements.
+        /// \param type Element type.
+        /// \param normalized Element normalized or not.
+        constexpr explicit ChannelInfo(GeometryChannel channel, unsigned offset, GLint element_count, GLenum type,
+                GLboolean normalized) noexcept :
+            m_semantic(channel),
+            m_element_count(element_count),
+            m_type(type),
+            m_normalized(normalized),
+            m_offset(offset)
+        {
+        }
+#endif
+
     public:
         /// Accessor.
         ///
@@ -77,6 +109,38 @@ public:
             return m_semantic;
         }
 
+        /// Accessor.
+        ///
+        /// \return Number of elements in this channel.
+        constexpr GLint getElementCount() const noexcept
+        {
+            return m_element_count;
+        }
+
+        /// Accessor.
+        ///
+        /// \return Element type.
+        constexpr GLenum getType() const noexcept
+        {
+            return m_type;
+        }
+
+        /// Accessor.
+        ///
+        /// \return Element normalized or not.
+        constexpr GLboolean isNormalized() const noexcept
+        {
+            return m_normalized;
+        }
+
+        /// Accessor.
+        ///
+        /// \return Offset of the channel.
+        constexpr unsigned getOffset() const noexcept
+        {
+            return m_offset;
+        }
+
         /// Bind for drawing.
         ///
         /// \param prog Program to bind with.
@@ -144,7 +208,7 @@ private:
     PackedData m_vertex_data;
 
     /// Raw data.
-    vector<uint16_t> m_index_data;
+    vector<index_type> m_index_data;
 
     /// Channel info.
     vector<ChannelInfo> m_channels;
@@ -155,6 +219,19 @@ private:
     /// Vertex count.
     unsigned m_vertex_count = 0;
 
+#if defined(VGL_ENABLE_VERTEX_CACHE_OPTIMIZATION) && defined(VGL_USE_LD)
+    /// Vertex cache statistics of all optimized mesh data.
+    static detail::VertexCacheReport g_vertex_cache_report;
+#endif
+
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+    /// Scale from quantized positions to mesh space.
+    float m_position_scale = 1.0f;
+
+    /// Offset from quantized positions to mesh space.
+    vec3 m_position_offset = vec3(0.0f, 0.0f, 0.0f);
+#endif
+
 public:
     /// Default constructor.
     constexpr explicit MeshData() noexcept
@@ -168,6 +245,10 @@ public:
         m_vertex_data(op.m_vertex_data),
         m_stride(op.m_stride),
         m_vertex_count(op.m_vertex_count)
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+        , m_position_scale(op.m_position_scale),
+        m_position_offset(op.m_position_offset)
+#endif
     {
         for(const auto& vv : op.m_index_data)
         {
@@ -180,6 +261,44 @@ public:
         }
     }
 
+#if defined(VGL_USE_LD)
+    /// Constructor from serialized data.
+    ///
+    /// \param op Reader positioned at data written by serialize().
+    explicit MeshData(PackedDataReader& op)
+    {
+        m_stride = static_cast<GLsizei>(op.read<uint32_t>());
+        m_vertex_count = op.read<uint32_t>();
+
+        unsigned channel_count = op.read<uint32_t>();
+        for(unsigned ii = 0; (ii < channel_count); ++ii)
+        {
+            GeometryChannel channel = static_cast<GeometryChannel>(op.read<uint32_t>());
+            unsigned offset = op.read<uint32_t>();
+            GLint element_count = static_cast<GLint>(op.read<uint32_t>());
+            GLenum type = static_cast<GLenum>(op.read<uint32_t>());
+            GLboolean normalized = static_cast<GLboolean>(op.read<uint32_t>());
+            m_channels.emplace_back(channel, offset, element_count, type, normalized);
+        }
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+        m_position_scale = op.read<float>();
+        m_position_offset = op.read<vec3>();
+#endif
+
+        unsigned vertex_bytes = op.read<uint32_t>();
+        m_vertex_data.append(&op.read<uint8_t>(vertex_bytes), vertex_bytes);
+        op.align(4);
+
+        unsigned index_count = op.read<uint32_t>();
+        const index_type* indices = &op.read<index_type>(index_count);
+        for(unsigned ii = 0; (ii < index_count); ++ii)
+        {
+            m_index_data.push_back(indices[ii]);
+        }
+        op.align(4);
+    }
+#endif
+
 private:
     /// Set channel information.
     ///
@@ -229,6 +348,14 @@ public:
         return m_index_data.size();
     }
 
+    /// Accessor.
+    ///
+    /// \return Index data.
+    constexpr const vector<index_type>& getIndexData() const noexcept
+    {
+        return m_index_data;
+    }
+
     /// Accessor.
     ///
     /// \return Offset at the end of index buffer.
@@ -276,7 +403,7 @@ public:
     /// Write index data.
     ///
     /// \param op Index.
-    void write(uint16_t op)
+    void write(index_type op)
     {
         m_index_data.push_back(op);
     }
@@ -330,22 +457,363 @@ public:
     /// \param op Another data block.
     void append(const MeshData& op)
     {
-#if defined(VGL_USE_LD)
+#if defined(VGL_USE_LD) && !defined(VGL_ENABLE_32BIT_INDICES)
         if((m_vertex_count + op.getVertexCount()) > 0xFFFFu)
         {
             VGL_THROW_RUNTIME_ERROR("trying to merge mesh data sets beyond 16 bit index scope");
         }
 #endif
-        uint16_t index_offset = static_cast<uint16_t>(m_vertex_count);
+        index_type index_offset = static_cast<index_type>(m_vertex_count);
 
         m_vertex_data.append(op.m_vertex_data);
         m_vertex_count += op.getVertexCount();
 
         for(const auto& vv : op.m_index_data)
         {
-            m_index_data.push_back(static_cast<uint16_t>(vv + index_offset));
+            m_index_data.push_back(static_cast<index_type>(vv + index_offset));
+        }
+    }
+
+#if defined(VGL_ENABLE_STATIC_BATCHING)
+    /// Append another mesh data block into this with a transform applied.
+    ///
+    /// Positions and normals must be stored as floats, other channels are copied as is.
+    ///
+    /// \param op Another data block.
+    /// \param transform Transform to apply.
+    /// \return True on success, false if the data blocks are not compatible.
+    bool appendTransformed(const MeshData& op, const mat4& transform)
+    {
+        unsigned position_offset = ~0u;
+        unsigned normal_offset = ~0u;
+        for(const auto& vv : op.m_channels)
+        {
+            GeometryChannel semantic = vv.getSemantic();
+            if((semantic != GeometryChannel::POSITION) && (semantic != GeometryChannel::NORMAL))
+            {
+                continue;
+            }
+            if((vv.getType() != GL_FLOAT) || (vv.getElementCount() != 3))
+            {
+                return false;
+            }
+            if(semantic == GeometryChannel::POSITION)
+            {
+                position_offset = vv.getOffset();
+            }
+            else
+            {
+                normal_offset = vv.getOffset();
+            }
+        }
+        if(!m_stride)
+        {
+            for(const auto& vv : op.m_channels)
+            {
+                m_channels.push_back(vv);
+            }
+            m_stride = op.m_stride;
+        }
+        else if(!matches(op))
+        {
+            return false;
+        }
+
+        unsigned vertex_offset = getVertexOffset();
+        append(op);
+
+        mat3 normal_transform = normalify(transform);
+        uint8_t* dst = static_cast<uint8_t*>(m_vertex_data.data()) + vertex_offset;
+        for(unsigned ii = 0; (ii < op.getVertexCount()); ++ii)
+        {
+            uint8_t* vertex = dst + (ii * static_cast<unsigned>(m_stride));
+            vec3 data;
+            if(position_offset != ~0u)
+            {
+                detail::internal_memcpy(&data, vertex + position_offset, static_cast<unsigned>(sizeof(data)));
+                data = transform * data;
+                detail::internal_memcpy(vertex + position_offset, &data, static_cast<unsigned>(sizeof(data)));
+            }
+            if(normal_offset != ~0u)
+            {
+                detail::internal_memcpy(&data, vertex + normal_offset, static_cast<unsigned>(sizeof(data)));
+                data = normal_transform * data;
+                detail::internal_memcpy(vertex + normal_offset, &data, static_cast<unsigned>(sizeof(data)));
+            }
+        }
+        return true;
+    }
+#endif
+
+#if defined(VGL_ENABLE_VERTEX_CACHE_OPTIMIZATION)
+    /// Optimize for post-transform vertex cache and vertex fetch.
+    ///
+    /// Reorders triangles for vertex reuse, then reorders vertices in the order they are first used.
+    /// Triangles keep their original order if reordering would not decrease the cache miss ratio.
+    void optimizeVertexCache()
+    {
+        if(!m_vertex_count)
+        {
+            return;
+        }
+        detail::VertexCacheStatistics before(m_index_data, m_vertex_count);
+        vector<index_type> original_index_data;
+        for(const auto& vv : m_index_data)
+        {
+            original_index_data.push_back(vv);
+        }
+
+        // The optimizer simulates a different cache than the statistics, keep the original order if it was better.
+        detail::VertexCacheOptimizer::optimize(m_index_data, m_vertex_count);
+        if(detail::VertexCacheStatistics(m_index_data, m_vertex_count).getAcmr() > before.getAcmr())
+        {
+            m_index_data = move(original_index_data);
+        }
+
+        // Unused vertices, if any, go last.
+        const uint8_t* src = static_cast<const uint8_t*>(m_vertex_data.data());
+        unsigned stride = static_cast<unsigned>(m_stride);
+        vector<unsigned> remap(m_vertex_count);
+        for(unsigned ii = 0; (ii < m_vertex_count); ++ii)
+        {
+            remap[ii] = m_vertex_count;
+        }
+        PackedData vertex_data;
+        unsigned vertex_count = 0;
+        for(auto& vv : m_index_data)
+        {
+            if(remap[vv] >= m_vertex_count)
+            {
+                remap[vv] = vertex_count;
+                vertex_data.append(src + (vv * stride), stride);
+                ++vertex_count;
+            }
+            vv = static_cast<index_type>(remap[vv]);
+        }
+        for(unsigned ii = 0; (ii < m_vertex_count); ++ii)
+        {
+            if(remap[ii] >= m_vertex_count)
+            {
+                vertex_data.append(src + (ii * stride), stride);
+            }
+        }
+        m_vertex_data = move(vertex_data);
+
+#if defined(VGL_USE_LD)
+        g_vertex_cache_report.add(before, detail::VertexCacheStatistics(m_index_data, m_vertex_count),
+                m_index_data.size(), m_vertex_count);
+#endif
+    }
+
+#if defined(VGL_USE_LD)
+    /// Report vertex cache statistics of every mesh at exit instead of only the summary.
+    ///
+    /// \param op True to report every mesh.
+    static void set_vertex_cache_report_verbose(bool op)
+    {
+        g_vertex_cache_report.setVerbose(op);
+    }
+#endif
+#endif
+
+#if defined(VGL_ENABLE_MESH_LOD)
+    /// Generate simplified mesh data.
+    ///
+    /// \param op Target mesh data, must be empty.
+    /// \param cell_size Simplification cell size.
+    /// \return Geometric error, maximum distance of a simplified triangle corner from the original surface.
+    float simplify(MeshData& op, float cell_size) const
+    {
+        unsigned position_offset = ~0u;
+        unsigned normal_offset = ~0u;
+        for(const auto& vv : m_channels)
+        {
+            op.m_channels.push_back(vv);
+            if(vv.getSemantic() == GeometryChannel::POSITION)
+            {
+                position_offset = vv.getOffset();
+            }
+            else if(vv.getSemantic() == GeometryChannel::NORMAL)
+            {
+                normal_offset = vv.getOffset();
+            }
+        }
+        op.m_stride = m_stride;
+        if(position_offset == ~0u)
+        {
+            return 0.0f;
+        }
+
+        float ret;
+        op.m_vertex_count = detail::MeshSimplifier::simplify(static_cast<const uint8_t*>(m_vertex_data.data()),
+                static_cast<unsigned>(m_stride), m_vertex_count, m_index_data, position_offset, normal_offset,
+                cell_size, op.m_vertex_data, op.m_index_data, ret);
+        return ret;
+    }
+#endif
+
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+    /// Accessor.
+    ///
+    /// \return Transform from stored positions to mesh space.
+    mat4 getPositionTransform() const noexcept
+    {
+        mat4 ret = mat4::scale(m_position_scale);
+        ret.setTranslation(m_position_offset);
+        return ret;
+    }
+
+#if defined(VGL_USE_LD)
+    /// Accessor.
+    ///
+    /// \return Vertex data size before quantization.
+    constexpr unsigned getUnquantizedDataSize() const
+    {
+        unsigned stride = 0;
+        for(const auto& vv : m_channels)
+        {
+            stride += detail::geometry_channel_size(vv.getSemantic());
+        }
+        return stride * m_vertex_count;
+    }
+#endif
+
+    /// Quantize vertex data.
+    ///
+    /// Positions are stored as 16-bit integers on a power-of-two grid that only depends on the mesh size, so meshes of
+    /// similar size quantize shared positions identically. Normals are stored as 10-bit normalized integers. Other
+    /// channels are kept as is.
+    ///
+    /// Stored positions are transformed into mesh space by the position transform, not by the shader, so meshes with
+    /// bone references may not be quantized.
+    ///
+    /// \param pmin Minimum position.
+    /// \param pmax Maximum position.
+    void quantize(const vec3& pmin, const vec3& pmax)
+    {
+        // Largest power of two grid size that fits the mesh into 16 bits, leaving room for rounding.
+        float extent = max(max(pmax.x() - pmin.x(), pmax.y() - pmin.y()), pmax.z() - pmin.z());
+        float scale = 1.0f;
+        while((scale * 65532.0f) < extent)
+        {
+            scale *= 2.0f;
         }
+        while(((scale * 32766.0f) >= extent) && (scale > (1.0f / 65536.0f)))
+        {
+            scale *= 0.5f;
+        }
+        vec3 center = (pmin + pmax) * 0.5f;
+        int base[3];
+        for(unsigned ii = 0; (ii < 3); ++ii)
+        {
+            base[ii] = iround(center[ii] / scale);
+            m_position_offset[ii] = static_cast<float>(base[ii]) * scale;
+        }
+        m_position_scale = scale;
+
+        vector<ChannelInfo> channels;
+        unsigned stride = 0;
+        for(const auto& vv : m_channels)
+        {
+            GeometryChannel semantic = vv.getSemantic();
+            if(semantic == GeometryChannel::POSITION)
+            {
+                channels.emplace_back(semantic, stride, 4, static_cast<GLenum>(GL_SHORT),
+                        static_cast<GLboolean>(GL_FALSE));
+                stride += 8;
+            }
+            else if(semantic == GeometryChannel::NORMAL)
+            {
+#if defined(GL_INT_2_10_10_10_REV)
+                channels.emplace_back(semantic, stride, 4, static_cast<GLenum>(GL_INT_2_10_10_10_REV),
+                        static_cast<GLboolean>(GL_TRUE));
+#else
+                channels.emplace_back(semantic, stride, 4, static_cast<GLenum>(GL_BYTE),
+                        static_cast<GLboolean>(GL_TRUE));
+#endif
+                stride += 4;
+            }
+            else
+            {
+#if defined(VGL_USE_LD)
+                if(semantic == GeometryChannel::BONE_REF)
+                {
+                    VGL_THROW_RUNTIME_ERROR("cannot quantize mesh data with bone references");
+                }
+#endif
+                channels.emplace_back(semantic, stride, vv.getElementCount(), vv.getType(), vv.isNormalized());
+                stride += static_cast<unsigned>(vv.getElementCount()) *
+                    detail::geometry_element_type_size(vv.getType());
+            }
+        }
+
+        const uint8_t* src = static_cast<const uint8_t*>(m_vertex_data.data());
+        PackedData vertex_data;
+        for(unsigned ii = 0; (ii < m_vertex_count); ++ii)
+        {
+            const uint8_t* vertex = src + (ii * static_cast<unsigned>(m_stride));
+            for(const auto& vv : m_channels)
+            {
+                const uint8_t* data = vertex + vv.getOffset();
+                GeometryChannel semantic = vv.getSemantic();
+                if(semantic == GeometryChannel::POSITION)
+                {
+                    float position[3];
+                    detail::internal_memcpy(position, data, static_cast<unsigned>(sizeof(position)));
+                    for(unsigned jj = 0; (jj < 3); ++jj)
+                    {
+                        vertex_data.push(static_cast<int16_t>(iround(position[jj] / scale) - base[jj]));
+                    }
+                    vertex_data.push(static_cast<int16_t>(1));
+                }
+                else if(semantic == GeometryChannel::NORMAL)
+                {
+                    vec3 normal;
+                    if(vv.getType() == GL_SHORT)
+                    {
+                        int16_t packed[3];
+                        detail::internal_memcpy(packed, data, static_cast<unsigned>(sizeof(packed)));
+                        normal = vec3(static_cast<float>(packed[0] * 2 + 1) / 65535.0f,
+                                static_cast<float>(packed[1] * 2 + 1) / 65535.0f,
+                                static_cast<float>(packed[2] * 2 + 1) / 65535.0f);
+                    }
+                    else
+                    {
+                        detail::internal_memcpy(&normal, data, static_cast<unsigned>(sizeof(normal)));
+                    }
+                    if(length(normal) > 0.0f)
+                    {
+                        normal = normalize(normal);
+                    }
+#if defined(GL_INT_2_10_10_10_REV)
+                    uint32_t packed = 0;
+                    for(unsigned jj = 0; (jj < 3); ++jj)
+                    {
+                        uint32_t element = static_cast<uint32_t>(iround(normal[jj] * 511.0f)) & 0x3FFu;
+                        packed |= element << (jj * 10);
+                    }
+                    vertex_data.push(packed);
+#else
+                    for(unsigned jj = 0; (jj < 3); ++jj)
+                    {
+                        vertex_data.push(static_cast<int8_t>(iround(normal[jj] * 127.0f)));
+                    }
+                    vertex_data.push(static_cast<int8_t>(0));
+#endif
+                }
+                else
+                {
+                    vertex_data.append(data, static_cast<unsigned>(vv.getElementCount()) *
+                            detail::geometry_element_type_size(vv.getType()));
+                }
+            }
+        }
+
+        m_vertex_data = move(vertex_data);
+        m_channels = move(channels);
+        m_stride = static_cast<GLsizei>(stride);
     }
+#endif
 
     /// Bind the attributes in this mesh data.
     ///
@@ -397,6 +865,20 @@ public:
         vertex_buffer.update(m_vertex_data);
         index_buffer.update(m_index_data);
     }
+    /// Update data past given offsets to GPU.
+    ///
+    /// Data before the offsets is expected to already be in the buffers.
+    ///
+    /// \param vertex_buffer Vertex buffer.
+    /// \param index_buffer Index buffer.
+    /// \param vertex_offset Vertex data offset to update from.
+    /// \param index_offset Index data offset to update from.
+    void update(const VertexBuffer& vertex_buffer, const IndexBuffer& index_buffer, unsigned vertex_offset,
+            unsigned index_offset) const
+    {
+        vertex_buffer.updateTail(m_vertex_data, vertex_offset);
+        index_buffer.updateTail(m_index_data, index_offset);
+    }
     /// Update vertex subdata GPU.
     ///
     /// \param vertex_buffer Vertex buffer.
@@ -413,6 +895,41 @@ public:
     {
         detail::geometry_handle_update_mesh_data(op, *this);
     }
+
+#if defined(VGL_USE_LD)
+    /// Serialize the mesh data.
+    ///
+    /// Every field is padded to 4 bytes so values may be read in place.
+    ///
+    /// \param op Packed data to append to.
+    void serialize(PackedData& op) const
+    {
+        op.push<uint32_t>(static_cast<uint32_t>(m_stride));
+        op.push<uint32_t>(m_vertex_count);
+
+        op.push<uint32_t>(m_channels.size());
+        for(const auto& vv : m_channels)
+        {
+            op.push<uint32_t>(static_cast<uint32_t>(vv.getSemantic()));
+            op.push<uint32_t>(vv.getOffset());
+            op.push<uint32_t>(static_cast<uint32_t>(vv.getElementCount()));
+            op.push<uint32_t>(static_cast<uint32_t>(vv.getType()));
+            op.push<uint32_t>(static_cast<uint32_t>(vv.isNormalized()));
+        }
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+        op.push(m_position_scale);
+        op.push(m_position_offset);
+#endif
+
+        op.push<uint32_t>(m_vertex_data.size());
+        op.append(m_vertex_data);
+        op.align(4);
+
+        op.push<uint32_t>(m_index_data.size());
+        op.append(m_index_data.data(), m_index_data.getSizeBytes());
+        op.align(4);
+    }
+#endif
 };
 
 namespace detail
@@ -426,6 +943,9 @@ namespace detail
 constexpr void increment_buffer_data_sizes(const MeshData& op)
 {
     increment_data_size_vertex(op.getVertexOffset());
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+    increment_data_size_vertex_unquantized(op.getUnquantizedDataSize());
+#endif
     increment_data_size_index(op.getIndexOffset());
 }
 
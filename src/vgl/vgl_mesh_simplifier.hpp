@@ -0,0 +1,797 @@
+#ifndef VGL_MESH_SIMPLIFIER_HPP
+#define VGL_MESH_SIMPLIFIER_HPP
+
+#include "vgl_array.hpp"
+#include "vgl_index_type.hpp"
+#include "vgl_packed_data.hpp"
+#include "vgl_realloc.hpp"
+#include "vgl_vec3.hpp"
+#include "vgl_vector.hpp"
+
+#if defined(VGL_ENABLE_VERTEX_NORMAL_PACKING)
+#include "vgl_ivec3.hpp"
+#endif
+
+namespace vgl
+{
+
+namespace detail
+{
+
+/// Symmetric 4x4 quadric error matrix.
+///
+/// Sum of squared distances to a set of planes, stored as the upper triangle of the matrix.
+class Quadric
+{
+private:
+    /// Matrix elements: aa, ab, ac, ad, bb, bc, bd, cc, cd, dd.
+    array<float, 10> m_data;
+
+public:
+    /// Constructor.
+    constexpr explicit Quadric() noexcept :
+        m_data{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}
+    {
+    }
+
+public:
+    /// Add a weighted plane.
+    ///
+    /// \param normal Unit plane normal.
+    /// \param dist Plane distance term.
+    /// \param weight Weight of the plane.
+    constexpr void addPlane(const vec3& normal, float dist, float weight) noexcept
+    {
+        float aa = normal.x();
+        float bb = normal.y();
+        float cc = normal.z();
+        m_data[0u] += aa * aa * weight;
+        m_data[1u] += aa * bb * weight;
+        m_data[2u] += aa * cc * weight;
+        m_data[3u] += aa * dist * weight;
+        m_data[4u] += bb * bb * weight;
+        m_data[5u] += bb * cc * weight;
+        m_data[6u] += bb * dist * weight;
+        m_data[7u] += cc * cc * weight;
+        m_data[8u] += cc * dist * weight;
+        m_data[9u] += dist * dist * weight;
+    }
+
+    /// Find the point minimizing the error.
+    ///
+    /// \param ret Point found.
+    /// \return True if the minimum is unique, false if the planes do not constrain a point.
+    bool solve(vec3& ret) const noexcept
+    {
+        float a00 = m_data[0u];
+        float a01 = m_data[1u];
+        float a02 = m_data[2u];
+        float a11 = m_data[4u];
+        float a12 = m_data[5u];
+        float a22 = m_data[7u];
+
+        float c00 = a11 * a22 - a12 * a12;
+        float c01 = a02 * a12 - a01 * a22;
+        float c02 = a01 * a12 - a02 * a11;
+        float det = a00 * c00 + a01 * c01 + a02 * c02;
+
+        // Relative threshold, the matrix is singular if the planes meet at a line or are all parallel.
+        float scale = a00 + a11 + a22;
+        if(abs(det) <= (scale * scale * scale * 1.0e-4f))
+        {
+            return false;
+        }
+
+        float c11 = a00 * a22 - a02 * a02;
+        float c12 = a01 * a02 - a00 * a12;
+        float c22 = a00 * a11 - a01 * a01;
+        float inv_det = 1.0f / det;
+        float bx = -m_data[3u];
+        float by = -m_data[6u];
+        float bz = -m_data[8u];
+        ret = vec3(c00 * bx + c01 * by + c02 * bz,
+                c01 * bx + c11 * by + c12 * bz,
+                c02 * bx + c12 * by + c22 * bz) * inv_det;
+        return true;
+    }
+};
+
+/// Mesh simplifier.
+///
+/// Simplifies indexed triangle lists by vertex clustering with quadric error placement (Lindstrom 2000). Vertices are
+/// clustered into a uniform grid and every cell collapses into one representative position that minimizes the
+/// squared distance to the planes of the triangles in the cell. Triangles with two corners in the same cell vanish.
+/// Triangles flipped by the collapse are dropped, and the hole they leave is included in the measured error.
+///
+/// Vertices in the same cell are only merged if their attributes also match, so seams between flat faces and
+/// texture or color boundaries are kept. Normals are only required to point roughly in the same direction. All
+/// vertices in a cell share the same position, so the result contains no cracks.
+///
+/// Vertices on open borders along the bounding box are never moved, so meshes tiled next to each other (such as
+/// terrain blocks) stay connected regardless of their levels of detail.
+class MeshSimplifier
+{
+private:
+    /// Marker for no cell or no vertex.
+    static const unsigned NONE = ~0u;
+
+private:
+    /// Input vertex data.
+    const uint8_t* m_vertices;
+
+    /// Input indices.
+    const vector<index_type>& m_indices;
+
+    /// Vertex stride in bytes.
+    unsigned m_stride;
+
+    /// Input vertex count.
+    unsigned m_vertex_count;
+
+    /// Offset of the position channel.
+    unsigned m_position_offset;
+
+    /// Offset of the normal channel or NONE.
+    unsigned m_normal_offset;
+
+    /// Cell size.
+    float m_cell_size;
+
+    /// Minimum corner of the input.
+    vec3 m_min;
+
+    /// Maximum corner of the input.
+    vec3 m_max;
+
+    /// Cell of each input vertex.
+    vector<unsigned> m_vertex_cells;
+
+    /// First input vertex with the same position for each input vertex.
+    vector<unsigned> m_position_ids;
+
+    /// Is the position locked, indexed by position id.
+    vector<uint8_t> m_locked;
+
+    /// Grid coordinates of each cell.
+    vector<array<int32_t, 3>> m_cell_coords;
+
+    /// Quadric of each cell.
+    vector<Quadric> m_cell_quadrics;
+
+    /// Sum of input positions in each cell.
+    vector<vec3> m_cell_sums;
+
+    /// Number of input vertices in each cell.
+    vector<unsigned> m_cell_counts;
+
+    /// Is the cell a single locked position?
+    vector<uint8_t> m_cell_locked;
+
+    /// Representative position of each cell.
+    vector<vec3> m_cell_positions;
+
+    /// Bytes of the vertex that must match exactly for vertices to merge.
+    vector<uint8_t> m_exact_bytes;
+
+private:
+    /// Constructor.
+    ///
+    /// \param vertices Input vertex data.
+    /// \param stride Vertex stride in bytes.
+    /// \param vertex_count Input vertex count.
+    /// \param indices Input indices.
+    /// \param position_offset Offset of the position channel.
+    /// \param normal_offset Offset of the normal channel or NONE.
+    /// \param cell_size Cell size.
+    explicit MeshSimplifier(const uint8_t* vertices, unsigned stride, unsigned vertex_count,
+            const vector<index_type>& indices, unsigned position_offset, unsigned normal_offset, float cell_size) :
+        m_vertices(vertices),
+        m_indices(indices),
+        m_stride(stride),
+        m_vertex_count(vertex_count),
+        m_position_offset(position_offset),
+        m_normal_offset(normal_offset),
+        m_cell_size(cell_size),
+        m_vertex_cells(vertex_count),
+        m_position_ids(vertex_count),
+        m_locked(vertex_count),
+        m_exact_bytes(stride)
+    {
+        for(unsigned ii = 0; (ii < m_stride); ++ii)
+        {
+            m_exact_bytes[ii] = 1;
+        }
+        for(unsigned ii = 0; (ii < static_cast<unsigned>(sizeof(vec3))); ++ii)
+        {
+            m_exact_bytes[m_position_offset + ii] = 0;
+        }
+        if(m_normal_offset != NONE)
+        {
+#if defined(VGL_ENABLE_VERTEX_NORMAL_PACKING)
+            const unsigned normal_size = static_cast<unsigned>(sizeof(ivec3));
+#else
+            const unsigned normal_size = static_cast<unsigned>(sizeof(vec3));
+#endif
+            for(unsigned ii = 0; (ii < normal_size); ++ii)
+            {
+                m_exact_bytes[m_normal_offset + ii] = 0;
+            }
+        }
+
+        m_min = getPosition(0);
+        m_max = m_min;
+        for(unsigned ii = 1; (ii < m_vertex_count); ++ii)
+        {
+            vec3 pos = getPosition(ii);
+            for(unsigned jj = 0; (jj < 3); ++jj)
+            {
+                m_min[jj] = min(m_min[jj], pos[jj]);
+                m_max[jj] = max(m_max[jj], pos[jj]);
+            }
+        }
+    }
+
+private:
+    /// Read the position of an input vertex.
+    ///
+    /// \param op Vertex index.
+    /// \return Position.
+    vec3 getPosition(unsigned op) const noexcept
+    {
+        vec3 ret;
+        internal_memcpy(&ret, m_vertices + (op * m_stride) + m_position_offset,
+                static_cast<unsigned>(sizeof(vec3)));
+        return ret;
+    }
+
+    /// Read the normal of an input vertex.
+    ///
+    /// \param op Vertex index.
+    /// \return Normal.
+    vec3 getNormal(unsigned op) const noexcept
+    {
+#if defined(VGL_ENABLE_VERTEX_NORMAL_PACKING)
+        array<int16_t, 3> packed;
+        internal_memcpy(packed.data(), m_vertices + (op * m_stride) + m_normal_offset,
+                static_cast<unsigned>(sizeof(packed)));
+        return vec3(static_cast<float>(packed[0u]), static_cast<float>(packed[1u]), static_cast<float>(packed[2u]));
+#else
+        vec3 ret;
+        internal_memcpy(&ret, m_vertices + (op * m_stride) + m_normal_offset,
+                static_cast<unsigned>(sizeof(vec3)));
+        return ret;
+#endif
+    }
+
+    /// Calculate the normal direction class of an input vertex.
+    ///
+    /// Normals are quantized to a coarse grid on the cube, so vertices merge across smooth surfaces but not across
+    /// sharp edges.
+    ///
+    /// \param op Vertex index.
+    /// \return Direction class.
+    unsigned getNormalClass(unsigned op) const noexcept
+    {
+        if(m_normal_offset == NONE)
+        {
+            return 0;
+        }
+        vec3 nor = getNormal(op);
+        float len = length(nor);
+        if(len <= 0.0f)
+        {
+            return 0;
+        }
+        nor *= 2.0f / len;
+
+        unsigned ret = 0;
+        for(unsigned ii = 0; (ii < 3); ++ii)
+        {
+            ret = ret * 5 + static_cast<unsigned>(iround(nor[ii]) + 2);
+        }
+        return ret + 1;
+    }
+
+    /// Mix a value into a hash.
+    ///
+    /// \param hash Existing hash.
+    /// \param op Value to mix in.
+    /// \return New hash.
+    static constexpr uint32_t hash_mix(uint32_t hash, uint32_t op) noexcept
+    {
+        return (hash ^ op) * 16777619u;
+    }
+
+    /// Calculate a hash for output vertex grouping.
+    ///
+    /// \param cell Cell index.
+    /// \param vertex Input vertex index.
+    /// \return Hash value.
+    uint32_t getVertexHash(unsigned cell, unsigned vertex) const noexcept
+    {
+        uint32_t ret = hash_mix(hash_mix(2166136261u, cell), getNormalClass(vertex));
+        const uint8_t* src = m_vertices + (vertex * m_stride);
+        for(unsigned ii = 0; (ii < m_stride); ++ii)
+        {
+            if(m_exact_bytes[ii])
+            {
+                ret = hash_mix(ret, src[ii]);
+            }
+        }
+        return ret;
+    }
+
+    /// Tell if two input vertices in the same cell may be merged.
+    ///
+    /// \param lhs Left-hand-side vertex index.
+    /// \param rhs Right-hand-side vertex index.
+    /// \return True if vertices may be merged.
+    bool canMerge(unsigned lhs, unsigned rhs) const noexcept
+    {
+        if(getNormalClass(lhs) != getNormalClass(rhs))
+        {
+            return false;
+        }
+        const uint8_t* src1 = m_vertices + (lhs * m_stride);
+        const uint8_t* src2 = m_vertices + (rhs * m_stride);
+        for(unsigned ii = 0; (ii < m_stride); ++ii)
+        {
+            if(m_exact_bytes[ii] && (src1[ii] != src2[ii]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Calculate hash table size for given element count.
+    ///
+    /// \param op Element count.
+    /// \return Power of two bucket count.
+    static unsigned get_bucket_count(unsigned op) noexcept
+    {
+        unsigned ret = 1;
+        while(ret < (op * 2))
+        {
+            ret *= 2;
+        }
+        return ret;
+    }
+
+    /// Tell if an edge lies on a face of the bounding box.
+    ///
+    /// \param p1 First position id.
+    /// \param p2 Second position id.
+    /// \return True if both ends are on the same face.
+    bool isOnBoundingBox(unsigned p1, unsigned p2) const noexcept
+    {
+        vec3 pos1 = getPosition(p1);
+        vec3 pos2 = getPosition(p2);
+        for(unsigned ii = 0; (ii < 3); ++ii)
+        {
+            if(((pos1[ii] == m_min[ii]) && (pos2[ii] == m_min[ii])) ||
+                    ((pos1[ii] == m_max[ii]) && (pos2[ii] == m_max[ii])))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Lock vertices on open borders along the bounding box.
+    ///
+    /// Border edges are used by only one triangle. Edges are identified by position, since flat shading and attribute
+    /// seams duplicate vertices on closed edges as well. Open borders elsewhere are not locked, CSG output often has
+    /// them where faces meet without sharing vertices.
+    void lockBorders()
+    {
+        unsigned bucket_count = get_bucket_count(m_vertex_count);
+        vector<unsigned> buckets(bucket_count);
+        vector<unsigned> chain(m_vertex_count);
+        for(auto& vv : buckets)
+        {
+            vv = NONE;
+        }
+
+        for(unsigned ii = 0; (ii < m_vertex_count); ++ii)
+        {
+            array<uint32_t, 3> bits;
+            internal_memcpy(bits.data(), m_vertices + (ii * m_stride) + m_position_offset,
+                    static_cast<unsigned>(sizeof(bits)));
+            uint32_t hash = hash_mix(hash_mix(hash_mix(2166136261u, bits[0u]), bits[1u]), bits[2u]);
+            unsigned bucket = hash & (bucket_count - 1);
+
+            m_position_ids[ii] = ii;
+            for(unsigned jj = buckets[bucket]; (jj != NONE); jj = chain[jj])
+            {
+                array<uint32_t, 3> other;
+                internal_memcpy(other.data(), m_vertices + (jj * m_stride) + m_position_offset,
+                        static_cast<unsigned>(sizeof(other)));
+                if((other[0u] == bits[0u]) && (other[1u] == bits[1u]) && (other[2u] == bits[2u]))
+                {
+                    m_position_ids[ii] = jj;
+                    break;
+                }
+            }
+            if(m_position_ids[ii] == ii)
+            {
+                chain[ii] = buckets[bucket];
+                buckets[bucket] = ii;
+            }
+            m_locked[ii] = 0;
+        }
+
+        unsigned edge_bucket_count = get_bucket_count(m_indices.size());
+        vector<unsigned> edge_buckets(edge_bucket_count);
+        vector<unsigned> edge_chain;
+        vector<array<unsigned, 2>> edges;
+        vector<unsigned> edge_counts;
+        for(auto& vv : edge_buckets)
+        {
+            vv = NONE;
+        }
+
+        for(unsigned ii = 0; ((ii + 2) < m_indices.size()); ii += 3)
+        {
+            for(unsigned jj = 0; (jj < 3); ++jj)
+            {
+                unsigned p1 = m_position_ids[m_indices[ii + jj]];
+                unsigned p2 = m_position_ids[m_indices[ii + ((jj + 1) % 3)]];
+                if(p1 == p2)
+                {
+                    continue;
+                }
+                array<unsigned, 2> edge{min(p1, p2), max(p1, p2)};
+                unsigned bucket = hash_mix(hash_mix(2166136261u, edge[0u]), edge[1u]) & (edge_bucket_count - 1);
+
+                unsigned found = NONE;
+                for(unsigned kk = edge_buckets[bucket]; (kk != NONE); kk = edge_chain[kk])
+                {
+                    if((edges[kk][0u] == edge[0u]) && (edges[kk][1u] == edge[1u]))
+                    {
+                        found = kk;
+                        break;
+                    }
+                }
+                if(found == NONE)
+                {
+                    found = edges.size();
+                    edges.push_back(edge);
+                    edge_counts.push_back(0u);
+                    edge_chain.push_back(edge_buckets[bucket]);
+                    edge_buckets[bucket] = found;
+                }
+                ++edge_counts[found];
+            }
+        }
+
+        for(unsigned ii = 0; (ii < edges.size()); ++ii)
+        {
+            if((edge_counts[ii] == 1) && isOnBoundingBox(edges[ii][0u], edges[ii][1u]))
+            {
+                m_locked[edges[ii][0u]] = 1;
+                m_locked[edges[ii][1u]] = 1;
+            }
+        }
+    }
+
+    /// Assign all input vertices to cells.
+    ///
+    /// Locked positions get cells of their own.
+    void assignCells()
+    {
+        unsigned bucket_count = get_bucket_count(m_vertex_count);
+        vector<unsigned> buckets(bucket_count);
+        vector<unsigned> chain;
+        for(auto& vv : buckets)
+        {
+            vv = NONE;
+        }
+
+        vector<unsigned> locked_cells(m_vertex_count);
+        for(auto& vv : locked_cells)
+        {
+            vv = NONE;
+        }
+
+        float inv_cell_size = 1.0f / m_cell_size;
+        for(unsigned ii = 0; (ii < m_vertex_count); ++ii)
+        {
+            vec3 pos = getPosition(ii);
+            vec3 rel = (pos - m_min) * inv_cell_size;
+            array<int32_t, 3> coords{static_cast<int32_t>(rel.x()), static_cast<int32_t>(rel.y()),
+                static_cast<int32_t>(rel.z())};
+
+            unsigned position_id = m_position_ids[ii];
+            if(m_locked[position_id])
+            {
+                unsigned cell = locked_cells[position_id];
+                if(cell == NONE)
+                {
+                    cell = m_cell_coords.size();
+                    m_cell_coords.push_back(coords);
+                    m_cell_quadrics.emplace_back();
+                    m_cell_sums.push_back(pos);
+                    m_cell_counts.push_back(1u);
+                    m_cell_locked.push_back(1u);
+                    chain.push_back(NONE);
+                    locked_cells[position_id] = cell;
+                }
+                m_vertex_cells[ii] = cell;
+                continue;
+            }
+
+            uint32_t hash = 2166136261u;
+            for(unsigned jj = 0; (jj < 3); ++jj)
+            {
+                hash = hash_mix(hash, static_cast<uint32_t>(coords[jj]));
+            }
+            unsigned bucket = hash & (bucket_count - 1);
+
+            unsigned cell = NONE;
+            for(unsigned jj = buckets[bucket]; (jj != NONE); jj = chain[jj])
+            {
+                const array<int32_t, 3>& other = m_cell_coords[jj];
+                if((other[0u] == coords[0u]) && (other[1u] == coords[1u]) && (other[2u] == coords[2u]))
+                {
+                    cell = jj;
+                    break;
+                }
+            }
+            if(cell == NONE)
+            {
+                cell = m_cell_coords.size();
+                m_cell_coords.push_back(coords);
+                m_cell_quadrics.emplace_back();
+                m_cell_sums.push_back(vec3(0.0f, 0.0f, 0.0f));
+                m_cell_counts.push_back(0u);
+                m_cell_locked.push_back(0u);
+                chain.push_back(buckets[bucket]);
+                buckets[bucket] = cell;
+            }
+
+            m_vertex_cells[ii] = cell;
+            m_cell_sums[cell] += pos;
+            ++m_cell_counts[cell];
+        }
+    }
+
+    /// Accumulate triangle planes into cell quadrics and solve cell positions.
+    void placeCells()
+    {
+        for(unsigned ii = 0; ((ii + 2) < m_indices.size()); ii += 3)
+        {
+            vec3 p1 = getPosition(m_indices[ii + 0]);
+            vec3 p2 = getPosition(m_indices[ii + 1]);
+            vec3 p3 = getPosition(m_indices[ii + 2]);
+            vec3 nor = cross(p2 - p1, p3 - p1);
+            float len = length(nor);
+            if(len <= 0.0f)
+            {
+                continue;
+            }
+            nor /= len;
+
+            // Area weighting, large triangles dominate the placement.
+            float dist = -dot(nor, p1);
+            float area = len * 0.5f;
+            for(unsigned jj = 0; (jj < 3); ++jj)
+            {
+                m_cell_quadrics[m_vertex_cells[m_indices[ii + jj]]].addPlane(nor, dist, area);
+            }
+        }
+
+        for(unsigned ii = 0; (ii < m_cell_coords.size()); ++ii)
+        {
+            vec3 mean = m_cell_sums[ii] / static_cast<float>(m_cell_counts[ii]);
+
+            // Use the mean position if the minimum is not unique or falls outside the cell.
+            vec3 pos;
+            if(m_cell_locked[ii])
+            {
+                pos = m_cell_sums[ii];
+            }
+            else if(m_cell_quadrics[ii].solve(pos))
+            {
+                const array<int32_t, 3>& coords = m_cell_coords[ii];
+                vec3 cell_min = m_min + vec3(static_cast<float>(coords[0u]), static_cast<float>(coords[1u]),
+                        static_cast<float>(coords[2u])) * m_cell_size;
+                vec3 cell_max = cell_min + vec3(m_cell_size, m_cell_size, m_cell_size);
+                for(unsigned jj = 0; (jj < 3); ++jj)
+                {
+                    if((pos[jj] < max(cell_min[jj], m_min[jj])) || (pos[jj] > min(cell_max[jj], m_max[jj])))
+                    {
+                        pos = mean;
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                pos = mean;
+            }
+            m_cell_positions.push_back(pos);
+        }
+    }
+
+    /// Tell if a triangle collapses into a degenerate triangle.
+    ///
+    /// \param op Index of the first corner of the triangle.
+    /// \return True if two corners are in the same cell.
+    bool isCollapsed(unsigned op) const noexcept
+    {
+        unsigned c1 = m_vertex_cells[m_indices[op + 0]];
+        unsigned c2 = m_vertex_cells[m_indices[op + 1]];
+        unsigned c3 = m_vertex_cells[m_indices[op + 2]];
+        return (c1 == c2) || (c2 == c3) || (c1 == c3);
+    }
+
+    /// Tell if a triangle that does not collapse is flipped by the simplification.
+    ///
+    /// Flipped triangles would show their back face, so they are dropped from the output.
+    ///
+    /// \param op Index of the first corner of the triangle.
+    /// \return True if the simplified triangle faces away from the original.
+    bool isFlipped(unsigned op) const noexcept
+    {
+        vec3 p1 = getPosition(m_indices[op + 0]);
+        vec3 q1 = getCellPosition(m_indices[op + 0]);
+        vec3 original = cross(getPosition(m_indices[op + 1]) - p1, getPosition(m_indices[op + 2]) - p1);
+        vec3 simplified = cross(getCellPosition(m_indices[op + 1]) - q1, getCellPosition(m_indices[op + 2]) - q1);
+        return (dot(original, simplified) <= 0.0f);
+    }
+
+    /// Get the simplified position of an input vertex.
+    ///
+    /// \param op Vertex index.
+    /// \return Representative position of the cell of the vertex.
+    const vec3& getCellPosition(unsigned op) const noexcept
+    {
+        return m_cell_positions[m_vertex_cells[op]];
+    }
+
+    /// Measure the error of the simplification.
+    ///
+    /// Dropping a flipped triangle leaves a hole in the simplified surface. Every point of the hole is within the
+    /// longest edge of the simplified triangle from its corners, so that length is counted as error.
+    ///
+    /// \return Maximum distance of a collapsed triangle corner from the plane of the original triangle, or longest
+    /// edge of a dropped flipped triangle.
+    float measureError() const noexcept
+    {
+        float ret = 0.0f;
+        for(unsigned ii = 0; ((ii + 2) < m_indices.size()); ii += 3)
+        {
+            if(!isCollapsed(ii) && isFlipped(ii))
+            {
+                for(unsigned jj = 0; (jj < 3); ++jj)
+                {
+                    vec3 edge = getCellPosition(m_indices[ii + jj]) - getCellPosition(m_indices[ii + ((jj + 1) % 3)]);
+                    ret = max(ret, length(edge));
+                }
+            }
+
+            vec3 p1 = getPosition(m_indices[ii + 0]);
+            vec3 nor = cross(getPosition(m_indices[ii + 1]) - p1, getPosition(m_indices[ii + 2]) - p1);
+            float len = length(nor);
+            if(len <= 0.0f)
+            {
+                continue;
+            }
+            nor /= len;
+
+            for(unsigned jj = 0; (jj < 3); ++jj)
+            {
+                ret = max(ret, abs(dot(nor, getCellPosition(m_indices[ii + jj]) - p1)));
+            }
+        }
+        return ret;
+    }
+
+    /// Generate output triangles.
+    ///
+    /// \param vertex_data Output vertex data.
+    /// \param index_data Output indices.
+    /// \return Output vertex count.
+    unsigned generate(PackedData& vertex_data, vector<index_type>& index_data) const
+    {
+        unsigned bucket_count = get_bucket_count(m_vertex_count);
+        vector<unsigned> buckets(bucket_count);
+        vector<unsigned> chain(m_vertex_count);
+        vector<unsigned> sources(m_vertex_count);
+        vector<unsigned> remap(m_vertex_count);
+        for(auto& vv : buckets)
+        {
+            vv = NONE;
+        }
+        for(auto& vv : remap)
+        {
+            vv = NONE;
+        }
+
+        unsigned ret = 0;
+        for(unsigned ii = 0; ((ii + 2) < m_indices.size()); ii += 3)
+        {
+            if(isCollapsed(ii) || isFlipped(ii))
+            {
+                continue;
+            }
+            array<unsigned, 3> corners{m_indices[ii + 0], m_indices[ii + 1], m_indices[ii + 2]};
+            array<unsigned, 3> cells{m_vertex_cells[corners[0u]], m_vertex_cells[corners[1u]],
+                m_vertex_cells[corners[2u]]};
+
+            for(unsigned jj = 0; (jj < 3); ++jj)
+            {
+                unsigned vidx = corners[jj];
+                if(remap[vidx] == NONE)
+                {
+                    unsigned bucket = getVertexHash(cells[jj], vidx) & (bucket_count - 1);
+                    for(unsigned kk = buckets[bucket]; (kk != NONE); kk = chain[kk])
+                    {
+                        unsigned other = sources[kk];
+                        if((m_vertex_cells[other] == cells[jj]) && canMerge(other, vidx))
+                        {
+                            remap[vidx] = kk;
+                            break;
+                        }
+                    }
+
+                    if(remap[vidx] == NONE)
+                    {
+                        const uint8_t* src = m_vertices + (vidx * m_stride);
+                        vertex_data.append(src, m_position_offset);
+                        vertex_data.push(m_cell_positions[cells[jj]]);
+                        unsigned remaining = m_position_offset + static_cast<unsigned>(sizeof(vec3));
+                        vertex_data.append(src + remaining, m_stride - remaining);
+
+                        sources[ret] = vidx;
+                        chain[ret] = buckets[bucket];
+                        buckets[bucket] = ret;
+                        remap[vidx] = ret;
+                        ++ret;
+                    }
+                }
+                index_data.push_back(static_cast<index_type>(remap[vidx]));
+            }
+        }
+        return ret;
+    }
+
+public:
+    /// Simplify an indexed triangle list.
+    ///
+    /// \param vertices Input vertex data.
+    /// \param stride Vertex stride in bytes.
+    /// \param vertex_count Input vertex count.
+    /// \param indices Input indices.
+    /// \param position_offset Offset of the position channel.
+    /// \param normal_offset Offset of the normal channel or ~0u if there are no normals.
+    /// \param cell_size Cell size.
+    /// \param vertex_data Output vertex data.
+    /// \param index_data Output indices.
+    /// \param error Output geometric error, see measureError().
+    /// \return Output vertex count.
+    static unsigned simplify(const uint8_t* vertices, unsigned stride, unsigned vertex_count,
+            const vector<index_type>& indices, unsigned position_offset, unsigned normal_offset, float cell_size,
+            PackedData& vertex_data, vector<index_type>& index_data, float& error)
+    {
+        error = 0.0f;
+        if(!vertex_count || (cell_size <= 0.0f))
+        {
+            return 0;
+        }
+        MeshSimplifier simplifier(vertices, stride, vertex_count, indices, position_offset, normal_offset,
+                cell_size);
+        simplifier.lockBorders();
+        simplifier.assignCells();
+        simplifier.placeCells();
+        error = simplifier.measureError();
+        return simplifier.generate(vertex_data, index_data);
+    }
+};
+
+}
+
+}
+
+#endif
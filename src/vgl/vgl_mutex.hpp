@@ -4,6 +4,8 @@
 #if defined(VGL_ENABLE_GTK)
 #include "vgl_realloc.hpp"
 #include "vgl_extern_gtk.hpp"
+#elif defined(VGL_ENABLE_PTHREAD)
+#include "vgl_futex.hpp"
 #else
 #include "vgl_extern_sdl.hpp"
 #endif
@@ -24,6 +26,8 @@ public:
     using mutex_type =
 #if defined(VGL_ENABLE_GTK)
         GMutex
+#elif defined(VGL_ENABLE_PTHREAD)
+        detail::FutexMutex
 #else
         SDL_mutex
 #endif
@@ -42,7 +46,7 @@ private:
 public:
     /// Default constructor.
     explicit Mutex() :
-#if defined(VGL_ENABLE_GTK)
+#if defined(VGL_ENABLE_GTK) || defined(VGL_ENABLE_PTHREAD)
         m_mutex(new mutex_type)
 #else
         m_mutex(dnload_SDL_CreateMutex())
@@ -50,7 +54,7 @@ public:
     {
 #if defined(VGL_ENABLE_GTK)
         dnload_g_mutex_init(m_mutex);
-#elif defined(VGL_USE_LD) && defined(DEBUG)
+#elif !defined(VGL_ENABLE_PTHREAD) && defined(VGL_USE_LD) && defined(DEBUG)
         if(!m_mutex)
         {
             VGL_THROW_RUNTIME_ERROR(string("Mutex::Mutex(): ") + SDL_GetError());
@@ -111,6 +115,8 @@ private:
 #if defined(VGL_ENABLE_GTK)
             dnload_g_mutex_clear(m_mutex);
             delete m_mutex;
+#elif defined(VGL_ENABLE_PTHREAD)
+            delete m_mutex;
 #else
             dnload_SDL_DestroyMutex(m_mutex);
 #endif
@@ -125,6 +131,8 @@ public:
     {
 #if defined(VGL_ENABLE_GTK)
         dnload_g_mutex_lock(op);
+#elif defined(VGL_ENABLE_PTHREAD)
+        op->acquire();
 #else
         int err = dnload_SDL_LockMutex(op);
 #if defined(VGL_USE_LD) && defined(DEBUG)
@@ -145,6 +153,8 @@ public:
     {
 #if defined(VGL_ENABLE_GTK)
         dnload_g_mutex_unlock(op);
+#elif defined(VGL_ENABLE_PTHREAD)
+        op->release();
 #else
         int err = dnload_SDL_UnlockMutex(op);
 #if defined(VGL_USE_LD) && defined(DEBUG)
@@ -0,0 +1,297 @@
+#ifndef VGL_OCCLUSION_BUFFER_HPP
+#define VGL_OCCLUSION_BUFFER_HPP
+
+#include "vgl_array.hpp"
+#include "vgl_bounding_box.hpp"
+
+namespace vgl
+{
+
+/// Low-resolution depth buffer for culling bounding boxes hidden behind occluder boxes on the CPU.
+///
+/// Occluders are rasterized as the convex outline of their projected bounding box at the depth of their furthest
+/// corner, covering only pixels completely inside the outline. Boxes are tested with the screen rectangle of their
+/// projection at the depth of their nearest corner. Both are conservative, boxes are never reported occluded unless
+/// occluder boxes completely cover them. Depth is clip space W, i.e. distance along the view direction.
+///
+/// Rows are stored contiguously and inner loops are branchless so the compiler may vectorize them.
+class OcclusionBuffer
+{
+public:
+    /// Buffer width.
+    static const unsigned WIDTH = 128;
+
+    /// Buffer height.
+    static const unsigned HEIGHT = 72;
+
+private:
+    /// Number of bounding box corners.
+    static const unsigned CORNER_COUNT = 8;
+
+private:
+    /// Depth values.
+    array<float, WIDTH * HEIGHT> m_depth;
+
+    /// Projection * camera matrix.
+    mat4 m_projection_camera;
+
+public:
+    /// Default constructor.
+    explicit OcclusionBuffer() = default;
+
+public:
+    /// Setter.
+    ///
+    /// Must be called before clearing the buffer for a new view.
+    ///
+    /// \param op Projection * camera matrix.
+    constexpr void setProjectionCamera(const mat4& op) noexcept
+    {
+        m_projection_camera = op;
+    }
+
+    /// Clear the buffer to infinite depth.
+    void clear()
+    {
+        float inf = numeric_limits<float>::infinity();
+        for(auto& vv : m_depth)
+        {
+            vv = inf;
+        }
+    }
+
+    /// Rasterize an occluder.
+    ///
+    /// Occluders intersecting the near plane are skipped.
+    ///
+    /// \param op Occluder bounding box (world space).
+    void addOccluder(const BoundingBox& op)
+    {
+        array<float, CORNER_COUNT> px;
+        array<float, CORNER_COUNT> py;
+        float wmin;
+        float wmax;
+        if(!project(op, px, py, wmin, wmax))
+        {
+            return;
+        }
+
+        // Convex hull of the projected corners, counterclockwise.
+        array<unsigned, CORNER_COUNT> order;
+        for(unsigned ii = 0; (ii < CORNER_COUNT); ++ii)
+        {
+            unsigned jj = ii;
+            for(; (jj > 0) && ((px[order[jj - 1]] > px[ii]) ||
+                        ((px[order[jj - 1]] == px[ii]) && (py[order[jj - 1]] > py[ii]))); --jj)
+            {
+                order[jj] = order[jj - 1];
+            }
+            order[jj] = ii;
+        }
+        array<unsigned, CORNER_COUNT * 2> hull;
+        unsigned hull_size = 0;
+        unsigned chain_start = 0;
+        for(unsigned ii = 0; (ii < CORNER_COUNT * 2 - 1); ++ii)
+        {
+            // Lower chain from left to right, then upper chain from right to left.
+            if(ii == CORNER_COUNT)
+            {
+                chain_start = hull_size - 1;
+            }
+            unsigned idx = order[(ii < CORNER_COUNT) ? ii : (CORNER_COUNT * 2 - 2 - ii)];
+            while((hull_size >= chain_start + 2) &&
+                    (cross(px, py, hull[hull_size - 2], hull[hull_size - 1], idx) <= 0.0f))
+            {
+                --hull_size;
+            }
+            hull[hull_size++] = idx;
+        }
+        // Last point is the first point.
+        --hull_size;
+        if(hull_size < 3)
+        {
+            return;
+        }
+
+        // Edge functions, positive inside.
+        array<float, CORNER_COUNT> ea;
+        array<float, CORNER_COUNT> eb;
+        array<float, CORNER_COUNT> ec;
+        float ymin = py[hull[0]];
+        float ymax = py[hull[0]];
+        for(unsigned ii = 0; (ii < hull_size); ++ii)
+        {
+            unsigned curr = hull[ii];
+            unsigned next = hull[(ii + 1) % hull_size];
+            ea[ii] = py[curr] - py[next];
+            eb[ii] = px[next] - px[curr];
+            ec[ii] = -((ea[ii] * px[curr]) + (eb[ii] * py[curr]));
+            ymin = min(ymin, py[curr]);
+            ymax = max(ymax, py[curr]);
+        }
+
+        int y1 = to_pixel(ymin, HEIGHT);
+        int y2 = to_pixel(ymax, HEIGHT);
+        for(int ii = y1; (ii <= y2); ++ii)
+        {
+            // Range of pixels in the row with all corners inside every edge.
+            float fy = static_cast<float>(ii);
+            float xmin = 0.0f;
+            float xmax = static_cast<float>(WIDTH - 1);
+            for(unsigned jj = 0; (jj < hull_size); ++jj)
+            {
+                float aa = ea[jj];
+                float kk = (eb[jj] * fy) + ec[jj] + min(aa, 0.0f) + min(eb[jj], 0.0f);
+                if(aa > 0.0f)
+                {
+                    xmin = max(xmin, -kk / aa);
+                }
+                else if(aa < 0.0f)
+                {
+                    xmax = min(xmax, -kk / aa);
+                }
+                else if(kk < 0.0f)
+                {
+                    xmin = static_cast<float>(WIDTH);
+                }
+            }
+            if(xmin > xmax)
+            {
+                continue;
+            }
+
+            float* row = m_depth.data() + (static_cast<unsigned>(ii) * WIDTH);
+            int x1 = -static_cast<int>(floor(-xmin));
+            int x2 = static_cast<int>(floor(xmax));
+            for(int jj = x1; (jj <= x2); ++jj)
+            {
+                row[jj] = (row[jj] < wmax) ? row[jj] : wmax;
+            }
+        }
+    }
+
+    /// Tell if a bounding box is completely hidden behind rasterized occluders.
+    ///
+    /// \param op Bounding box (world space).
+    /// \return True if occluded, false if possibly visible.
+    bool isOccluded(const BoundingBox& op) const
+    {
+        array<float, CORNER_COUNT> px;
+        array<float, CORNER_COUNT> py;
+        float wmin;
+        float wmax;
+        if(!project(op, px, py, wmin, wmax))
+        {
+            return false;
+        }
+
+        float xmin = px[0];
+        float xmax = px[0];
+        float ymin = py[0];
+        float ymax = py[0];
+        for(unsigned ii = 1; (ii < CORNER_COUNT); ++ii)
+        {
+            xmin = min(xmin, px[ii]);
+            xmax = max(xmax, px[ii]);
+            ymin = min(ymin, py[ii]);
+            ymax = max(ymax, py[ii]);
+        }
+        int x1 = to_pixel(xmin, WIDTH);
+        int x2 = to_pixel(xmax, WIDTH);
+        int y1 = to_pixel(ymin, HEIGHT);
+        int y2 = to_pixel(ymax, HEIGHT);
+        for(int ii = y1; (ii <= y2); ++ii)
+        {
+            const float* row = m_depth.data() + (static_cast<unsigned>(ii) * WIDTH);
+            bool visible = false;
+            for(int jj = x1; (jj <= x2); ++jj)
+            {
+                visible |= (row[jj] >= wmin);
+            }
+            if(visible)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    /// Project corners of a bounding box into buffer coordinates.
+    ///
+    /// \param op Bounding box (world space).
+    /// \param px Output X coordinates.
+    /// \param py Output Y coordinates.
+    /// \param wmin Output nearest depth.
+    /// \param wmax Output furthest depth.
+    /// \return True on success, false if any corner is in front of the near plane.
+    bool project(const BoundingBox& op, array<float, CORNER_COUNT>& px, array<float, CORNER_COUNT>& py, float& wmin,
+            float& wmax) const
+    {
+        const mat4& mat = m_projection_camera;
+        const vec3& bmin = op.getMin();
+        const vec3& bmax = op.getMax();
+
+        array<float, CORNER_COUNT> pw;
+        bool clipped = false;
+        for(unsigned ii = 0; (ii < CORNER_COUNT); ++ii)
+        {
+            float xx = (ii & 1) ? bmax.x() : bmin.x();
+            float yy = (ii & 2) ? bmax.y() : bmin.y();
+            float zz = (ii & 4) ? bmax.z() : bmin.z();
+            float cx = (mat[0u] * xx) + (mat[4u] * yy) + (mat[8u] * zz) + mat[12u];
+            float cy = (mat[1u] * xx) + (mat[5u] * yy) + (mat[9u] * zz) + mat[13u];
+            float cz = (mat[2u] * xx) + (mat[6u] * yy) + (mat[10u] * zz) + mat[14u];
+            float cw = (mat[3u] * xx) + (mat[7u] * yy) + (mat[11u] * zz) + mat[15u];
+            clipped |= ((cz + cw) <= 0.0f);
+            px[ii] = cx;
+            py[ii] = cy;
+            pw[ii] = cw;
+        }
+        if(clipped)
+        {
+            return false;
+        }
+
+        wmin = pw[0];
+        wmax = pw[0];
+        for(unsigned ii = 0; (ii < CORNER_COUNT); ++ii)
+        {
+            float rw = 0.5f / pw[ii];
+            px[ii] = ((px[ii] * rw) + 0.5f) * static_cast<float>(WIDTH);
+            py[ii] = ((py[ii] * rw) + 0.5f) * static_cast<float>(HEIGHT);
+            wmin = min(wmin, pw[ii]);
+            wmax = max(wmax, pw[ii]);
+        }
+        return true;
+    }
+
+private:
+    /// Convert a buffer coordinate into a pixel index.
+    ///
+    /// \param op Coordinate.
+    /// \param size Buffer size along the axis.
+    /// \return Index of pixel containing the coordinate, clamped into the buffer.
+    static int to_pixel(float op, unsigned size)
+    {
+        return static_cast<int>(floor(clamp(op, 0.0f, static_cast<float>(size - 1))));
+    }
+
+    /// Cross product of two edges of projected corners.
+    ///
+    /// \param px X coordinates.
+    /// \param py Y coordinates.
+    /// \param origin Index of common corner.
+    /// \param lhs Index of left-hand-side corner.
+    /// \param rhs Index of right-hand-side corner.
+    /// \return Positive for a counterclockwise turn, negative for a clockwise turn.
+    static float cross(const array<float, CORNER_COUNT>& px, const array<float, CORNER_COUNT>& py, unsigned origin,
+            unsigned lhs, unsigned rhs)
+    {
+        return ((px[lhs] - px[origin]) * (py[rhs] - py[origin])) - ((py[lhs] - py[origin]) * (px[rhs] - px[origin]));
+    }
+};
+
+}
+
+#endif
@@ -26,10 +26,7 @@ public:
     /// \param op Source packed data.
     explicit PackedData(const PackedData& op)
     {
-        for(const auto& vv : op.m_data)
-        {
-            m_data.push_back(vv);
-        }
+        append(op);
     }
 
     /// Move constructor.
@@ -41,17 +38,32 @@ public:
     }
 
 private:
+    /// Grow the data by given number of bytes.
+    ///
+    /// Capacity grows geometrically and is retained on clear, so data built repeatedly reuses the same storage.
+    ///
+    /// \param count Number of bytes to add.
+    /// \return Pointer to the added bytes.
+    uint8_t* grow(unsigned count)
+    {
+        unsigned offset = m_data.size();
+        unsigned required = offset + count;
+        if(required > m_data.capacity())
+        {
+            const unsigned DEFAULT_CAPACITY = 64;
+            m_data.reserve(max(max(required, m_data.capacity() * 2u), DEFAULT_CAPACITY));
+        }
+        m_data.resize(required);
+        return m_data.data() + offset;
+    }
+
     /// Add data to the rendering queue.
     ///
     /// \param value Pointer to value to add.
     /// \param cound Value size in bytes.
     void addData(const void* value, unsigned count)
     {
-        const uint8_t* src = reinterpret_cast<const uint8_t*>(value);
-        for(unsigned ii = 0; (ii < count); ++ii)
-        {
-            m_data.push_back(src[ii]);
-        }
+        detail::internal_memcpy(grow(count), value, count);
     }
 
 public:
@@ -62,10 +74,7 @@ public:
     PackedData& operator=(const PackedData& rhs)
     {
         m_data.clear();
-        for(const auto& vv : rhs.m_data)
-        {
-            m_data.push_back(vv);
-        }
+        append(rhs);
         return *this;
     }
 
@@ -104,20 +113,45 @@ public:
     }
 
     /// Clear all data.
+    ///
+    /// Capacity is retained.
     constexpr void clear() noexcept
     {
         m_data.clear();
     }
 
+    /// Ensure capacity.
+    ///
+    /// \param op Minimum capacity in bytes.
+    void reserve(unsigned op)
+    {
+        m_data.reserve(op);
+    }
+
+    /// Pad with zero bytes until the size is aligned.
+    ///
+    /// \param op Alignment in bytes.
+    void align(unsigned op)
+    {
+        unsigned padding = (op - (m_data.size() % op)) % op;
+        detail::internal_memset(grow(padding), 0, padding);
+    }
+
+    /// Append raw data.
+    ///
+    /// \param src Pointer to data to append.
+    /// \param count Data size in bytes.
+    void append(const void* src, unsigned count)
+    {
+        addData(src, count);
+    }
+
     /// Append another set of packed data.
     ///
     /// \param op Source to append.
     void append(const PackedData& op)
     {
-        for(const auto& vv : op.m_data)
-        {
-            m_data.push_back(vv);
-        }
+        addData(op.data(), op.size());
     }
 
     /// Push an element of data to the rendering queue.
@@ -63,6 +63,17 @@ private:
     }
 
 public:
+    /// Skip padding until the read position is aligned.
+    ///
+    /// Does not advance past the end of the memory stream.
+    ///
+    /// \param op Alignment in bytes.
+    constexpr void align(unsigned op) noexcept
+    {
+        unsigned aligned = ((m_idx + op - 1) / op) * op;
+        m_idx = (aligned < m_size) ? aligned : m_size;
+    }
+
     /// Gets the number of remaining bytes.
     ///
     /// \return Number of remaining bytes in memory stream.
@@ -78,9 +89,9 @@ public:
     template<typename T> constexpr const T& read(unsigned op = 1) noexcept
     {
 #if defined(VGL_USE_LD)
-        if(remaining() < sizeof(T))
+        if(remaining() < (sizeof(T) * op))
         {
-            VGL_THROW_RUNTIME_ERROR("cannot read value of size " + to_string(sizeof(T)) + ": " +
+            VGL_THROW_RUNTIME_ERROR("cannot read value of size " + to_string(sizeof(T) * op) + ": " +
                     to_string(remaining()) + " bytes remaining");
         }
 #endif
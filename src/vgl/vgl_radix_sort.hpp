@@ -0,0 +1,70 @@
+#ifndef VGL_RADIX_SORT_HPP
+#define VGL_RADIX_SORT_HPP
+
+#include "vgl_array.hpp"
+#include "vgl_utility.hpp"
+
+namespace vgl
+{
+
+/// Sort 64-bit keys into ascending order.
+///
+/// Least significant digit radix sort with 8-bit digits. Digits shared by all keys are skipped, so keys with unused
+/// fields sort in fewer passes.
+///
+/// \param data Keys to sort.
+/// \param scratch Scratch space of the same size as data.
+/// \param count Number of keys.
+inline void radix_sort(uint64_t* data, uint64_t* scratch, unsigned count)
+{
+    if(count < 2)
+    {
+        return;
+    }
+
+    uint64_t* src = data;
+    uint64_t* dst = scratch;
+    for(unsigned shift = 0; (shift < 64); shift += 8)
+    {
+        array<unsigned, 256> offsets;
+        for(auto& vv : offsets)
+        {
+            vv = 0;
+        }
+        for(unsigned ii = 0; (ii < count); ++ii)
+        {
+            ++offsets[static_cast<unsigned>(src[ii] >> shift) & 0xFFu];
+        }
+        if(offsets[static_cast<unsigned>(src[0] >> shift) & 0xFFu] >= count)
+        {
+            continue;
+        }
+
+        unsigned offset = 0;
+        for(auto& vv : offsets)
+        {
+            unsigned bucket = vv;
+            vv = offset;
+            offset += bucket;
+        }
+        for(unsigned ii = 0; (ii < count); ++ii)
+        {
+            unsigned digit = static_cast<unsigned>(src[ii] >> shift) & 0xFFu;
+            dst[offsets[digit]] = src[ii];
+            ++offsets[digit];
+        }
+        swap(src, dst);
+    }
+
+    if(src != data)
+    {
+        for(unsigned ii = 0; (ii < count); ++ii)
+        {
+            data[ii] = src[ii];
+        }
+    }
+}
+
+}
+
+#endif
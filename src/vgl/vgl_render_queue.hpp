@@ -6,9 +6,49 @@
 #include "vgl_mesh.hpp"
 #include "vgl_packed_data_reader.hpp"
 
+#if defined(VGL_ENABLE_SORTED_RENDER_QUEUE)
+#include "vgl_radix_sort.hpp"
+#endif
+
 namespace vgl
 {
 
+#if defined(VGL_ENABLE_SORTED_RENDER_QUEUE)
+
+namespace detail
+{
+
+/// Draw collected into a sorted section of a render queue.
+class RenderQueueSortItem
+{
+public:
+    /// Program to render with.
+    const GlslProgram* m_program;
+
+    /// Mesh to render.
+    const Mesh* m_mesh;
+
+    /// Mesh modelview matrix.
+    mat4 m_modelview;
+
+public:
+    /// Constructor.
+    ///
+    /// \param program Program to render with.
+    /// \param mesh Mesh to render.
+    /// \param modelview Mesh modelview matrix.
+    constexpr explicit RenderQueueSortItem(const GlslProgram& program, const Mesh& mesh, const mat4& modelview) :
+        m_program(&program),
+        m_mesh(&mesh),
+        m_modelview(modelview)
+    {
+    }
+};
+
+}
+
+#endif
+
 /// Render command queue contains precalculated rendering commands to send meshes to GPU.
 ///
 /// Only objects with no constructors may be added to the rendering queue.
@@ -67,17 +107,9 @@ private:
         explicit RenderState() = default;
 
     private:
-        /// Apply a mesh.
-        ///
-        /// Done when encountering a new render value type
-        /// Clears the mesh state.
-        void applyMesh()
+        /// Apply view uniforms.
+        void applyView()
         {
-            if(!m_mesh)
-            {
-                return;
-            }
-
 #if defined(VGL_USE_LD)
             if(!m_program)
             {
@@ -92,16 +124,37 @@ private:
             VGL_ASSERT(m_camera_position);
 #endif
 
-            // Apply projection uniforms based on semantic only.
-            m_program->uniform(UniformSemantic::PROJECTION_MATRIX, *m_projection_matrix);
-            m_program->uniform(UniformSemantic::PROJECTION_RANGE, *m_projection_range);
-            m_program->uniform(UniformSemantic::CAMERA_MATRIX, *m_camera_matrix);
-            m_program->uniform(UniformSemantic::PROJECTION_CAMERA_MATRIX, *m_projection_camera_matrix);
-            m_program->uniform(UniformSemantic::MODELVIEW_MATRIX, *m_modelview_matrix);
-            m_program->uniform(UniformSemantic::NORMAL_MATRIX, *m_normal_matrix);
-            m_program->uniform(UniformSemantic::CAMERA_MODELVIEW_MATRIX, *m_camera_modelview_matrix);
-            m_program->uniform(UniformSemantic::PROJECTION_CAMERA_MODELVIEW_MATRIX, *m_projection_camera_modelview_matrix);
-            m_program->uniform(UniformSemantic::CAMERA_POSITION, *m_camera_position);
+            // Apply projection uniforms based on semantic only, most of these are unchanged between meshes.
+#if defined(VGL_ENABLE_UNIFORM_CACHE)
+            // View uniforms only change between views.
+            if(m_program->updateView())
+#endif
+            {
+                m_program->uniformCached(UniformSemantic::PROJECTION_MATRIX, *m_projection_matrix);
+                m_program->uniformCached(UniformSemantic::PROJECTION_RANGE, *m_projection_range);
+                m_program->uniformCached(UniformSemantic::CAMERA_MATRIX, *m_camera_matrix);
+                m_program->uniformCached(UniformSemantic::PROJECTION_CAMERA_MATRIX, *m_projection_camera_matrix);
+                m_program->uniformCached(UniformSemantic::CAMERA_POSITION, *m_camera_position);
+            }
+        }
+
+        /// Apply a mesh.
+        ///
+        /// Done when encountering a new render value type
+        /// Clears the mesh state.
+        void applyMesh()
+        {
+            if(!m_mesh)
+            {
+                return;
+            }
+
+            applyView();
+            m_program->uniformCached(UniformSemantic::MODELVIEW_MATRIX, *m_modelview_matrix);
+            m_program->uniformCached(UniformSemantic::NORMAL_MATRIX, *m_normal_matrix);
+            m_program->uniformCached(UniformSemantic::CAMERA_MODELVIEW_MATRIX, *m_camera_modelview_matrix);
+            m_program->uniformCached(UniformSemantic::PROJECTION_CAMERA_MODELVIEW_MATRIX,
+                    *m_projection_camera_modelview_matrix);
 
             m_mesh->draw(*m_program);
             m_mesh = nullptr;
@@ -213,6 +266,22 @@ private:
             m_projection_camera_modelview_matrix = &(iter.read<mat4>());
         }
 
+#if defined(VGL_ENABLE_INSTANCING)
+        /// Instanced mesh command.
+        ///
+        /// \param iter Packed data iterator.
+        void commandMeshInstanced(PackedDataReader& iter)
+        {
+            applyMesh();
+            const Mesh* mesh = iter.read<Mesh*>();
+            unsigned count = static_cast<unsigned>(iter.read<int>());
+            const mat4* transforms = &(iter.read<mat4>(count));
+            applyView();
+            mesh->drawInstanced(*m_program, transforms, count);
+            m_texture_unit = 0;
+        }
+#endif
+
         /// Program command.
         ///
         /// \param iter Packed data iterator.
@@ -257,6 +326,9 @@ private:
             m_camera_matrix = &(iter.read<mat4>());
             m_projection_camera_matrix = &(iter.read<mat4>());
             m_camera_position = &(iter.read<vec3>());
+#if defined(VGL_ENABLE_UNIFORM_CACHE)
+            glsl_program_new_view();
+#endif
         }
 
         /// Render using the packed data reader.
@@ -321,6 +393,17 @@ private:
     vec3 m_camera_position;
 #endif
 
+#if defined(VGL_ENABLE_SORTED_RENDER_QUEUE)
+    /// Draws in the current sorted section.
+    vector<detail::RenderQueueSortItem> m_sort_items;
+
+    /// Sort keys of draws in the current sorted section.
+    vector<uint64_t> m_sort_keys;
+
+    /// Scratch space for sorting.
+    vector<uint64_t> m_sort_scratch;
+#endif
+
 public:
     /// Constructor.
     constexpr explicit RenderQueue() noexcept = default;
@@ -370,12 +453,30 @@ private:
     }
 
 public:
+    /// Accessor.
+    ///
+    /// Only valid after view settings have been pushed.
+    ///
+    /// \return Current projection + camera matrix.
+    const mat4& getProjectionCameraMatrix() const
+    {
+#if defined(VGL_USE_LD)
+        return *m_projection_camera_matrix;
+#else
+        return m_projection_camera_matrix;
+#endif
+    }
+
     /// Clear the render queue.
     ///
     /// After clearing, the queue is ready to receive settings for a new frame.
     void clear()
     {
         m_data.clear();
+#if defined(VGL_ENABLE_SORTED_RENDER_QUEUE)
+        m_sort_items.clear();
+        m_sort_keys.clear();
+#endif
 #if defined(VGL_USE_LD)
         m_camera_matrix = nullopt;
         m_projection_camera_matrix = nullopt;
@@ -386,6 +487,12 @@ public:
     /// Render the contents in the queue.
     void draw() const
     {
+#if defined(VGL_ENABLE_SORTED_RENDER_QUEUE) && defined(VGL_USE_LD)
+        if(!m_sort_keys.empty())
+        {
+            VGL_THROW_RUNTIME_ERROR("sorted section not flushed before drawing");
+        }
+#endif
         RenderState state;
         state.draw(*this);
     }
@@ -407,17 +514,161 @@ public:
     {
         pushCommand<&RenderState::commandMesh>();
         m_data.push(&msh);
-        m_data.push(modelview);
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+        // Quantized positions are transformed into mesh space as part of position transforms, but not normals.
+        mat4 transform = modelview * msh.getData().getPositionTransform();
+#else
+        const mat4& transform = modelview;
+#endif
+        m_data.push(transform);
         m_data.push(normalify(modelview));
 #if defined(VGL_USE_LD)
-        m_data.push((*m_camera_matrix) * modelview);
-        m_data.push((*m_projection_camera_matrix) * modelview);
+        m_data.push((*m_camera_matrix) * transform);
+        m_data.push((*m_projection_camera_matrix) * transform);
+#else
+        m_data.push(m_camera_matrix * transform);
+        m_data.push(m_projection_camera_matrix * transform);
+#endif
+    }
+
+    /// Push mesh render with a program into the current sorted section.
+    ///
+    /// Draws within a sorted section are reordered by program, geometry buffer and depth to minimize state changes.
+    /// Depth is measured at the center of the mesh bounding box.
+    /// With VGL_ENABLE_INSTANCING, draws with programs that have an instanced variant are ordered by mesh instead of
+    /// depth, and consecutive draws of the same mesh are collapsed into one instanced draw.
+    /// Nothing else may be pushed into the queue until the section is flushed. Without VGL_ENABLE_SORTED_RENDER_QUEUE
+    /// the draw is pushed immediately.
+    ///
+    /// \param program Program to render with.
+    /// \param msh Mesh to render.
+    /// \param modelview Mesh modelview matrix.
+    void pushSorted(const GlslProgram& program, const Mesh& msh, const mat4& modelview)
+    {
+#if defined(VGL_ENABLE_SORTED_RENDER_QUEUE)
+        // Draw index is stored in the lowest bits of the key.
+        const unsigned MAX_SORT_ITEMS = 0x10000u;
+        if(m_sort_items.size() >= MAX_SORT_ITEMS)
+        {
+            flushSorted();
+        }
+
+        const GeometryHandle* handle = msh.getGeometryHandle();
+        uint64_t buffer = handle ? handle->getBuffer().getVertexBuffer().getId() : 0u;
+        // Batched meshes are drawn with identity transforms, their position is only known from their vertices.
+        const BoundingBox& box = msh.getBoundingBox();
+        vec3 center = box.isInitialized() ? (modelview * box.getCenter()) : modelview.getTranslation();
+#if defined(VGL_USE_LD)
+        float depth = -((*m_camera_matrix) * center).z();
+#else
+        float depth = -(m_camera_matrix * center).z();
+#endif
+        // Bit patterns of non-negative floats sort in the same order as the values, front to back.
+        uint32_t depth_bits = 0;
+        if(depth > 0.0f)
+        {
+            detail::internal_memcpy(&depth_bits, &depth, static_cast<unsigned>(sizeof(depth_bits)));
+        }
+#if defined(VGL_ENABLE_INSTANCING)
+        // Draws that may be instanced are grouped by mesh instead.
+        if(program.getInstanced() && handle)
+        {
+            depth_bits = handle->getIndexOffset() << 8;
+        }
+#endif
+
+        uint64_t key = (static_cast<uint64_t>(program.getId() & 0xFFu) << 56) | ((buffer & 0xFFFFu) << 40) |
+            (static_cast<uint64_t>(depth_bits >> 8) << 16) | m_sort_items.size();
+        m_sort_keys.push_back(key);
+        m_sort_items.emplace_back(program, msh, modelview);
 #else
-        m_data.push(m_camera_matrix * modelview);
-        m_data.push(m_projection_camera_matrix * modelview);
+        push(program);
+        push(msh, modelview);
 #endif
     }
 
+    /// Flush the current sorted section.
+    ///
+    /// Pushes all draws in the section in sorted order. Must be called before pushing anything order-dependent.
+    void flushSorted()
+    {
+#if defined(VGL_ENABLE_SORTED_RENDER_QUEUE)
+        unsigned count = m_sort_keys.size();
+        if(!count)
+        {
+            return;
+        }
+        m_sort_scratch.resize(count);
+        radix_sort(m_sort_keys.data(), m_sort_scratch.data(), count);
+
+        const GlslProgram* program = nullptr;
+        for(unsigned ii = 0; (ii < count);)
+        {
+            const detail::RenderQueueSortItem& item = getSortItem(ii);
+#if defined(VGL_ENABLE_INSTANCING)
+            // Collapse consecutive draws of the same mesh with the same program into one instanced draw.
+            const GlslProgram* instanced = item.m_program->getInstanced();
+            unsigned run = 1;
+            if(instanced)
+            {
+                for(; ((ii + run) < count); ++run)
+                {
+                    const detail::RenderQueueSortItem& next = getSortItem(ii + run);
+                    if((next.m_program != item.m_program) || (next.m_mesh != item.m_mesh))
+                    {
+                        break;
+                    }
+                }
+            }
+            if(run > 1)
+            {
+                if(instanced != program)
+                {
+                    program = instanced;
+                    push(*program);
+                }
+                pushCommand<&RenderState::commandMeshInstanced>();
+                m_data.push(item.m_mesh);
+                m_data.push(static_cast<int>(run));
+                for(unsigned jj = ii; (jj < (ii + run)); ++jj)
+                {
+                    const detail::RenderQueueSortItem& instance = getSortItem(jj);
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+                    m_data.push(instance.m_modelview * instance.m_mesh->getData().getPositionTransform());
+#else
+                    m_data.push(instance.m_modelview);
+#endif
+                }
+                ii += run;
+                continue;
+            }
+#endif
+            if(item.m_program != program)
+            {
+                program = item.m_program;
+                push(*program);
+            }
+            push(*item.m_mesh, item.m_modelview);
+            ++ii;
+        }
+        m_sort_items.clear();
+        m_sort_keys.clear();
+#endif
+    }
+
+#if defined(VGL_ENABLE_SORTED_RENDER_QUEUE)
+private:
+    /// Get a draw in the current sorted section.
+    ///
+    /// \param op Index into sorted keys.
+    /// \return Draw.
+    const detail::RenderQueueSortItem& getSortItem(unsigned op) const
+    {
+        return m_sort_items[static_cast<unsigned>(m_sort_keys[op] & 0xFFFFu)];
+    }
+
+public:
+#endif
     /// Push program switch.
     ///
     /// \param op Program to use starting from this point.
@@ -438,12 +438,20 @@ private:
     /// Total GPU data size spent on edges.
     unsigned m_data_size_edge = 0u;
 #endif
+    /// Total data size uploaded into buffers.
+    unsigned m_data_size_buffer_upload = 0u;
     /// Total GPU data size spent on indices.
     unsigned m_data_size_index = 0u;
     /// Total GPU data size spent on textures.
     unsigned m_data_size_texture = 0u;
     /// Total GPU data size spent on vertices.
     unsigned m_data_size_vertex = 0u;
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+    /// Total GPU data size that would have been spent on vertices without quantization.
+    unsigned m_data_size_vertex_unquantized = 0u;
+#endif
+    /// Total draw calls issued.
+    unsigned m_draw_count = 0u;
 
 public:
     /// Global state.
@@ -470,6 +478,21 @@ public:
 
 #endif
 
+    /// Accessor.
+    ///
+    /// \return Total data size uploaded into buffers.
+    constexpr unsigned getDataSizeBufferUpload() const
+    {
+        return m_data_size_buffer_upload;
+    }
+    /// Increment data size.
+    ///
+    /// \param op Data size uploaded into a buffer.
+    constexpr unsigned incrementDataSizeBufferUpload(unsigned op)
+    {
+        return m_data_size_buffer_upload += op;
+    }
+
     /// Accessor.
     ///
     /// \return Total index data size used.
@@ -514,6 +537,38 @@ public:
     {
         return m_data_size_vertex += op;
     }
+
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+
+    /// Accessor.
+    ///
+    /// \return Total vertex data size without quantization.
+    constexpr unsigned getDataSizeVertexUnquantized() const
+    {
+        return m_data_size_vertex_unquantized;
+    }
+    /// Increment data size.
+    ///
+    /// \param op Vertex data size without quantization.
+    constexpr unsigned incrementDataSizeVertexUnquantized(unsigned op)
+    {
+        return m_data_size_vertex_unquantized += op;
+    }
+
+#endif
+
+    /// Accessor.
+    ///
+    /// \return Total draw calls issued.
+    constexpr unsigned getDrawCount() const
+    {
+        return m_draw_count;
+    }
+    /// Increment draw calls.
+    constexpr unsigned incrementDrawCount()
+    {
+        return ++m_draw_count;
+    }
 };
 
 #endif
@@ -637,6 +692,21 @@ constexpr unsigned increment_data_size_edge(unsigned op)
 
 #endif
 
+/// Accessor.
+///
+/// \return Total data size uploaded into buffers.
+constexpr unsigned get_data_size_buffer_upload()
+{
+    return detail::OpenGlDiagnosticsState::g_opengl_diagnostics_state.getDataSizeBufferUpload();
+}
+/// Increment data size.
+///
+/// \param op Data size uploaded into a buffer.
+constexpr unsigned increment_data_size_buffer_upload(unsigned op)
+{
+    return detail::OpenGlDiagnosticsState::g_opengl_diagnostics_state.incrementDataSizeBufferUpload(op);
+}
+
 /// Accessor.
 ///
 /// \return Total index data size used.
@@ -682,6 +752,38 @@ constexpr unsigned increment_data_size_vertex(unsigned op)
     return detail::OpenGlDiagnosticsState::g_opengl_diagnostics_state.incrementDataSizeVertex(op);
 }
 
+#if defined(VGL_ENABLE_VERTEX_QUANTIZATION)
+
+/// Accessor.
+///
+/// \return Total vertex data size without quantization.
+constexpr unsigned get_data_size_vertex_unquantized()
+{
+    return detail::OpenGlDiagnosticsState::g_opengl_diagnostics_state.getDataSizeVertexUnquantized();
+}
+/// Increment data size.
+///
+/// \param op Vertex data size without quantization.
+constexpr unsigned increment_data_size_vertex_unquantized(unsigned op)
+{
+    return detail::OpenGlDiagnosticsState::g_opengl_diagnostics_state.incrementDataSizeVertexUnquantized(op);
+}
+
+#endif
+
+/// Accessor.
+///
+/// \return Total draw calls issued.
+constexpr unsigned get_draw_calls()
+{
+    return detail::OpenGlDiagnosticsState::g_opengl_diagnostics_state.getDrawCount();
+}
+/// Increment draw calls.
+constexpr unsigned increment_draw_calls()
+{
+    return detail::OpenGlDiagnosticsState::g_opengl_diagnostics_state.incrementDrawCount();
+}
+
 /// Get an error string corresponding to a GL error.
 ///
 /// \param op GL error.
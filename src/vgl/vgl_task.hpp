@@ -4,21 +4,47 @@
 #include "vgl_fence.hpp"
 #include "vgl_unique_ptr.hpp"
 
+#if defined(VGL_USE_LD)
+#include "vgl_task_tracer.hpp"
+#endif
+
 namespace vgl
 {
 
+/// Task function prototype.
+using TaskFunc = void* (*)(void*);
+
+/// Task priority.
+///
+/// Workers always execute the highest priority task available.
+enum class TaskPriority
+{
+    /// Frame-critical work, must never queue behind other tasks.
+    HIGH = 0,
+
+    /// Default priority.
+    NORMAL,
+
+    /// Bulk background work.
+    LOW,
+};
+
+/// Number of task priorities.
+constexpr unsigned TASK_PRIORITY_COUNT = 3;
+
 namespace detail
 {
 
 /// \cond
 void internal_fence_data_signal(detail::FenceData&);
+#if defined(VGL_USE_LD)
+bool internal_task_trace_enabled();
+void internal_task_trace(TaskFunc, uint64_t);
+#endif
 /// \endcond
 
 }
 
-/// Task function prototype.
-using TaskFunc = void* (*)(void*);
-
 /// Task abstraction.
 ///
 /// Virtual base class.
@@ -34,6 +60,17 @@ private:
     /// Parameter to the function pointer.
     void* m_params = nullptr;
 
+#if defined(VGL_USE_LD)
+    /// Timestamp of queueing the task (ns).
+    uint64_t m_queue_time = 0;
+
+    /// Deadline timestamp for completing the task (ns, 0: no deadline).
+    uint64_t m_deadline = 0;
+
+    /// Priority the task was queued with.
+    TaskPriority m_priority = TaskPriority::NORMAL;
+#endif
+
 private:
     /// Deleted copy constructor.
     Task(const Task&) = delete;
@@ -78,6 +115,11 @@ public:
     constexpr Task(Task&& op) noexcept :
         Task(op.m_fence_data, op.m_func, op.m_params)
     {
+#if defined(VGL_USE_LD)
+        m_queue_time = op.m_queue_time;
+        m_deadline = op.m_deadline;
+        m_priority = op.m_priority;
+#endif
         op.m_fence_data = nullptr;
     }
 
@@ -92,11 +134,56 @@ public:
         return m_func;
     }
 
+#if defined(VGL_USE_LD)
+    /// Accessor.
+    ///
+    /// \return Queue timestamp.
+    constexpr uint64_t getQueueTime() const noexcept
+    {
+        return m_queue_time;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Deadline timestamp.
+    constexpr uint64_t getDeadline() const noexcept
+    {
+        return m_deadline;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Priority.
+    constexpr TaskPriority getPriority() const noexcept
+    {
+        return m_priority;
+    }
+
+    /// Setter.
+    ///
+    /// \param op Deadline timestamp.
+    constexpr void setDeadline(uint64_t op) noexcept
+    {
+        m_deadline = op;
+    }
+
+    /// Set queueing information.
+    ///
+    /// \param priority Priority.
+    /// \param queue_time Queue timestamp.
+    constexpr void setQueued(TaskPriority priority, uint64_t queue_time) noexcept
+    {
+        m_priority = priority;
+        m_queue_time = queue_time;
+    }
+#endif
+
 private:
     /// Internal destructor.
     void destruct()
     {
-        // Mutexes are recursive, so it's safe to lock just for signalling.
+        // Task may be destroyed with the dispatcher lock held. With futexes signalling never locks, otherwise the
+        // lock is taken again, which is only safe because SDL mutexes are recursive.
         if(m_fence_data)
         {
             detail::internal_fence_data_signal(*m_fence_data);
@@ -110,7 +197,17 @@ public:
     TaskFunc operator()()
     {
         VGL_ASSERT(m_func);
+#if defined(VGL_USE_LD)
+        bool trace = detail::internal_task_trace_enabled();
+        uint64_t trace_begin = trace ? detail::TaskTracer::get_timestamp() : 0;
+#endif
         void* ret = m_func(m_params);
+#if defined(VGL_USE_LD)
+        if(trace)
+        {
+            detail::internal_task_trace(m_func, trace_begin);
+        }
+#endif
         if(m_fence_data)
         {
             m_fence_data->setReturnValue(ret);
@@ -134,6 +231,11 @@ public:
         m_fence_data = other.m_fence_data;
         m_func = other.m_func;
         m_params = other.m_params;
+#if defined(VGL_USE_LD)
+        m_queue_time = other.m_queue_time;
+        m_deadline = other.m_deadline;
+        m_priority = other.m_priority;
+#endif
         other.m_fence_data = nullptr;
         return *this;
     }
@@ -3,6 +3,11 @@
 namespace vgl
 {
 
+#if defined(VGL_USE_LD)
+thread_local detail::TaskTraceBuffer* detail::TaskTracer::g_thread_buffer = nullptr;
+thread_local uint64_t detail::InternalTaskDispatcher::g_current_deadline = 0;
+#endif
+
 detail::InternalTaskDispatcher TaskDispatcher::g_instance;
 
 }
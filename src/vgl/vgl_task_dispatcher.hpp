@@ -7,6 +7,8 @@
 #include "vgl_vector.hpp"
 
 #if defined(VGL_USE_LD)
+#include "vgl_task_tracer.hpp"
+#include <iostream>
 #include <sstream>
 #endif
 
@@ -16,6 +18,153 @@ namespace vgl
 namespace detail
 {
 
+#if defined(VGL_USE_LD)
+/// Worker thread utilization statistics.
+class TaskWorkerStats
+{
+private:
+    /// Timestamp of thread start (ns).
+    uint64_t m_start;
+
+    /// Total time spent executing tasks (ns).
+    uint64_t m_busy = 0;
+
+    /// Number of tasks executed.
+    unsigned m_task_count = 0;
+
+public:
+    /// Constructor.
+    ///
+    /// \param start Thread start timestamp.
+    constexpr explicit TaskWorkerStats(uint64_t start) noexcept :
+        m_start(start)
+    {
+    }
+
+public:
+    /// Register an executed task.
+    ///
+    /// \param op Task execution time (ns).
+    constexpr void addTask(uint64_t op) noexcept
+    {
+        m_busy += op;
+        ++m_task_count;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Number of tasks executed.
+    constexpr unsigned getTaskCount() const noexcept
+    {
+        return m_task_count;
+    }
+
+    /// Get fraction of lifetime spent executing tasks.
+    ///
+    /// \param end End timestamp.
+    /// \return Utilization [0, 1].
+    constexpr float getUtilization(uint64_t end) const noexcept
+    {
+        if(end <= m_start)
+        {
+            return 0.0f;
+        }
+        return static_cast<float>(static_cast<double>(m_busy) / static_cast<double>(end - m_start));
+    }
+};
+
+/// Scheduling statistics for one task priority.
+class TaskPriorityStats
+{
+private:
+    /// Total time tasks spent queued (ns).
+    uint64_t m_queue_delay = 0;
+
+    /// Longest time a task spent queued (ns).
+    uint64_t m_queue_delay_max = 0;
+
+    /// Number of tasks executed.
+    unsigned m_task_count = 0;
+
+    /// Number of tasks executed that had a deadline.
+    unsigned m_deadline_count = 0;
+
+    /// Number of tasks that completed after their deadline.
+    unsigned m_deadline_miss_count = 0;
+
+public:
+    /// Default constructor.
+    constexpr explicit TaskPriorityStats() = default;
+
+public:
+    /// Register a task leaving the queue.
+    ///
+    /// \param op Time the task spent queued (ns).
+    constexpr void addQueueDelay(uint64_t op) noexcept
+    {
+        m_queue_delay += op;
+        m_queue_delay_max = max(m_queue_delay_max, op);
+        ++m_task_count;
+    }
+
+    /// Register completion of a task with a deadline.
+    ///
+    /// \param op True if the deadline was missed.
+    constexpr void addDeadline(bool op) noexcept
+    {
+        ++m_deadline_count;
+        if(op)
+        {
+            ++m_deadline_miss_count;
+        }
+    }
+
+    /// Accessor.
+    ///
+    /// \return Number of tasks executed.
+    constexpr unsigned getTaskCount() const noexcept
+    {
+        return m_task_count;
+    }
+
+    /// Get average queue delay.
+    ///
+    /// \return Average queue delay (us).
+    constexpr float getAverageQueueDelay() const noexcept
+    {
+        if(!m_task_count)
+        {
+            return 0.0f;
+        }
+        return static_cast<float>(static_cast<double>(m_queue_delay) / static_cast<double>(m_task_count) * 0.001);
+    }
+
+    /// Get maximum queue delay.
+    ///
+    /// \return Maximum queue delay (us).
+    constexpr float getMaxQueueDelay() const noexcept
+    {
+        return static_cast<float>(static_cast<double>(m_queue_delay_max) * 0.001);
+    }
+
+    /// Accessor.
+    ///
+    /// \return Number of tasks with a deadline.
+    constexpr unsigned getDeadlineCount() const noexcept
+    {
+        return m_deadline_count;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Number of missed deadlines.
+    constexpr unsigned getDeadlineMissCount() const noexcept
+    {
+        return m_deadline_miss_count;
+    }
+};
+#endif
+
 /// Task queue class.
 class InternalTaskDispatcher
 {
@@ -47,11 +196,44 @@ private:
     /// Number of threads waiting for tasks to execute.
     unsigned m_threads_waiting = 0;
 
+    /// Number of iterations to spin on a fence before sleeping.
+    unsigned m_fence_spin_count = FenceData::SPIN_COUNT;
+
 #if defined(VGL_USE_LD)
     /// Flag signifying the task queue is being destroyed.
     ///
     /// The flag is disabled for optimized build, because the program should never exit cleanly.
     bool m_quitting = false;
+
+    /// Utilization statistics for spawned threads, in order of thread startup.
+    vector<TaskWorkerStats> m_worker_stats;
+
+    /// Stack size for spawned threads (0: backend default).
+    unsigned m_worker_stack_size = 0;
+
+    /// Priority for spawned threads (negative: low, 0: normal, positive: high).
+    int m_worker_priority = 0;
+
+    /// Pin the main thread and spawned threads to separate logical processors.
+    bool m_worker_affinity = false;
+
+    /// Number of fence waits.
+    atomic<unsigned> m_fence_wait_count = 0;
+
+    /// Number of fence waits that had to sleep.
+    unsigned m_fence_sleep_count = 0;
+
+    /// Scheduling statistics per task priority.
+    TaskPriorityStats m_priority_stats[TASK_PRIORITY_COUNT];
+
+    /// Task execution tracer.
+    TaskTracer m_tracer;
+
+private:
+    /// Deadline of the task the calling thread is executing (ns, 0: none).
+    ///
+    /// Inherited by tasks dispatched without a deadline of their own.
+    static thread_local uint64_t g_current_deadline;
 #endif
 
 public:
@@ -86,6 +268,30 @@ public:
 
             // Threads must be joined before destroying anything else.
             m_threads.clear();
+
+            std::cout << "TaskDispatcher fences: " << m_fence_wait_count.load() << " waits, " <<
+                m_fence_sleep_count << " slept" << std::endl;
+            uint64_t end = TaskTracer::get_timestamp();
+            for(unsigned ii = 0; (ii < m_worker_stats.size()); ++ii)
+            {
+                const TaskWorkerStats& stats = m_worker_stats[ii];
+                std::cout << "TaskDispatcher worker " << ii << ": " << stats.getTaskCount() << " tasks, " <<
+                    (stats.getUtilization(end) * 100.0f) << "% utilization" << std::endl;
+            }
+            const char* priority_names[TASK_PRIORITY_COUNT] = { "high", "normal", "low" };
+            for(unsigned ii = 0; (ii < TASK_PRIORITY_COUNT); ++ii)
+            {
+                const TaskPriorityStats& stats = m_priority_stats[ii];
+                if(stats.getTaskCount())
+                {
+                    std::cout << "TaskDispatcher " << priority_names[ii] << " priority: " << stats.getTaskCount() <<
+                        " tasks, queue delay " << stats.getAverageQueueDelay() << "us avg, " <<
+                        stats.getMaxQueueDelay() << "us max, " << stats.getDeadlineMissCount() << "/" <<
+                        stats.getDeadlineCount() << " deadlines missed" << std::endl;
+                }
+            }
+
+            m_tracer.write();
         }
 #endif
     }
@@ -114,30 +320,64 @@ private:
     {
         FenceData* ret = acquireFenceDataSafe();
         ret->setActive(false);
+#if defined(VGL_USE_LD)
+        bool trace = m_tracer.isEnabled();
+        uint64_t trace_begin = trace ? TaskTracer::get_timestamp() : 0;
+#endif
         ret->setReturnValue(func(params));
+#if defined(VGL_USE_LD)
+        if(trace)
+        {
+            traceTask(func, trace_begin);
+        }
+#endif
         return Fence(ret);
     }
 
     /// Internally wait (create a fence) and dispatch.
     ///
     /// \param queue Internal task queue.
+    /// \param priority Task priority.
+    /// \param deadline Deadline in microseconds from now (0: none).
     /// \param func Function to dispatch.
     /// \param params Function parameters.
-    FenceData* internalDispatch(TaskQueue& task_queue, TaskFunc func, void* params)
+    FenceData* internalDispatch(TaskQueue& task_queue, TaskPriority priority, unsigned deadline, TaskFunc func,
+            void* params)
     {
         FenceData* ret = m_fence_pool.acquire();
         ret->setActive(true);
         ret->setReturnValue(nullptr);
-        task_queue.emplace(ret, func, params);
+        setDeadline(task_queue.emplace(priority, ret, func, params), deadline);
         return ret;
     }
 
-    /// Is the calling thread the main thread.
+    /// Set deadline of a queued task.
     ///
-    /// \return True if yes, false if no.
-    bool isMainThread() const
+    /// Deadlines are only used for statistics.
+    /// A task without a deadline of its own inherits the deadline of the task dispatching it.
+    ///
+    /// \param task Queued task.
+    /// \param op Deadline in microseconds from now (0: none).
+    static void setDeadline(Task& task, unsigned op)
     {
-        return (m_main_thread_id == Thread::get_current_thread_id());
+#if defined(VGL_USE_LD)
+        task.setDeadline(op ? (task.getQueueTime() + static_cast<uint64_t>(op) * 1000u) : g_current_deadline);
+#else
+        (void)task;
+        (void)op;
+#endif
+    }
+
+    /// Get the lowest task priority a worker may start now.
+    ///
+    /// Low priority tasks may not occupy the last free worker, so higher priority work never has to queue behind
+    /// bulk work. This is not possible with only one worker.
+    ///
+    /// \return Lowest allowed priority.
+    TaskPriority getLowestStartablePriority() const
+    {
+        return ((m_threads_active + 1 < m_concurrency) || (m_concurrency <= 1)) ? TaskPriority::LOW :
+            TaskPriority::NORMAL;
     }
 
     /// Is this a spawned thread?
@@ -161,7 +401,7 @@ private:
     {
 #if defined(VGL_USE_LD)
         string threadName = "InternalTaskDispatcher(" + to_string(m_threads.size()) + ")";
-        m_threads.emplace_back(task_thread_func, this, threadName.c_str());
+        m_threads.emplace_back(task_thread_func, this, threadName.c_str(), m_worker_stack_size);
 #else
         m_threads.emplace_back(task_thread_func, this);
 #endif
@@ -186,22 +426,49 @@ private:
         ScopedAcquire sa(m_mutex);
         --m_threads_waiting;
 
+#if defined(VGL_USE_LD)
+        unsigned worker_idx = m_worker_stats.size();
+        m_worker_stats.emplace_back(TaskTracer::get_timestamp());
+        m_tracer.registerThread("worker " + to_string(worker_idx));
+        applyWorkerSettings(worker_idx);
+#endif
+
 #if defined(VGL_USE_LD)
         while(!m_quitting)
 #else
         for(;;)
 #endif
         {
-            if((m_threads_active < m_concurrency) && !m_tasks_any.empty())
+            if((m_threads_active < m_concurrency) && m_tasks_any.hasTask(getLowestStartablePriority()))
             {
                 ++m_threads_active;
+#if defined(VGL_USE_LD)
+                uint64_t task_start = TaskTracer::get_timestamp();
+                TaskPriority priority;
+                uint64_t deadline;
+#endif
                 {
                     // Release lock for the duration of executing the task.
                     Task task = m_tasks_any.acquire();
+#if defined(VGL_USE_LD)
+                    priority = task.getPriority();
+                    deadline = task.getDeadline();
+                    m_priority_stats[static_cast<unsigned>(priority)].addQueueDelay(task_start - task.getQueueTime());
+                    g_current_deadline = deadline;
+#endif
                     sa.release();
                     task();
                 }
                 sa.acquire();
+#if defined(VGL_USE_LD)
+                uint64_t task_end = TaskTracer::get_timestamp();
+                g_current_deadline = 0;
+                m_worker_stats[worker_idx].addTask(task_end - task_start);
+                if(deadline)
+                {
+                    m_priority_stats[static_cast<unsigned>(priority)].addDeadline(task_end > deadline);
+                }
+#endif
                 --m_threads_active;
             }
             else
@@ -215,7 +482,47 @@ private:
         return 0;
     }
 
+#if defined(VGL_USE_LD)
+    /// Apply worker settings to the calling spawned thread.
+    ///
+    /// Spawned threads are distributed over logical processors other than the first one, which is reserved for the
+    /// main thread.
+    ///
+    /// \param op Index of the worker.
+    void applyWorkerSettings(unsigned op)
+    {
+        if(m_worker_affinity)
+        {
+            unsigned cpu_count = Thread::get_cpu_count();
+            if(cpu_count > 1)
+            {
+                unsigned cpu = (op % (cpu_count - 1)) + 1;
+                if(!Thread::set_current_thread_affinity(cpu))
+                {
+                    std::cerr << "WARNING: could not pin worker " << op << " to processor " << cpu << std::endl;
+                }
+            }
+        }
+        if(m_worker_priority)
+        {
+            if(!Thread::set_current_thread_priority(m_worker_priority))
+            {
+                std::cerr << "WARNING: could not set priority of worker " << op << " to " << m_worker_priority <<
+                    std::endl;
+            }
+        }
+    }
+#endif
+
 public:
+    /// Is the calling thread the main thread.
+    ///
+    /// \return True if yes, false if no.
+    bool isMainThread() const
+    {
+        return (m_main_thread_id == Thread::get_current_thread_id());
+    }
+
     /// Initialize the task queue.
     ///
     /// \param op Number of threads to initialize.
@@ -224,6 +531,24 @@ public:
         m_concurrency = op;
         m_main_thread_id = Thread::get_current_thread_id();
 
+#if defined(VGL_USE_LD)
+        m_tracer.registerThread("main");
+
+        // Spinning is wasted time if there is no other processor to signal the fence.
+        if(Thread::get_cpu_count() <= 1)
+        {
+            m_fence_spin_count = 0;
+        }
+
+        if(m_worker_affinity && (Thread::get_cpu_count() > 1))
+        {
+            if(!Thread::set_current_thread_affinity(0))
+            {
+                std::cerr << "WARNING: could not pin main thread to processor 0" << std::endl;
+            }
+        }
+#endif
+
         m_tasks_any.initialize();
         m_tasks_main.initialize();
         m_mutex = Mutex();
@@ -244,7 +569,17 @@ public:
         {
             if(m_tasks_main.empty())
             {
+#if defined(VGL_USE_LD)
+                bool trace = m_tracer.isEnabled();
+                uint64_t trace_begin = trace ? TaskTracer::get_timestamp() : 0;
+#endif
                 m_tasks_main.wait(sa);
+#if defined(VGL_USE_LD)
+                if(trace)
+                {
+                    m_tracer.record(TaskTraceType::MAIN_WAIT, nullptr, trace_begin);
+                }
+#endif
             }
             else
             {
@@ -255,16 +590,22 @@ public:
         return Task();
     }
 
-    /// Mark fence data as inactive (from locked context) and signal threads waiting on it.
+    /// Mark fence data as inactive and wake threads sleeping on it.
+    ///
+    /// The dispatcher lock is only taken if someone is sleeping on the fence and futexes are not available.
     ///
     /// \param op Fence data.
     void fenceSignal(FenceData& op)
     {
+        if(op.deactivate())
         {
+#if defined(VGL_HAS_FUTEX)
+            op.wake();
+#else
             ScopedAcquire sa(m_mutex);
-            op.setActive(false);
+            op.wake(sa);
+#endif
         }
-        op.signal();
     }
 
     /// Wait on a fence internal state.
@@ -273,52 +614,80 @@ public:
     /// \return Stored return value from the fence.
     void* fenceWait(Fence& op)
     {
-        ScopedAcquire sa(m_mutex);
+        FenceData* data = op.releaseData();
+#if defined(VGL_USE_LD)
+        ++m_fence_wait_count;
+        bool trace = m_tracer.isEnabled() && data->isActive();
+        uint64_t trace_begin = trace ? TaskTracer::get_timestamp() : 0;
+#endif
 
-        // Fence may have turned inactive before the wait point is reached.
-        if(op)
+        // Fence may turn inactive while spinning, in which case the dispatcher lock is never taken.
+        if(!data->spin(m_fence_spin_count))
         {
-#if defined(VGL_USE_LD) && defined(DEBUG)
-            if(isMainThread())
+            ScopedAcquire sa(m_mutex);
+
+            if(data->prepareSleep())
             {
-                VGL_THROW_RUNTIME_ERROR("cannot wait on main thread");
-            }
+#if defined(VGL_USE_LD) && defined(DEBUG)
+                if(isMainThread())
+                {
+                    VGL_THROW_RUNTIME_ERROR("cannot wait on main thread");
+                }
+#endif
+#if defined(VGL_USE_LD)
+                ++m_fence_sleep_count;
 #endif
 
-            bool is_spawned = isSpawnedThread();
+                bool is_spawned = isSpawnedThread();
 
-            // If waiting would lock the last concurrent thread, spawn a new thread.
-            if(is_spawned)
-            {
-                if(m_threads_waiting <= 0)
+                // If waiting would lock the last concurrent thread, spawn a new thread.
+                if(is_spawned)
                 {
-                    spawnThread();
+                    if(m_threads_waiting <= 0)
+                    {
+                        spawnThread();
+                    }
+                    --m_threads_active;
                 }
-                --m_threads_active;
-            }
 
-            m_tasks_any.signal();
-            op.wait(sa);
+                m_tasks_any.signal();
+#if defined(VGL_HAS_FUTEX)
+                sa.release();
+                data->sleep();
+                sa.acquire();
+#else
+                data->sleep(sa);
+#endif
 
-            if(is_spawned)
-            {
-                ++m_threads_active;
+                if(is_spawned)
+                {
+                    ++m_threads_active;
+                }
             }
         }
 
-        FenceData* data = op.releaseData();
+#if defined(VGL_USE_LD)
+        if(trace)
+        {
+            m_tracer.record(TaskTraceType::FENCE_WAIT, nullptr, trace_begin);
+        }
+#endif
+
+        void* ret = data->getReturnValue();
         m_fence_pool.emplace(data);
-        return data->getReturnValue();
+        return ret;
     }
 
     /// Dispatch a task (any thread).
     ///
     /// \param func Function to dispatch.
     /// \param params Function parameters.
-    void dispatch(TaskFunc func, void* params)
+    /// \param priority Task priority.
+    /// \param deadline Deadline in microseconds from now (0: none).
+    void dispatch(TaskFunc func, void* params, TaskPriority priority, unsigned deadline)
     {
         ScopedAcquire sa(m_mutex);
-        m_tasks_any.emplace(func, params);
+        setDeadline(m_tasks_any.emplace(priority, func, params), deadline);
         spawnThreadIfBelowConcurrency();
     }
     /// Dispatch a task (main thread).
@@ -328,15 +697,17 @@ public:
     void dispatchMain(TaskFunc func, void* params)
     {
         ScopedAcquire sa(m_mutex);
-        m_tasks_main.emplace(func, params);
+        m_tasks_main.emplace(TaskPriority::NORMAL, func, params);
     }
 
     /// Dispatch a task and wait for it to complete (any thread).
     ///
     /// \param func Function to dispatch.
     /// \param params Function parameters.
+    /// \param priority Task priority.
+    /// \param deadline Deadline in microseconds from now (0: none).
     /// \return Fence.
-    Fence wait(TaskFunc func, void* params)
+    Fence wait(TaskFunc func, void* params, TaskPriority priority, unsigned deadline)
     {
         // Prevent deadlock - main thread cannot wait.
         if(isMainThread())
@@ -345,7 +716,7 @@ public:
         }
 
         ScopedAcquire sa(m_mutex);
-        FenceData* data = internalDispatch(m_tasks_any, func, params);
+        FenceData* data = internalDispatch(m_tasks_any, priority, deadline, func, params);
         spawnThreadIfBelowConcurrency();
         return Fence(data);
     }
@@ -363,10 +734,71 @@ public:
         }
 
         ScopedAcquire sa(m_mutex);
-        FenceData* data = internalDispatch(m_tasks_main, func, params);
+        FenceData* data = internalDispatch(m_tasks_main, TaskPriority::NORMAL, 0, func, params);
         return Fence(data);
     }
 
+#if defined(VGL_USE_LD)
+public:
+    /// Setter.
+    ///
+    /// \param op Stack size for spawned threads.
+    void setWorkerStackSize(unsigned op)
+    {
+        m_worker_stack_size = op;
+    }
+
+    /// Setter.
+    ///
+    /// \param op Priority for spawned threads.
+    void setWorkerPriority(int op)
+    {
+        m_worker_priority = op;
+    }
+
+    /// Setter.
+    ///
+    /// \param op Affinity flag.
+    void setWorkerAffinity(bool op)
+    {
+        m_worker_affinity = op;
+    }
+
+    /// Enable tracing.
+    ///
+    /// \param op Trace output filename.
+    void enableTrace(string_view op)
+    {
+        m_tracer.enable(op);
+    }
+
+    /// Set a human-readable name for a task function for tracing.
+    ///
+    /// \param func Task function.
+    /// \param name Name.
+    void setTaskName(TaskFunc func, const char* name)
+    {
+        m_tracer.setName(reinterpret_cast<const void*>(func), name);
+    }
+
+    /// Is task tracing enabled?
+    ///
+    /// \return True if enabled.
+    bool isTraceEnabled() const
+    {
+        return m_tracer.isEnabled();
+    }
+
+    /// Record a task execution for tracing.
+    ///
+    /// \param func Task function that was executed.
+    /// \param begin Timestamp of task start.
+    void traceTask(TaskFunc func, uint64_t begin)
+    {
+        m_tracer.record(TaskTraceType::TASK, reinterpret_cast<const void*>(func), begin);
+    }
+#endif
+
 private:
     /// Task dispatcher thread.
     ///
@@ -423,11 +855,17 @@ public:
 
     /// Dispatch task (any thread).
     ///
+    /// Deadlines are only tracked in scheduling statistics. A task dispatched without a deadline inherits the
+    /// deadline of the task dispatching it.
+    ///
     /// \param func Function to dispatch.
     /// \param params Function parameters.
-    static void dispatch(TaskFunc func, void* params)
+    /// \param priority Task priority.
+    /// \param deadline Deadline in microseconds from now (0: none).
+    static void dispatch(TaskFunc func, void* params, TaskPriority priority = TaskPriority::NORMAL,
+            unsigned deadline = 0)
     {
-        g_instance.dispatch(func, params);
+        g_instance.dispatch(func, params, priority, deadline);
     }
 
     /// Dispatch task (main thread).
@@ -443,10 +881,13 @@ public:
     ///
     /// \param func Function to dispatch.
     /// \param params Function parameters.
+    /// \param priority Task priority.
+    /// \param deadline Deadline in microseconds from now (0: none).
     /// \return Fence.
-    static Fence wait(TaskFunc func, void* params)
+    static Fence wait(TaskFunc func, void* params, TaskPriority priority = TaskPriority::NORMAL,
+            unsigned deadline = 0)
     {
-        return g_instance.wait(func, params);
+        return g_instance.wait(func, params, priority, deadline);
     }
 
     /// Wait on a task (main thread).
@@ -458,6 +899,99 @@ public:
     {
         return g_instance.waitMain(func, params);
     }
+
+    /// Is the calling thread the main thread.
+    ///
+    /// The main thread cannot wait on fences, tasks it would wait on must be run directly.
+    ///
+    /// \return True if yes, false if no.
+    static bool is_main_thread()
+    {
+        return g_instance.isMainThread();
+    }
+
+#if defined(VGL_USE_LD)
+public:
+    /// Gets the default concurrency level.
+    ///
+    /// One logical processor is left for the main thread.
+    ///
+    /// \return Number of logical processors minus one, at least 1.
+    static unsigned get_default_concurrency()
+    {
+        unsigned cpu_count = Thread::get_cpu_count();
+        return (cpu_count > 1) ? (cpu_count - 1) : 1u;
+    }
+
+    /// Set worker thread stack size.
+    ///
+    /// Must be called before spawning any threads.
+    ///
+    /// \param op Stack size in bytes, 0 for backend default.
+    static void set_worker_stack_size(unsigned op)
+    {
+        g_instance.setWorkerStackSize(op);
+    }
+
+    /// Set worker thread priority.
+    ///
+    /// Must be called before spawning any threads.
+    ///
+    /// \param op Priority, negative for low, 0 for normal, positive for high.
+    static void set_worker_priority(int op)
+    {
+        g_instance.setWorkerPriority(op);
+    }
+
+    /// Enable or disable worker thread affinity.
+    ///
+    /// Must be called before initialization.
+    ///
+    /// \param op True to pin main thread and worker threads to separate logical processors.
+    static void set_worker_affinity(bool op)
+    {
+        g_instance.setWorkerAffinity(op);
+    }
+
+    /// Enable task tracing.
+    ///
+    /// Must be called before initialization. Trace is written as a Chrome trace event file when the task dispatcher
+    /// is destroyed.
+    ///
+    /// \param op Trace output filename.
+    static void enable_trace(string_view op)
+    {
+        g_instance.enableTrace(op);
+    }
+
+    /// Set a human-readable name for a task function for tracing.
+    ///
+    /// Unnamed task functions are identified by their address.
+    ///
+    /// \param func Task function.
+    /// \param name Name, must outlive the task dispatcher.
+    static void set_task_name(TaskFunc func, const char* name)
+    {
+        g_instance.setTaskName(func, name);
+    }
+
+    /// Is task tracing enabled?
+    ///
+    /// \return True if enabled.
+    static bool is_trace_enabled()
+    {
+        return g_instance.isTraceEnabled();
+    }
+
+    /// Record a task execution for tracing.
+    ///
+    /// \param func Task function that was executed.
+    /// \param begin Timestamp of task start.
+    static void trace_task(TaskFunc func, uint64_t begin)
+    {
+        g_instance.traceTask(func, begin);
+    }
+#endif
 };
 
 namespace detail
@@ -479,6 +1013,25 @@ inline void* internal_fence_wait(Fence& op)
     return TaskDispatcher::fence_wait(op);
 }
 
+#if defined(VGL_USE_LD)
+/// Internal check for task tracing.
+///
+/// \return True if tracing is enabled.
+inline bool internal_task_trace_enabled()
+{
+    return TaskDispatcher::is_trace_enabled();
+}
+
+/// Internal record of task execution.
+///
+/// \param func Task function that was executed.
+/// \param begin Timestamp of task start.
+inline void internal_task_trace(TaskFunc func, uint64_t begin)
+{
+    TaskDispatcher::trace_task(func, begin);
+}
+#endif
+
 }
 
 }
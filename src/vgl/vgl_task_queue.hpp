@@ -11,11 +11,14 @@ namespace detail
 {
 
 /// Task queue class.
+///
+/// Tasks are stored in separate lanes by priority. Tasks are acquired from the highest priority lane that has
+/// tasks, in FIFO order within the lane.
 class TaskQueue
 {
 private:
-    /// Queue for tasks.
-    queue<Task> m_tasks;
+    /// Queues for tasks, one per priority.
+    queue<Task> m_tasks[TASK_PRIORITY_COUNT];
 
     /// Condition variable to be signalled when the task queue is modified.
     Cond m_cond = Cond(nullptr);
@@ -42,9 +45,12 @@ public:
     {
         m_cond.broadcast();
 #if defined(VGL_USE_LD)
-        while(!m_tasks.empty())
+        for(auto& vv : m_tasks)
         {
-            m_tasks.pop();
+            while(!vv.empty())
+            {
+                vv.pop();
+            }
         }
 #endif
     }
@@ -68,7 +74,12 @@ public:
     /// \return Number of tasks in the queue.
     constexpr unsigned size() const noexcept
     {
-        return m_tasks.size();
+        unsigned ret = 0;
+        for(const auto& vv : m_tasks)
+        {
+            ret += vv.size();
+        }
+        return ret;
     }
 
     /// Tell if the task queue is empty.
@@ -76,41 +87,60 @@ public:
     /// \return True if empty, false otherwise.
     constexpr bool empty() const noexcept
     {
-        return m_tasks.empty();
+        return !hasTask(TaskPriority::LOW);
     }
 
-    /// Acquire from the task queue.
+    /// Tell if the task queue has tasks of given priority or higher.
     ///
-    /// \return Task.
-    Task acquire()
+    /// \param op Lowest priority to consider.
+    /// \return True if such tasks exist, false otherwise.
+    constexpr bool hasTask(TaskPriority op) const noexcept
     {
-        Task ret = move(m_tasks.front());
-        m_tasks.pop();
-        return ret;
+        for(unsigned ii = 0; (ii <= static_cast<unsigned>(op)); ++ii)
+        {
+            if(!m_tasks[ii].empty())
+            {
+                return true;
+            }
+        }
+        return false;
     }
 
-    /// Emplace into the task queue.
+    /// Acquire from the task queue.
     ///
-    /// Implicitly signals.
+    /// Queue must not be empty.
     ///
-    /// \param func Function to dispatch.
-    /// \param params Function parameters.
-    void emplace(TaskFunc func, void* params)
+    /// \return Task from the highest priority lane that has tasks.
+    Task acquire()
     {
-        m_tasks.emplace(func, params);
-        m_cond.signal();
+        queue<Task>* lane = m_tasks;
+        while(lane->empty())
+        {
+            ++lane;
+            VGL_ASSERT(lane < (m_tasks + TASK_PRIORITY_COUNT));
+        }
+        Task ret = move(lane->front());
+        lane->pop();
+        return ret;
     }
+
     /// Emplace into the task queue.
     ///
     /// Implicitly signals.
     ///
-    /// \param fence_data Fence data to use with the task.
-    /// \param func Function to dispatch.
-    /// \param params Function parameters.
-    void emplace(detail::FenceData* fence_data, TaskFunc func, void* params)
+    /// \param priority Task priority.
+    /// \param args Task constructor arguments.
+    /// \return Reference to the emplaced task.
+    template<typename...Args> Task& emplace(TaskPriority priority, Args&&...args)
     {
-        m_tasks.emplace(fence_data, func, params);
+        queue<Task>& lane = m_tasks[static_cast<unsigned>(priority)];
+        lane.emplace(args...);
         m_cond.signal();
+        Task& ret = lane.back();
+#if defined(VGL_USE_LD)
+        ret.setQueued(priority, TaskTracer::get_timestamp());
+#endif
+        return ret;
     }
 };
 
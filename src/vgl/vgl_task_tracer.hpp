@@ -0,0 +1,341 @@
+#ifndef VGL_TASK_TRACER_HPP
+#define VGL_TASK_TRACER_HPP
+
+/// \file Task execution tracing.
+/// This file only makes sense when not building size-minimized.
+
+#include "vgl_config.hpp"
+
+#if defined(VGL_USE_LD)
+
+#include "vgl_atomic.hpp"
+#include "vgl_filesystem.hpp"
+#include "vgl_unique_ptr.hpp"
+#include "vgl_vector.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace vgl
+{
+
+namespace detail
+{
+
+/// Trace event type.
+enum class TaskTraceType
+{
+    /// Task execution.
+    TASK,
+
+    /// Waiting on a fence.
+    FENCE_WAIT,
+
+    /// Main thread waiting for main thread tasks.
+    MAIN_WAIT,
+};
+
+/// Trace event.
+class TaskTraceEvent
+{
+private:
+    /// Task function (only for task events).
+    const void* m_func;
+
+    /// Begin timestamp (ns).
+    uint64_t m_begin;
+
+    /// End timestamp (ns).
+    uint64_t m_end;
+
+    /// Event type.
+    TaskTraceType m_type;
+
+public:
+    /// Constructor.
+    ///
+    /// \param type Event type.
+    /// \param func Task function.
+    /// \param begin Begin timestamp.
+    /// \param end End timestamp.
+    constexpr explicit TaskTraceEvent(TaskTraceType type, const void* func, uint64_t begin, uint64_t end) noexcept :
+        m_func(func),
+        m_begin(begin),
+        m_end(end),
+        m_type(type)
+    {
+    }
+
+public:
+    /// Accessor.
+    ///
+    /// \return Task function.
+    constexpr const void* getFunc() const noexcept
+    {
+        return m_func;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Begin timestamp.
+    constexpr uint64_t getBegin() const noexcept
+    {
+        return m_begin;
+    }
+
+    /// Accessor.
+    ///
+    /// \return End timestamp.
+    constexpr uint64_t getEnd() const noexcept
+    {
+        return m_end;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Event type.
+    constexpr TaskTraceType getType() const noexcept
+    {
+        return m_type;
+    }
+};
+
+/// Per-thread trace event buffer.
+///
+/// Only written by the owning thread, no locking is necessary.
+class TaskTraceBuffer
+{
+private:
+    /// Recorded events.
+    vector<TaskTraceEvent> m_events;
+
+    /// Thread name.
+    string m_name;
+
+public:
+    /// Constructor.
+    ///
+    /// \param name Thread name.
+    explicit TaskTraceBuffer(string_view name) :
+        m_name(name)
+    {
+    }
+
+public:
+    /// Accessor.
+    ///
+    /// \return Recorded events.
+    const vector<TaskTraceEvent>& getEvents() const
+    {
+        return m_events;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Thread name.
+    const string& getName() const
+    {
+        return m_name;
+    }
+
+    /// Record an event.
+    ///
+    /// \param args Event constructor arguments.
+    template<typename...Args> void record(Args&&...args)
+    {
+        m_events.emplace_back(args...);
+    }
+};
+
+/// Task tracer.
+///
+/// Records task execution and waits into per-thread buffers and writes them out as a Chrome trace event JSON file,
+/// viewable in Perfetto or chrome://tracing.
+class TaskTracer
+{
+private:
+    /// Trace buffers for all registered threads.
+    vector<unique_ptr<TaskTraceBuffer>> m_buffers;
+
+    /// Human-readable names for task functions.
+    vector<std::pair<const void*, const char*>> m_names;
+
+    /// Output filename.
+    string m_filename;
+
+    /// Timestamp of tracing start.
+    uint64_t m_start = 0;
+
+    /// Is tracing enabled?
+    atomic<bool> m_enabled = false;
+
+private:
+    /// Trace buffer of the calling thread.
+    static thread_local TaskTraceBuffer* g_thread_buffer;
+
+public:
+    /// Default constructor.
+    explicit TaskTracer() = default;
+
+    /// Deleted copy constructor.
+    TaskTracer(const TaskTracer&) = delete;
+    /// Deleted assignment.
+    TaskTracer& operator=(const TaskTracer&) = delete;
+
+private:
+    /// Get name of a task function.
+    ///
+    /// \param op Task function.
+    /// \return Name string.
+    string getName(const void* op) const
+    {
+        for(const auto& vv : m_names)
+        {
+            if(vv.first == op)
+            {
+                return string(vv.second);
+            }
+        }
+        return "task " + to_string(const_cast<void*>(op));
+    }
+
+public:
+    /// Tell if tracing is enabled.
+    ///
+    /// \return True if enabled.
+    bool isEnabled() const noexcept
+    {
+        return m_enabled.load(memory_order_relaxed);
+    }
+
+    /// Enable tracing.
+    ///
+    /// Must be called before any threads are registered.
+    ///
+    /// \param op Output filename.
+    void enable(string_view op)
+    {
+        m_filename = string(op);
+        m_start = get_timestamp();
+        m_enabled = true;
+    }
+
+    /// Set name for a task function.
+    ///
+    /// \param func Task function.
+    /// \param name Name, must be a string literal or otherwise outlive the tracer.
+    void setName(const void* func, const char* name)
+    {
+        m_names.emplace_back(func, name);
+    }
+
+    /// Register the calling thread.
+    ///
+    /// Must be called from a locked context.
+    ///
+    /// \param op Thread name.
+    void registerThread(string_view op)
+    {
+        if(isEnabled())
+        {
+            m_buffers.emplace_back(new TaskTraceBuffer(op));
+            g_thread_buffer = m_buffers.back().get();
+        }
+    }
+
+    /// Record an event for the calling thread.
+    ///
+    /// Ignored if the thread has not been registered.
+    ///
+    /// \param type Event type.
+    /// \param func Task function.
+    /// \param begin Begin timestamp.
+    void record(TaskTraceType type, const void* func, uint64_t begin)
+    {
+        if(g_thread_buffer)
+        {
+            g_thread_buffer->record(type, func, begin, get_timestamp());
+        }
+    }
+
+    /// Write the trace file.
+    ///
+    /// Must only be called after all registered threads have stopped recording.
+    void write() const
+    {
+        if(!isEnabled())
+        {
+            return;
+        }
+
+        std::ostringstream sstr;
+        sstr << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+        bool first = true;
+        unsigned event_count = 0;
+
+        for(unsigned ii = 0; (ii < m_buffers.size()); ++ii)
+        {
+            const TaskTraceBuffer& buffer = *m_buffers[ii];
+            sstr << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ii <<
+                ",\"args\":{\"name\":\"" << buffer.getName() << "\"}}";
+            first = false;
+
+            for(const auto& vv : buffer.getEvents())
+            {
+                const char* category = "task";
+                string name;
+                switch(vv.getType())
+                {
+                case TaskTraceType::FENCE_WAIT:
+                    category = "wait";
+                    name = "fence wait";
+                    break;
+
+                case TaskTraceType::MAIN_WAIT:
+                    category = "wait";
+                    name = "main thread idle";
+                    break;
+
+                case TaskTraceType::TASK:
+                default:
+                    name = getName(vv.getFunc());
+                    break;
+                }
+
+                sstr << ",\n{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"X\",\"ts\":" <<
+                    (static_cast<double>(vv.getBegin() - m_start) * 0.001) << ",\"dur\":" <<
+                    (static_cast<double>(vv.getEnd() - vv.getBegin()) * 0.001) << ",\"pid\":1,\"tid\":" << ii <<
+                    "}";
+                ++event_count;
+            }
+        }
+        sstr << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+        std::string contents = sstr.str();
+        if(path(m_filename).write(string_view(contents.data(), static_cast<unsigned>(contents.length()))))
+        {
+            std::cout << "TaskTracer: wrote " << event_count << " events from " << m_buffers.size() <<
+                " threads to '" << m_filename << "'" << std::endl;
+        }
+    }
+
+public:
+    /// Gets a monotonic timestamp.
+    ///
+    /// \return Timestamp in nanoseconds.
+    static uint64_t get_timestamp()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+}
+
+}
+
+#endif
+
+#endif
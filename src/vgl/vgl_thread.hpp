@@ -3,10 +3,22 @@
 
 #if defined(VGL_ENABLE_GTK)
 #include "vgl_extern_gtk.hpp"
+#elif defined(VGL_ENABLE_PTHREAD)
+#include "vgl_extern_pthread.hpp"
 #else
 #include "vgl_extern_sdl.hpp"
 #endif
 
+#if defined(VGL_USE_LD) && defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(VGL_USE_LD) && defined(DEBUG) && defined(VGL_ENABLE_PTHREAD)
+#include "vgl_string.hpp"
+#include "vgl_throw_exception.hpp"
+#endif
+
 namespace vgl
 {
 
@@ -18,6 +30,8 @@ public:
     using thread_type =
 #if defined(VGL_ENABLE_GTK)
         GThread
+#elif defined(VGL_ENABLE_PTHREAD)
+        pthread_t
 #else
         SDL_Thread
 #endif
@@ -27,6 +41,8 @@ public:
     using id_type =
 #if defined(VGL_ENABLE_GTK)
         GThread*
+#elif defined(VGL_ENABLE_PTHREAD)
+        pthread_t
 #else
         SDL_threadID
 #endif
@@ -34,7 +50,7 @@ public:
 
     /// Internal thread function return type.
     using return_type =
-#if defined(VGL_ENABLE_GTK)
+#if defined(VGL_ENABLE_GTK) || defined(VGL_ENABLE_PTHREAD)
         void*
 #else
         int
@@ -48,7 +64,7 @@ private:
     /// Actual thread.
     thread_type* m_thread;
 
-#if !defined(VGL_ENABLE_GTK)
+#if !defined(VGL_ENABLE_GTK) && !defined(VGL_ENABLE_PTHREAD)
     /// Thread ID.
     SDL_threadID m_id;
 #endif
@@ -67,19 +83,53 @@ public:
     explicit Thread(func_type func, void* data, const char* name = nullptr) :
 #if defined(VGL_ENABLE_GTK)
         m_thread(dnload_g_thread_new(name, func, data))
+#elif defined(VGL_ENABLE_PTHREAD)
+        m_thread(create_pthread(func, data, 0))
 #else
         m_thread(dnload_SDL_CreateThread(func, name, data)),
         m_id(dnload_SDL_GetThreadID(m_thread))
 #endif
     {
+#if defined(VGL_ENABLE_PTHREAD)
+        (void)name;
+#endif
+    }
+
+#if defined(VGL_USE_LD)
+    /// Constructor with explicit stack size.
+    ///
+    /// GTK backend does not support setting the stack size, in which case it is ignored.
+    ///
+    /// \param func Function pointer to run.
+    /// \param data Data for function.
+    /// \param name Thread name.
+    /// \param stack_size Stack size in bytes, 0 for backend default.
+    explicit Thread(func_type func, void* data, const char* name, unsigned stack_size) :
+#if defined(VGL_ENABLE_GTK)
+        m_thread(dnload_g_thread_new(name, func, data))
+#elif defined(VGL_ENABLE_PTHREAD)
+        m_thread(create_pthread(func, data, stack_size))
+#else
+        m_thread(stack_size ?
+                dnload_SDL_CreateThreadWithStackSize(func, name, stack_size, data) :
+                dnload_SDL_CreateThread(func, name, data)),
+        m_id(dnload_SDL_GetThreadID(m_thread))
+#endif
+    {
+#if defined(VGL_ENABLE_GTK)
+        (void)stack_size;
+#elif defined(VGL_ENABLE_PTHREAD)
+        (void)name;
+#endif
     }
+#endif
 
     /// Move constructor.
     ///
     /// \param op Source.
     constexpr Thread(Thread&& op) noexcept :
         m_thread(op.m_thread)
-#if !defined(VGL_ENABLE_GTK)
+#if !defined(VGL_ENABLE_GTK) && !defined(VGL_ENABLE_PTHREAD)
         , m_id(op.m_id)
 #endif
     {
@@ -95,6 +145,9 @@ public:
         {
 #if defined(VGL_ENABLE_GTK)
             dnload_g_thread_join(m_thread);
+#elif defined(VGL_ENABLE_PTHREAD)
+            dnload_pthread_join(*m_thread, nullptr);
+            delete m_thread;
 #else
             dnload_SDL_WaitThread(m_thread, NULL);
 #endif
@@ -109,6 +162,8 @@ public:
     {
 #if defined(VGL_ENABLE_GTK)
         return m_thread;
+#elif defined(VGL_ENABLE_PTHREAD)
+        return *m_thread;
 #else
         return m_id;
 #endif
@@ -122,7 +177,7 @@ public:
     constexpr Thread& operator=(Thread&& op) noexcept
     {
         m_thread = op.m_thread;
-#if !defined(VGL_ENABLE_GTK)
+#if !defined(VGL_ENABLE_GTK) && !defined(VGL_ENABLE_PTHREAD)
         m_id = op.m_id;
 #endif
         op.m_thread = nullptr;
@@ -137,11 +192,104 @@ public:
         return
 #if defined(VGL_ENABLE_GTK)
             dnload_g_thread_self()
+#elif defined(VGL_ENABLE_PTHREAD)
+            dnload_pthread_self()
 #else
             dnload_SDL_ThreadID()
 #endif
             ;
     }
+
+#if defined(VGL_USE_LD)
+    /// Gets the number of logical processors on the system.
+    ///
+    /// \return Number of logical processors, at least 1.
+    static unsigned get_cpu_count()
+    {
+        int ret =
+#if defined(VGL_ENABLE_GTK)
+            static_cast<int>(dnload_g_get_num_processors())
+#elif defined(VGL_ENABLE_PTHREAD)
+            static_cast<int>(dnload_sysconf(_SC_NPROCESSORS_ONLN))
+#else
+            dnload_SDL_GetCPUCount()
+#endif
+            ;
+        return (ret > 1) ? static_cast<unsigned>(ret) : 1u;
+    }
+
+    /// Pins the calling thread to given logical processor.
+    ///
+    /// Only implemented on Linux.
+    ///
+    /// \param op Logical processor index.
+    /// \return True on success, false if not supported or failed.
+    static bool set_current_thread_affinity(unsigned op)
+    {
+#if defined(__linux__)
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(op, &cpus);
+        return (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0);
+#else
+        (void)op;
+        return false;
+#endif
+    }
+
+    /// Sets the priority of the calling thread.
+    ///
+    /// Not implemented for the GTK backend.
+    ///
+    /// \param op Priority, negative for low, 0 for normal, positive for high.
+    /// \return True on success, false if not supported or failed.
+    static bool set_current_thread_priority(int op)
+    {
+#if defined(VGL_ENABLE_GTK)
+        (void)op;
+        return false;
+#elif defined(VGL_ENABLE_PTHREAD)
+        // Linux threads have their own nice values.
+        int nice_value = (op < 0) ? 10 : ((op > 0) ? -10 : 0);
+        return (dnload_setpriority(PRIO_PROCESS, static_cast<id_t>(dnload_syscall(SYS_gettid)), nice_value) == 0);
+#else
+        SDL_ThreadPriority priority = (op < 0) ? SDL_THREAD_PRIORITY_LOW :
+            ((op > 0) ? SDL_THREAD_PRIORITY_HIGH : SDL_THREAD_PRIORITY_NORMAL);
+        return (dnload_SDL_SetThreadPriority(priority) == 0);
+#endif
+    }
+#endif
+
+#if defined(VGL_ENABLE_PTHREAD)
+private:
+    /// Create a POSIX thread.
+    ///
+    /// \param func Function pointer to run.
+    /// \param data Data for function.
+    /// \param stack_size Stack size in bytes, 0 for default.
+    /// \return Newly allocated thread.
+    static pthread_t* create_pthread(func_type func, void* data, unsigned stack_size)
+    {
+        pthread_t* ret = new pthread_t;
+        pthread_attr_t attr;
+        dnload_pthread_attr_init(&attr);
+        if(stack_size)
+        {
+            dnload_pthread_attr_setstacksize(&attr, stack_size);
+        }
+        int err = dnload_pthread_create(ret, &attr, func, data);
+        dnload_pthread_attr_destroy(&attr);
+#if defined(VGL_USE_LD) && defined(DEBUG)
+        if(err)
+        {
+            VGL_THROW_RUNTIME_ERROR("Thread::create_pthread(): error " + to_string(err));
+        }
+#else
+        (void)err;
+#endif
+        return ret;
+    }
+#endif
 };
 
 }
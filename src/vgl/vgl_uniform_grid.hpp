@@ -0,0 +1,147 @@
+#ifndef VGL_UNIFORM_GRID_HPP
+#define VGL_UNIFORM_GRID_HPP
+
+#include "vgl_array.hpp"
+#include "vgl_bounding_box.hpp"
+#include "vgl_vector.hpp"
+
+namespace vgl
+{
+
+/// Uniform grid on the XZ plane for bounding box collision checks.
+///
+/// Boxes are stored into every cell they touch. Cells are hashed into a fixed number of buckets, so the grid needs no
+/// bounds. Boxes touching too many cells are stored into a separate list that is always tested.
+class UniformGrid
+{
+private:
+    /// Number of buckets, must be a power of two.
+    static const unsigned BUCKET_COUNT = 1024;
+
+    /// Maximum number of cells a box may touch to be stored into cells.
+    static const unsigned MAX_CELLS = 64;
+
+private:
+    /// Stored bounding boxes.
+    vector<BoundingBox> m_boxes;
+
+    /// Box indices in each bucket.
+    array<vector<unsigned>, BUCKET_COUNT> m_buckets;
+
+    /// Box indices touching too many cells.
+    vector<unsigned> m_large;
+
+    /// Cell size.
+    float m_cell_size;
+
+public:
+    /// Constructor.
+    ///
+    /// \param cell_size Cell size, preferably close to the size of typical boxes.
+    explicit UniformGrid(float cell_size) :
+        m_cell_size(cell_size)
+    {
+    }
+
+public:
+    /// Insert a bounding box.
+    ///
+    /// \param op Bounding box.
+    void insert(const BoundingBox& op)
+    {
+        unsigned idx = m_boxes.size();
+        m_boxes.push_back(op);
+
+        int x1 = cellCoordinate(op.getMin().x());
+        int x2 = cellCoordinate(op.getMax().x());
+        int z1 = cellCoordinate(op.getMin().z());
+        int z2 = cellCoordinate(op.getMax().z());
+        if((static_cast<unsigned>(x2 - x1 + 1) * static_cast<unsigned>(z2 - z1 + 1)) > MAX_CELLS)
+        {
+            m_large.push_back(idx);
+            return;
+        }
+
+        for(int ii = z1; (ii <= z2); ++ii)
+        {
+            for(int jj = x1; (jj <= x2); ++jj)
+            {
+                m_buckets[bucket_index(jj, ii)].push_back(idx);
+            }
+        }
+    }
+
+    /// Test if a bounding box collides with any stored bounding box.
+    ///
+    /// \param op Bounding box to test with.
+    /// \return True if collides, false otherwise.
+    bool collides(const BoundingBox& op) const
+    {
+        for(const auto& vv : m_large)
+        {
+            if(m_boxes[vv].collides(op))
+            {
+                return true;
+            }
+        }
+
+        int x1 = cellCoordinate(op.getMin().x());
+        int x2 = cellCoordinate(op.getMax().x());
+        int z1 = cellCoordinate(op.getMin().z());
+        int z2 = cellCoordinate(op.getMax().z());
+
+        // Testing all boxes is cheaper than going through more cells than there are buckets.
+        if((static_cast<unsigned>(x2 - x1 + 1) * static_cast<unsigned>(z2 - z1 + 1)) > BUCKET_COUNT)
+        {
+            for(const auto& vv : m_boxes)
+            {
+                if(vv.collides(op))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        for(int ii = z1; (ii <= z2); ++ii)
+        {
+            for(int jj = x1; (jj <= x2); ++jj)
+            {
+                for(const auto& vv : m_buckets[bucket_index(jj, ii)])
+                {
+                    if(m_boxes[vv].collides(op))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    /// Get cell coordinate.
+    ///
+    /// \param op World coordinate.
+    /// \return Cell coordinate.
+    int cellCoordinate(float op) const
+    {
+        return static_cast<int>(floor(op / m_cell_size));
+    }
+
+private:
+    /// Get bucket index of a cell.
+    ///
+    /// \param cx Cell X coordinate.
+    /// \param cz Cell Z coordinate.
+    /// \return Bucket index.
+    static constexpr unsigned bucket_index(int cx, int cz) noexcept
+    {
+        return ((static_cast<unsigned>(cx) * 73856093u) ^ (static_cast<unsigned>(cz) * 19349663u)) &
+            (BUCKET_COUNT - 1);
+    }
+};
+
+}
+
+#endif
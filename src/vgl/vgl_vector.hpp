@@ -375,6 +375,19 @@ public:
         m_size = cnt;
     }
 
+    /// Ensure capacity.
+    ///
+    /// Will NOT change the size of the array.
+    ///
+    /// \param cnt Minimum capacity.
+    void reserve(unsigned cnt)
+    {
+        if(cnt > m_capacity)
+        {
+            resizeInternal(cnt);
+        }
+    }
+
 #if defined(VGL_USE_LD)
     /// Swap with another object.
     ///
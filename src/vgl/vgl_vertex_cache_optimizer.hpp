@@ -0,0 +1,582 @@
+#ifndef VGL_VERTEX_CACHE_OPTIMIZER_HPP
+#define VGL_VERTEX_CACHE_OPTIMIZER_HPP
+
+#include "vgl_algorithm.hpp"
+#include "vgl_array.hpp"
+#include "vgl_index_type.hpp"
+#include "vgl_math.hpp"
+#include "vgl_vector.hpp"
+
+#if defined(VGL_USE_LD)
+#include "vgl_scoped_acquire.hpp"
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#endif
+
+namespace vgl
+{
+
+namespace detail
+{
+
+/// Post-transform vertex cache statistics of a triangle list.
+///
+/// Simulates a FIFO cache, which approximates the behavior of most hardware and software rasterizers.
+class VertexCacheStatistics
+{
+private:
+    /// Simulated FIFO cache size.
+    static const unsigned CACHE_SIZE = 16;
+
+private:
+    /// Average cache miss ratio, transformed vertices per triangle.
+    float m_acmr = 0.0f;
+
+    /// Average transform to vertex ratio, transformed vertices per vertex.
+    float m_atvr = 0.0f;
+
+    /// Number of transformed vertices.
+    unsigned m_transform_count = 0;
+
+public:
+    /// Constructor.
+    ///
+    /// \param indices Triangle list indices.
+    /// \param vertex_count Number of vertices.
+    explicit VertexCacheStatistics(const vector<index_type>& indices, unsigned vertex_count)
+    {
+        // Vertex is in the cache if it was transformed at most CACHE_SIZE transforms ago.
+        vector<unsigned> timestamps(vertex_count);
+        for(unsigned ii = 0; (ii < vertex_count); ++ii)
+        {
+            timestamps[ii] = 0;
+        }
+        unsigned timestamp = CACHE_SIZE + 1;
+        for(const auto& vv : indices)
+        {
+            if((timestamp - timestamps[vv]) > CACHE_SIZE)
+            {
+                timestamps[vv] = timestamp;
+                ++timestamp;
+            }
+        }
+
+        m_transform_count = timestamp - CACHE_SIZE - 1;
+        float transforms = static_cast<float>(m_transform_count);
+        if(indices.size() >= 3)
+        {
+            m_acmr = transforms / static_cast<float>(indices.size() / 3);
+        }
+        if(vertex_count)
+        {
+            m_atvr = transforms / static_cast<float>(vertex_count);
+        }
+    }
+
+public:
+    /// Accessor.
+    ///
+    /// \return Average cache miss ratio.
+    constexpr float getAcmr() const noexcept
+    {
+        return m_acmr;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Average transform to vertex ratio.
+    constexpr float getAtvr() const noexcept
+    {
+        return m_atvr;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Number of transformed vertices.
+    constexpr unsigned getTransformCount() const noexcept
+    {
+        return m_transform_count;
+    }
+};
+
+#if defined(VGL_USE_LD)
+/// Vertex cache statistics of one optimized mesh.
+class VertexCacheRecord
+{
+private:
+    /// Statistics before optimization.
+    VertexCacheStatistics m_before;
+
+    /// Statistics after optimization.
+    VertexCacheStatistics m_after;
+
+    /// Number of triangles.
+    unsigned m_triangle_count;
+
+    /// Number of vertices.
+    unsigned m_vertex_count;
+
+public:
+    /// Constructor.
+    ///
+    /// \param before Statistics before optimization.
+    /// \param after Statistics after optimization.
+    /// \param triangle_count Number of triangles.
+    /// \param vertex_count Number of vertices.
+    constexpr explicit VertexCacheRecord(const VertexCacheStatistics& before, const VertexCacheStatistics& after,
+            unsigned triangle_count, unsigned vertex_count) noexcept :
+        m_before(before),
+        m_after(after),
+        m_triangle_count(triangle_count),
+        m_vertex_count(vertex_count)
+    {
+    }
+
+public:
+    /// Accessor.
+    ///
+    /// \return Statistics before optimization.
+    constexpr const VertexCacheStatistics& getBefore() const noexcept
+    {
+        return m_before;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Statistics after optimization.
+    constexpr const VertexCacheStatistics& getAfter() const noexcept
+    {
+        return m_after;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Number of triangles.
+    constexpr unsigned getTriangleCount() const noexcept
+    {
+        return m_triangle_count;
+    }
+
+    /// Accessor.
+    ///
+    /// \return Number of vertices.
+    constexpr unsigned getVertexCount() const noexcept
+    {
+        return m_vertex_count;
+    }
+};
+
+/// Vertex cache statistics of all optimized meshes.
+///
+/// Meshes are optimized in compile tasks, so records are added under a mutex. A summary of all meshes is reported on
+/// destruction, preceded by one line per mesh if verbose.
+class VertexCacheReport
+{
+private:
+    /// Guards the records.
+    Mutex m_mutex;
+
+    /// Records of optimized meshes.
+    vector<VertexCacheRecord> m_records;
+
+    /// Report every mesh.
+    bool m_verbose = false;
+
+public:
+    /// Default constructor.
+    explicit VertexCacheReport() = default;
+
+    /// Destructor.
+    ~VertexCacheReport()
+    {
+        if(m_records.empty())
+        {
+            return;
+        }
+
+        // Format into a separate stream so the format of standard output is not changed.
+        std::ostringstream sstr;
+        sstr << std::fixed << std::setprecision(3);
+        unsigned triangle_count = 0;
+        unsigned vertex_count = 0;
+        unsigned transforms_before = 0;
+        unsigned transforms_after = 0;
+        for(const auto& vv : m_records)
+        {
+            if(m_verbose)
+            {
+                sstr << "MeshData: " << vv.getTriangleCount() << " triangles, " << vv.getVertexCount() <<
+                    " vertices, ACMR " << vv.getBefore().getAcmr() << " -> " << vv.getAfter().getAcmr() << ", ATVR " <<
+                    vv.getBefore().getAtvr() << " -> " << vv.getAfter().getAtvr() << "\n";
+            }
+            triangle_count += vv.getTriangleCount();
+            vertex_count += vv.getVertexCount();
+            transforms_before += vv.getBefore().getTransformCount();
+            transforms_after += vv.getAfter().getTransformCount();
+        }
+        if(triangle_count && vertex_count)
+        {
+            float triangles = static_cast<float>(triangle_count);
+            float vertices = static_cast<float>(vertex_count);
+            float before = static_cast<float>(transforms_before);
+            float after = static_cast<float>(transforms_after);
+            sstr << "MeshData: " << m_records.size() << " meshes, " << triangle_count <<
+                " triangles optimized, ACMR " << (before / triangles) << " -> " << (after / triangles) << ", ATVR " <<
+                (before / vertices) << " -> " << (after / vertices) << "\n";
+        }
+        std::cout << sstr.str();
+    }
+
+    /// Deleted copy constructor.
+    VertexCacheReport(const VertexCacheReport&) = delete;
+    /// Deleted assignment.
+    VertexCacheReport& operator=(const VertexCacheReport&) = delete;
+
+public:
+    /// Add statistics of one optimized mesh.
+    ///
+    /// \param before Statistics before optimization.
+    /// \param after Statistics after optimization.
+    /// \param index_count Number of indices.
+    /// \param vertex_count Number of vertices.
+    void add(const VertexCacheStatistics& before, const VertexCacheStatistics& after, unsigned index_count,
+            unsigned vertex_count)
+    {
+        ScopedAcquire sa(m_mutex);
+        m_records.emplace_back(before, after, index_count / 3, vertex_count);
+    }
+
+    /// Setter.
+    ///
+    /// \param op True to report every mesh, false to only report the summary.
+    void setVerbose(bool op)
+    {
+        m_verbose = op;
+    }
+};
+#endif
+
+/// Triangle order optimizer for post-transform vertex cache.
+///
+/// Implements Tom Forsyth's linear-speed vertex cache optimization. Triangles are emitted greedily, always picking
+/// the triangle with highest score. Vertex score is based on the position of the vertex in a simulated LRU cache and
+/// the number of triangles still using the vertex, so the order favors reuse and finishes off lone triangles early.
+class VertexCacheOptimizer
+{
+private:
+    /// Simulated LRU cache size.
+    static const unsigned CACHE_SIZE = 32;
+
+    /// Number of precalculated valence scores.
+    static const unsigned VALENCE_SCORE_COUNT = 32;
+
+    /// Marker for no triangle or no cache position.
+    static const unsigned NONE = ~0u;
+
+private:
+    /// Indices to optimize.
+    vector<index_type>& m_indices;
+
+    /// First index into adjacency for each vertex, and one past the end.
+    vector<unsigned> m_adjacency_offsets;
+
+    /// Triangles using each vertex, triangles not yet emitted are at the beginning of each range.
+    vector<unsigned> m_adjacency;
+
+    /// Number of triangles not yet emitted using each vertex.
+    vector<unsigned> m_valences;
+
+    /// Position of each vertex in the simulated cache or NONE.
+    vector<unsigned> m_cache_positions;
+
+    /// Score of each vertex.
+    vector<float> m_vertex_scores;
+
+    /// Has the triangle been emitted?
+    vector<uint8_t> m_emitted;
+
+    /// Simulated cache, with room for one triangle of overflow.
+    array<unsigned, CACHE_SIZE + 3> m_cache;
+
+    /// Score by cache position.
+    array<float, CACHE_SIZE> m_cache_scores;
+
+    /// Score by valence.
+    array<float, VALENCE_SCORE_COUNT> m_valence_scores;
+
+    /// Number of vertices in the simulated cache.
+    unsigned m_cache_count = 0;
+
+    /// First triangle that might not have been emitted.
+    unsigned m_scan_position = 0;
+
+private:
+    /// Constructor.
+    ///
+    /// \param indices Indices to optimize.
+    /// \param vertex_count Number of vertices.
+    explicit VertexCacheOptimizer(vector<index_type>& indices, unsigned vertex_count) :
+        m_indices(indices),
+        m_adjacency_offsets(vertex_count + 1),
+        m_adjacency(indices.size()),
+        m_valences(vertex_count),
+        m_cache_positions(vertex_count),
+        m_vertex_scores(vertex_count),
+        m_emitted(indices.size() / 3)
+    {
+        // Last triangle vertices get a fixed score so the order does not depend on which corner was added last.
+        for(unsigned ii = 0; (ii < CACHE_SIZE); ++ii)
+        {
+            if(ii < 3)
+            {
+                m_cache_scores[ii] = 0.75f;
+            }
+            else
+            {
+                float score = 1.0f - static_cast<float>(ii - 3) / static_cast<float>(CACHE_SIZE - 3);
+                m_cache_scores[ii] = score * sqrt(score);
+            }
+        }
+        m_valence_scores[0] = 0.0f;
+        for(unsigned ii = 1; (ii < VALENCE_SCORE_COUNT); ++ii)
+        {
+            m_valence_scores[ii] = 2.0f / sqrt(static_cast<float>(ii));
+        }
+
+        for(unsigned ii = 0; (ii < vertex_count); ++ii)
+        {
+            m_valences[ii] = 0;
+            m_cache_positions[ii] = NONE;
+        }
+        for(const auto& vv : m_indices)
+        {
+            ++m_valences[vv];
+        }
+
+        unsigned offset = 0;
+        for(unsigned ii = 0; (ii < vertex_count); ++ii)
+        {
+            m_adjacency_offsets[ii] = offset;
+            offset += m_valences[ii];
+            m_valences[ii] = 0;
+        }
+        m_adjacency_offsets[vertex_count] = offset;
+
+        for(unsigned ii = 0; (ii < m_indices.size()); ++ii)
+        {
+            unsigned vidx = m_indices[ii];
+            m_adjacency[m_adjacency_offsets[vidx] + m_valences[vidx]] = ii / 3;
+            ++m_valences[vidx];
+        }
+
+        for(unsigned ii = 0; (ii < vertex_count); ++ii)
+        {
+            m_vertex_scores[ii] = calculateVertexScore(ii);
+        }
+        for(unsigned ii = 0; (ii < m_emitted.size()); ++ii)
+        {
+            m_emitted[ii] = 0;
+        }
+    }
+
+private:
+    /// Calculate vertex score.
+    ///
+    /// \param op Vertex index.
+    /// \return Score.
+    float calculateVertexScore(unsigned op) const
+    {
+        unsigned valence = m_valences[op];
+        if(!valence)
+        {
+            return -1.0f;
+        }
+
+        float ret = m_valence_scores[min(valence, VALENCE_SCORE_COUNT - 1u)];
+        unsigned position = m_cache_positions[op];
+        if(position < CACHE_SIZE)
+        {
+            ret += m_cache_scores[position];
+        }
+        return ret;
+    }
+
+    /// Calculate triangle score.
+    ///
+    /// \param op Triangle index.
+    /// \return Score.
+    float calculateTriangleScore(unsigned op) const
+    {
+        return m_vertex_scores[m_indices[op * 3 + 0]] +
+            m_vertex_scores[m_indices[op * 3 + 1]] +
+            m_vertex_scores[m_indices[op * 3 + 2]];
+    }
+
+    /// Find the first triangle not yet emitted.
+    ///
+    /// Used when no triangle sharing a vertex in the cache remains.
+    ///
+    /// \return Triangle index or NONE.
+    unsigned findNextTriangle()
+    {
+        for(; (m_scan_position < m_emitted.size()); ++m_scan_position)
+        {
+            if(!m_emitted[m_scan_position])
+            {
+                return m_scan_position;
+            }
+        }
+        return NONE;
+    }
+
+    /// Emit a triangle.
+    ///
+    /// Updates adjacency and the simulated cache.
+    ///
+    /// \param tri Triangle index.
+    /// \param output Output indices.
+    /// \return Best triangle to emit next or NONE.
+    unsigned emit(unsigned tri, vector<index_type>& output)
+    {
+        m_emitted[tri] = 1;
+
+        array<unsigned, CACHE_SIZE + 3> cache;
+        unsigned tri_count = 0;
+        for(unsigned ii = 0; (ii < 3); ++ii)
+        {
+            unsigned vidx = m_indices[tri * 3 + ii];
+            output.push_back(static_cast<index_type>(vidx));
+
+            // Remove the triangle from the range of triangles not yet emitted.
+            unsigned first = m_adjacency_offsets[vidx];
+            unsigned last = first + m_valences[vidx] - 1;
+            for(unsigned jj = first; (jj <= last); ++jj)
+            {
+                if(m_adjacency[jj] == tri)
+                {
+                    m_adjacency[jj] = m_adjacency[last];
+                    m_adjacency[last] = tri;
+                    break;
+                }
+            }
+            --m_valences[vidx];
+
+            // Degenerate triangles may refer to the same vertex multiple times.
+            if(((tri_count < 1) || (cache[0] != vidx)) && ((tri_count < 2) || (cache[1] != vidx)))
+            {
+                cache[tri_count] = vidx;
+                ++tri_count;
+            }
+        }
+
+        // Move triangle vertices to the front of the cache.
+        unsigned cache_count = tri_count;
+        for(unsigned ii = 0; (ii < m_cache_count); ++ii)
+        {
+            unsigned vidx = m_cache[ii];
+            bool found = false;
+            for(unsigned jj = 0; (jj < tri_count); ++jj)
+            {
+                if(cache[jj] == vidx)
+                {
+                    found = true;
+                    break;
+                }
+            }
+            if(!found)
+            {
+                cache[cache_count] = vidx;
+                ++cache_count;
+            }
+        }
+
+        // Update vertices in the cache and vertices that were pushed out of it.
+        for(unsigned ii = 0; (ii < cache_count); ++ii)
+        {
+            unsigned vidx = cache[ii];
+            m_cache_positions[vidx] = ii;
+            if(ii >= CACHE_SIZE)
+            {
+                m_cache_positions[vidx] = NONE;
+            }
+            m_vertex_scores[vidx] = calculateVertexScore(vidx);
+        }
+        m_cache = cache;
+        m_cache_count = min(cache_count, CACHE_SIZE + 0u);
+
+        // Update scores of remaining triangles using updated vertices.
+        unsigned ret = NONE;
+        float best_score = 0.0f;
+        for(unsigned ii = 0; (ii < cache_count); ++ii)
+        {
+            unsigned vidx = cache[ii];
+            unsigned first = m_adjacency_offsets[vidx];
+            unsigned last = first + m_valences[vidx];
+            for(unsigned jj = first; (jj < last); ++jj)
+            {
+                unsigned adjacent = m_adjacency[jj];
+                float score = calculateTriangleScore(adjacent);
+                if(score > best_score)
+                {
+                    best_score = score;
+                    ret = adjacent;
+                }
+            }
+        }
+        return ret;
+    }
+
+    /// Optimize the triangle order.
+    void run()
+    {
+        unsigned tri = NONE;
+        float best_score = 0.0f;
+        for(unsigned ii = 0; (ii < m_emitted.size()); ++ii)
+        {
+            float score = calculateTriangleScore(ii);
+            if(score > best_score)
+            {
+                best_score = score;
+                tri = ii;
+            }
+        }
+
+        vector<index_type> output;
+        for(;;)
+        {
+            if(tri == NONE)
+            {
+                tri = findNextTriangle();
+                if(tri == NONE)
+                {
+                    break;
+                }
+            }
+            tri = emit(tri, output);
+        }
+
+        m_indices = move(output);
+    }
+
+public:
+    /// Optimize triangle order of an indexed triangle list.
+    ///
+    /// \param indices Triangle list indices, reordered in place.
+    /// \param vertex_count Number of vertices.
+    static void optimize(vector<index_type>& indices, unsigned vertex_count)
+    {
+        if(indices.size() < 6)
+        {
+            return;
+        }
+        VertexCacheOptimizer optimizer(indices, vertex_count);
+        optimizer.run();
+    }
+};
+
+}
+
+}
+
+#endif